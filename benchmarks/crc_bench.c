@@ -0,0 +1,73 @@
+/*
+ * CRC-CCITT microbenchmark: checks the table-driven implementation against
+ * a bit-wise reference and reports the throughput for typical frame sizes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ingenialink/crc.h"
+
+/** Benchmark buffer size (bytes). */
+#define BUF_SZ		1024
+
+/** Bytes processed per frame size. */
+#define BYTES_PER_RUN	(64 * 1024 * 1024)
+
+static uint16_t crc_ref(const uint8_t *p, size_t sz)
+{
+	uint16_t crc = 0;
+	size_t i;
+	int j;
+
+	for (i = 0; i < sz; i++) {
+		crc ^= (uint16_t)(p[i] << 8);
+		for (j = 0; j < 8; j++) {
+			if (crc & 0x8000)
+				crc = (uint16_t)((crc << 1) ^ IL_CRC_CCITT_POLY);
+			else
+				crc = (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+int main(void)
+{
+	static const size_t szs[] = { 12, 14, 64, 256, 1024 };
+	uint8_t buf[BUF_SZ];
+	size_t i, sz;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = (uint8_t)rand();
+
+	/* verify */
+	for (sz = 0; sz <= sizeof(buf); sz++) {
+		if (il_crc__ccitt(buf, sz) != crc_ref(buf, sz)) {
+			fprintf(stderr, "CRC mismatch (%zu bytes)\n", sz);
+			return EXIT_FAILURE;
+		}
+	}
+
+	/* measure */
+	for (i = 0; i < sizeof(szs) / sizeof(szs[0]); i++) {
+		volatile uint16_t sink = 0;
+		size_t runs = BYTES_PER_RUN / szs[i];
+		size_t run;
+		clock_t start;
+		double secs;
+
+		start = clock();
+		for (run = 0; run < runs; run++)
+			sink ^= il_crc__ccitt(buf, szs[i]);
+		secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+		printf("%5zu bytes: %8.1f MB/s, %6.1f ns/frame\n", szs[i],
+		       (double)(runs * szs[i]) / secs / 1e6,
+		       secs * 1e9 / (double)runs);
+	}
+
+	return EXIT_SUCCESS;
+}
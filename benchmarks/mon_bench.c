@@ -0,0 +1,168 @@
+/*
+ * Monitoring decoding microbenchmark: de-interleaves 100k-sample captures
+ * for typical channel layouts with a per-sample type switch (the former
+ * decoder), the scalar layout path and the best vector kernel, checking
+ * that all of them agree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ingenialink/mon_decode.h"
+
+/** Samples per capture. */
+#define SAMPLES		100000
+
+/** Maximum channels per layout. */
+#define CH_MAX		4
+
+/** Captures decoded per measurement. */
+#define RUNS		50
+
+/** Benchmarked layout. */
+typedef struct {
+	const char *name;
+	size_t n_ch;
+	il_reg_dtype_t types[CH_MAX];
+} layout_t;
+
+static const layout_t layouts[] = {
+	{ "2 x float", 2, { IL_REG_DTYPE_FLOAT, IL_REG_DTYPE_FLOAT } },
+	{ "4 x s32", 4, { IL_REG_DTYPE_S32, IL_REG_DTYPE_S32,
+			  IL_REG_DTYPE_S32, IL_REG_DTYPE_S32 } },
+	{ "2 x u16", 2, { IL_REG_DTYPE_U16, IL_REG_DTYPE_U16 } },
+	{ "4 x s16", 4, { IL_REG_DTYPE_S16, IL_REG_DTYPE_S16,
+			  IL_REG_DTYPE_S16, IL_REG_DTYPE_S16 } },
+	{ "4 x u8", 4, { IL_REG_DTYPE_U8, IL_REG_DTYPE_U8,
+			 IL_REG_DTYPE_U8, IL_REG_DTYPE_U8 } },
+	{ "2 x double", 2, { IL_REG_DTYPE_FLOAT64, IL_REG_DTYPE_FLOAT64 } },
+	{ "4 x s64", 4, { IL_REG_DTYPE_S64, IL_REG_DTYPE_S64,
+			  IL_REG_DTYPE_S64, IL_REG_DTYPE_S64 } },
+	{ "float+s16+u32", 3, { IL_REG_DTYPE_FLOAT, IL_REG_DTYPE_S16,
+				IL_REG_DTYPE_U32 } },
+};
+
+/**
+ * Decode with a type switch per sample and channel.
+ */
+static void switch_decode(const layout_t *l, const uint8_t *src, size_t n,
+			  void *const *dst)
+{
+	size_t i, ch;
+
+	for (i = 0; i < n; i++) {
+		size_t off = 0;
+
+		for (ch = 0; ch < l->n_ch; ch++) {
+			switch (l->types[ch]) {
+			case IL_REG_DTYPE_U8:
+			case IL_REG_DTYPE_S8:
+				((uint8_t *)dst[ch])[i] = src[off];
+				off += 1;
+				break;
+			case IL_REG_DTYPE_U16:
+			case IL_REG_DTYPE_S16:
+				memcpy(&((uint16_t *)dst[ch])[i], &src[off], 2);
+				off += 2;
+				break;
+			case IL_REG_DTYPE_U32:
+			case IL_REG_DTYPE_S32:
+			case IL_REG_DTYPE_FLOAT:
+				memcpy(&((uint32_t *)dst[ch])[i], &src[off], 4);
+				off += 4;
+				break;
+			default:
+				memcpy(&((uint64_t *)dst[ch])[i], &src[off], 8);
+				off += 8;
+				break;
+			}
+		}
+
+		src += off;
+	}
+}
+
+static double elapsed(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+	static uint8_t src[SAMPLES * CH_MAX * 8];
+	static uint8_t ref[CH_MAX][SAMPLES * 8], out[CH_MAX][SAMPLES * 8];
+	void *ref_p[CH_MAX], *out_p[CH_MAX];
+	size_t i, ch;
+
+	for (i = 0; i < sizeof(src); i++)
+		src[i] = (uint8_t)rand();
+
+	for (ch = 0; ch < CH_MAX; ch++) {
+		ref_p[ch] = ref[ch];
+		out_p[ch] = out[ch];
+	}
+
+	printf("%-14s %10s %10s %10s  %s\n", "layout", "switch", "scalar",
+	       "vector", "kernel");
+
+	for (i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++) {
+		const layout_t *l = &layouts[i];
+		il_mon_layout_t scalar, best;
+		double t_sw, t_sc, t_v;
+		size_t sample_sz;
+		clock_t start;
+		int run;
+
+		if (il_mon_decode__compile(&scalar, l->types, l->n_ch, 0,
+					   IL_MON_DECODE_ISA_SCALAR) < 0 ||
+		    il_mon_decode__compile(&best, l->types, l->n_ch, 0,
+					   IL_MON_DECODE_ISA_AUTO) < 0) {
+			fprintf(stderr, "%s: layout compilation failed\n",
+				l->name);
+			return EXIT_FAILURE;
+		}
+
+		/* verify */
+		switch_decode(l, src, SAMPLES, ref_p);
+		il_mon_decode__run(&best, src, SAMPLES, out_p);
+		for (ch = 0; ch < l->n_ch; ch++) {
+			if (memcmp(ref[ch], out[ch],
+				   SAMPLES * best.ch[ch].sz) != 0) {
+				fprintf(stderr, "%s: mismatch on channel %zu\n",
+					l->name, ch);
+				return EXIT_FAILURE;
+			}
+		}
+
+		/* measure */
+		start = clock();
+		for (run = 0; run < RUNS; run++)
+			switch_decode(l, src, SAMPLES, ref_p);
+		t_sw = elapsed(start);
+
+		start = clock();
+		for (run = 0; run < RUNS; run++)
+			il_mon_decode__run(&scalar, src, SAMPLES, out_p);
+		t_sc = elapsed(start);
+
+		start = clock();
+		for (run = 0; run < RUNS; run++)
+			il_mon_decode__run(&best, src, SAMPLES, out_p);
+		t_v = elapsed(start);
+
+		sample_sz = best.block_sz;
+		printf("%-14s %7.0f MB/s %7.0f MB/s %7.0f MB/s  %s (x%.1f)\n",
+		       l->name,
+		       (double)(RUNS * SAMPLES * sample_sz) / t_sw / 1e6,
+		       (double)(RUNS * SAMPLES * sample_sz) / t_sc / 1e6,
+		       (double)(RUNS * SAMPLES * sample_sz) / t_v / 1e6,
+		       il_mon_decode__isa_name(best.isa), t_sw / t_v);
+
+		il_mon_decode__release(&best);
+		il_mon_decode__release(&scalar);
+	}
+
+	return EXIT_SUCCESS;
+}
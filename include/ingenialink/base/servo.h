@@ -7,6 +7,23 @@ int il_servo_base__init(il_servo_t *servo, il_net_t *net, uint16_t id,
 			const char *dict);
 void il_servo_base__deinit(il_servo_t *servo);
 
+void il_servo_base__sw_process(il_servo_t *servo, uint8_t subnode,
+			       uint16_t sw);
+
+int il_servo_base__sw_read(il_servo_t *servo, uint8_t subnode, uint16_t *sw);
+
+int il_servo_base__sw_wait_change(il_servo_t *servo, uint8_t subnode,
+				  uint16_t *sw, int *timeout);
+
+int il_servo_base__sw_wait_value(il_servo_t *servo, uint8_t subnode,
+				 uint16_t msk, uint16_t val, int timeout);
+
+void il_servo_base__emcy_dispatch(il_servo_t *servo);
+
+void il_servo_base__monitors_stop(il_servo_t *servo);
+
+int il_servo_base__monitors_start(il_servo_t *servo);
+
 void il_servo_base__state_get(il_servo_t *servo, il_servo_state_t *state,
 			      int *flags);
 
@@ -108,5 +125,11 @@ int il_servo_base__raw_write_float(il_servo_t *servo, const il_reg_t *reg,
 int il_servo_base__write(il_servo_t *servo, const il_reg_t *reg, const char *id,
 			 double val, int confirm);
 
+int il_servo_base__read_many(il_servo_t *servo, il_servo_access_t *accs,
+			     size_t n);
+
+int il_servo_base__write_many(il_servo_t *servo, il_servo_access_t *accs,
+			      size_t n);
+
 #endif
 
@@ -0,0 +1,42 @@
+#ifndef INGENIALINK_CRC_H_
+#define INGENIALINK_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** CRC-CCITT polynomial (x^16 + x^12 + x^5 + 1). */
+#define IL_CRC_CCITT_POLY	0x1021
+
+/**
+ * Update a CRC-CCITT (XMODEM variant, non-reflected) with the given data.
+ *
+ * @note
+ *	Short buffers are processed byte-wise; longer ones use a slicing-by-8
+ *	table lookup (8 bytes per iteration).
+ *
+ * @param [in] crc
+ *	Current CRC (0 to start a new computation).
+ * @param [in] buf
+ *	Data buffer.
+ * @param [in] sz
+ *	Data buffer size (bytes).
+ *
+ * @return
+ *	Updated CRC.
+ */
+uint16_t il_crc__ccitt_update(uint16_t crc, const void *buf, size_t sz);
+
+/**
+ * Compute the CRC-CCITT of the given buffer.
+ *
+ * @param [in] buf
+ *	Data buffer.
+ * @param [in] sz
+ *	Data buffer size (bytes).
+ *
+ * @return
+ *	CRC.
+ */
+uint16_t il_crc__ccitt(const void *buf, size_t sz);
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef INGENIALINK_MON_DECODE_H_
+#define INGENIALINK_MON_DECODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "public/ingenialink/registers.h"
+
+/** Monitoring decoding instruction sets. */
+typedef enum {
+	/** Best available on the running CPU. */
+	IL_MON_DECODE_ISA_AUTO,
+	/** Portable C. */
+	IL_MON_DECODE_ISA_SCALAR,
+	/** x86 SSE2. */
+	IL_MON_DECODE_ISA_SSE2,
+	/** x86 AVX2. */
+	IL_MON_DECODE_ISA_AVX2,
+	/** ARM NEON. */
+	IL_MON_DECODE_ISA_NEON,
+} il_mon_decode_isa_t;
+
+/**
+ * Monitoring decoding kernel.
+ *
+ * @param [in] src
+ *	Interleaved blocks.
+ * @param [in] n
+ *	Number of blocks.
+ * @param [in] dst
+ *	Channel destination arrays.
+ *
+ * @return
+ *	Number of blocks decoded (the remaining ones are left to the scalar
+ *	path).
+ */
+typedef size_t (*il_mon_decode_kernel_t)(const uint8_t *src, size_t n,
+					 void *const *dst);
+
+/** Monitoring channel placement. */
+typedef struct {
+	/** Offset within a block (bytes). */
+	uint32_t off;
+	/** Size (bytes). */
+	uint8_t sz;
+} il_mon_layout_ch_t;
+
+/** Monitoring channel layout. */
+typedef struct {
+	/** Number of channels. */
+	size_t n_ch;
+	/** Block size (bytes). */
+	size_t block_sz;
+	/** Channels. */
+	il_mon_layout_ch_t *ch;
+	/** Vector kernel (NULL if only the scalar path applies). */
+	il_mon_decode_kernel_t kernel;
+	/** Instruction set of the selected kernel. */
+	il_mon_decode_isa_t isa;
+} il_mon_layout_t;
+
+/**
+ * Obtain the size of a monitoring channel type.
+ *
+ * @param [in] type
+ *	Channel type.
+ *
+ * @return
+ *	Size (bytes), 0 if the type can not be monitored.
+ */
+size_t il_mon_decode__dtype_sz(il_reg_dtype_t type);
+
+/**
+ * Compile a monitoring channel layout.
+ *
+ * @note
+ *	A vector kernel is selected when all channels share the same size and
+ *	blocks are tightly packed, which is the usual mapping (e.g. a set of
+ *	float or 32-bit channels). Any other layout is decoded with a scalar
+ *	strided copy per channel.
+ *
+ * @param [out] layout
+ *	Layout (must be released with il_mon_decode__release).
+ * @param [in] types
+ *	Channel types.
+ * @param [in] n_ch
+ *	Number of channels.
+ * @param [in] block_sz
+ *	Block size reported by the drive (bytes, 0 to use the packed size).
+ * @param [in] isa
+ *	Highest instruction set allowed.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_mon_decode__compile(il_mon_layout_t *layout,
+			   const il_reg_dtype_t *types, size_t n_ch,
+			   size_t block_sz, il_mon_decode_isa_t isa);
+
+/**
+ * Release a monitoring channel layout.
+ *
+ * @param [in] layout
+ *	Layout (it is left empty, so it can be released again).
+ */
+void il_mon_decode__release(il_mon_layout_t *layout);
+
+/**
+ * Decode interleaved monitoring blocks into per-channel arrays.
+ *
+ * @param [in] layout
+ *	Layout.
+ * @param [in] src
+ *	Interleaved blocks.
+ * @param [in] n
+ *	Number of blocks.
+ * @param [in] dst
+ *	Channel destination arrays (native channel type, n elements each).
+ */
+void il_mon_decode__run(const il_mon_layout_t *layout, const uint8_t *src,
+			size_t n, void *const *dst);
+
+/**
+ * Obtain the name of an instruction set.
+ *
+ * @param [in] isa
+ *	Instruction set.
+ *
+ * @return
+ *	Name.
+ */
+const char *il_mon_decode__isa_name(il_mon_decode_isa_t isa);
+
+#endif
@@ -4,6 +4,8 @@
 #include "public/ingenialink/net.h"
 #include "public/ingenialink/servo.h"
 
+#include "osal/osal.h"
+
 /** Virtual network port. */
 #define EUSB_VIRTUAL_PORT "virtual"
 
@@ -22,8 +24,26 @@ typedef struct il_net_emcy_subscriber il_net_emcy_subscriber_t;
 /** Emergency subcriber callback. */
 typedef void (*il_net_emcy_subscriber_cb_t)(void *ctx, uint32_t code);
 
-int il_net_monitoring_mapping_register[16];
-int il_net_disturbance_mapping_register[16];
+/** Network transfer request (see il_net__transfer). */
+typedef struct {
+	/** Node id (e.g. EtherCAT slave number). */
+	uint16_t id;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Address. */
+	uint16_t address;
+	/** Data buffer (read destination or write source). */
+	void *buf;
+	/** Data buffer size. */
+	size_t sz;
+	/** Write request flag (read request otherwise). */
+	int write;
+	/** Result (0 on success, error code otherwise). */
+	int r;
+} il_net_req_t;
+
+extern int il_net_monitoring_mapping_register[16];
+extern int il_net_disturbance_mapping_register[16];
 
 /**
  * Retain a reference of the network.
@@ -51,6 +71,142 @@ void il_net__release(il_net_t *net);
  */
 void il_net__state_set(il_net_t *net, il_net_state_t state);
 
+/**
+ * Obtain the monitoring/disturbance version.
+ *
+ * @note
+ *	The version register is only read once per connection.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [out] version
+ *	Version.
+ *
+ * @return
+ *	0 if the versioned interface is available, error code otherwise (the
+ *	original interface has to be used).
+ */
+int il_net__mon_dist_version_get(il_net_t *net, uint32_t *version);
+
+/**
+ * Report monitoring download progress.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] done
+ *	Bytes downloaded.
+ * @param [in] total
+ *	Bytes expected.
+ */
+void il_net__monitoring_progress(il_net_t *net, size_t done, size_t total);
+
+/**
+ * Record the statistics of a completed monitoring download.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] start
+ *	Download start time (see osal_clock_gettime).
+ * @param [in] blocks
+ *	Blocks downloaded.
+ */
+void il_net__monitoring_download_done(il_net_t *net,
+				      const osal_timespec_t *start,
+				      size_t blocks);
+
+/**
+ * Set the type of a monitoring channel.
+ *
+ * @note
+ *	The channel table grows as needed, there is no fixed channel limit.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] channel
+ *	Channel.
+ * @param [in] dtype
+ *	Channel type.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_net__monitoring_channel_set(il_net_t *net, int channel,
+				   il_reg_dtype_t dtype);
+
+/**
+ * Make room for raw monitoring data.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] sz
+ *	Total raw data size required (bytes).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_net__monitoring_raw_reserve(il_net_t *net, size_t sz);
+
+/**
+ * Release all monitoring storage (mapping, raw and decoded data).
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ */
+void il_net__monitoring_release(il_net_t *net);
+
+/**
+ * Set the type of a disturbance channel.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] channel
+ *	Channel.
+ * @param [in] dtype
+ *	Channel type.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_net__disturbance_channel_set(il_net_t *net, int channel,
+				    il_reg_dtype_t dtype);
+
+/**
+ * Release all disturbance storage.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ */
+void il_net__disturbance_release(il_net_t *net);
+
+/**
+ * Compile the monitoring channel layout from the current mapping.
+ *
+ * @note
+ *	It must be called every time the monitoring mapping changes, so that
+ *	decoding does not need to inspect channel types anymore.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_net__monitoring_layout_update(il_net_t *net);
+
+/**
+ * Decode the raw monitoring data into the monitoring channels.
+ *
+ * @note
+ *	Channel storage is (re)sized to the number of samples received.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_net__monitoring_decode(il_net_t *net);
+
 /**
  * Write.
  *
@@ -97,6 +253,171 @@ int il_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
 int il_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, void *buf,
 		 size_t sz);
 
+/**
+ * Transfer a set of requests.
+ *
+ * @note
+ *	Networks supporting it keep several requests outstanding at the same
+ *	time (pipelined), replies being matched back by subnode and address.
+ *	Otherwise requests are issued one after the other.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in, out] reqs
+ *	Requests (individual results are stored in each request).
+ * @param [in] n
+ *	Number of requests.
+ *
+ * @returns
+ *	0 if all requests succeeded, first error code found otherwise.
+ */
+int il_net__transfer(il_net_t *net, il_net_req_t *reqs, size_t n);
+
+/**
+ * Hand a network over to (or take it back from) a connection manager.
+ *
+ * @note
+ *	While attached, the network does not run its own liveness checks nor
+ *	reconnection, the manager does.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] attach
+ *	Attach (1) or detach (0).
+ *
+ * @returns
+ *	0 on success, error code otherwise (IL_ENOTSUP if the network can not
+ *	be managed).
+ */
+int il_net__mgr_attach(il_net_t *net, int attach);
+
+/**
+ * Obtain the socket a connection manager has to poll.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @returns
+ *	Socket descriptor, error code otherwise.
+ */
+int il_net__mgr_fd(il_net_t *net);
+
+/**
+ * Send a statusword read without waiting for the reply.
+ *
+ * @note
+ *	The caller must hold net.lock until the reply has been received with
+ *	il_net__probe_recv or given up.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] subnode
+ *	Subnode.
+ *
+ * @returns
+ *	0 on success, error code otherwise.
+ */
+int il_net__probe_send(il_net_t *net, uint8_t subnode);
+
+/**
+ * Receive the reply to a statusword probe, without blocking.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [out] sw
+ *	Statusword.
+ *
+ * @returns
+ *	0 on success, IL_ETIMEDOUT if no reply is available yet, error code
+ *	otherwise.
+ */
+int il_net__probe_recv(il_net_t *net, uint8_t subnode, uint16_t *sw);
+
+/**
+ * Reopen the network connection (net.lock must be held).
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @returns
+ *	New socket descriptor, error code otherwise.
+ */
+int il_net__reopen(il_net_t *net);
+
+/**
+ * Restore the session state after a reconnection.
+ *
+ * @note
+ *	Monitoring/disturbance mappings, disturbance data and the monitoring
+ *	and disturbance enabled states are written again, as the drive may
+ *	have been power cycled. Subscriptions are kept by the library and do
+ *	not need to be restored. The servo power stage is never re-enabled.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @returns
+ *	0 on success, first error code found otherwise.
+ */
+int il_net__session_restore(il_net_t *net);
+
+/**
+ * Notify statusword subscribers.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] id
+ *	Node ID.
+ * @param [in] sw
+ *	Statusword.
+ */
+void il_net__sw_notify(il_net_t *net, uint16_t id, uint16_t sw);
+
+/**
+ * Account a statusword seen on the network.
+ *
+ * @note
+ *	Counts as a successful transaction. Subnode 1 values are recorded and
+ *	delivered to the statusword subscribers.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] sw
+ *	Statusword.
+ */
+void il_net__sw_seen(il_net_t *net, uint8_t subnode, uint16_t sw);
+
+/**
+ * Check if a liveness probe is due.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @returns
+ *	1 if no transaction succeeded within the heartbeat idle interval, 0
+ *	otherwise.
+ */
+int il_net__heartbeat_due(il_net_t *net);
+
+/**
+ * Obtain the last subnode 1 statusword seen, if recent enough.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] age
+ *	Maximum age (ms).
+ * @param [out] sw
+ *	Statusword.
+ *
+ * @returns
+ *	1 if a statusword was seen within the given age, 0 otherwise.
+ */
+int il_net__sw_fresh(il_net_t *net, int age, uint16_t *sw);
+
 /**
  * Subscribe to statusword updates.
  *
@@ -177,6 +498,9 @@ typedef struct {
 	int (*_wait_write)(
 		il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, const void *buf,
 		size_t sz, int confirmed, uint16_t extended);
+	/** Transfer (pipelined). */
+	int (*_transfer)(
+		il_net_t *net, il_net_req_t *reqs, size_t n);
 	/** Subscribe to state updates. */
 	int (*_sw_subscribe)(
 		il_net_t *net, uint16_t id, il_net_sw_subscriber_cb_t cb,
@@ -191,6 +515,21 @@ typedef struct {
 	/** Unsubscribe to emergencies. */
 	void (*_emcy_unsubscribe)(
 		il_net_t *net, int slot);
+	/** Hand over to (or take back from) a connection manager. */
+	int (*_mgr_attach)(
+		il_net_t *net, int attach);
+	/** Obtain the socket polled by a connection manager. */
+	int (*_mgr_fd)(
+		il_net_t *net);
+	/** Send a statusword probe (net.lock held). */
+	int (*_probe_send)(
+		il_net_t *net, uint8_t subnode);
+	/** Receive a statusword probe reply (net.lock held). */
+	int (*_probe_recv)(
+		il_net_t *net, uint8_t subnode, uint16_t *sw);
+	/** Reopen the connection (net.lock held). */
+	int (*_reopen)(
+		il_net_t *net);
 	/** Create network. */
 	il_net_t *(*create)(
 		const il_net_opts_t *opts);
@@ -258,6 +597,9 @@ typedef struct {
 	int (*_wait_write)(
 		il_net_t *net, uint16_t id, uint32_t address, const void *buf,
 		size_t sz, int confirmed);
+	/** Transfer (pipelined). */
+	int (*_transfer)(
+		il_net_t *net, il_net_req_t *reqs, size_t n);
 	/** Subscribe to state updates. */
 	int (*_sw_subscribe)(
 		il_net_t *net, uint16_t id, il_net_sw_subscriber_cb_t cb,
@@ -272,6 +614,21 @@ typedef struct {
 	/** Unsubscribe to emergencies. */
 	void (*_emcy_unsubscribe)(
 		il_net_t *net, int slot);
+	/** Hand over to (or take back from) a connection manager. */
+	int (*_mgr_attach)(
+		il_net_t *net, int attach);
+	/** Obtain the socket polled by a connection manager. */
+	int (*_mgr_fd)(
+		il_net_t *net);
+	/** Send a statusword probe (net.lock held). */
+	int (*_probe_send)(
+		il_net_t *net, uint8_t subnode);
+	/** Receive a statusword probe reply (net.lock held). */
+	int (*_probe_recv)(
+		il_net_t *net, uint8_t subnode, uint16_t *sw);
+	/** Reopen the connection (net.lock held). */
+	int (*_reopen)(
+		il_net_t *net);
 	/** Create network. */
 	il_net_t *(*create)(
 		const il_net_opts_t *opts);
@@ -321,6 +678,10 @@ typedef struct {
 	int (*SDO_read)();
 	int (*SDO_read_complete_access)();
 	int (*SDO_write)();
+	int (*set_pipeline_depth)();
+	int (*set_wait_write_timeout)();
+	int (*set_reactor)();
+	int (*set_reconnection_backoff)();
 
 } il_eth_net_ops_t;
 
@@ -364,6 +725,9 @@ typedef struct {
 	int (*_wait_write)(
 		il_net_t *net, uint16_t id, uint32_t address, const void *buf,
 		size_t sz, int confirmed);
+	/** Transfer (pipelined). */
+	int (*_transfer)(
+		il_net_t *net, il_net_req_t *reqs, size_t n);
 	/** Subscribe to state updates. */
 	int (*_sw_subscribe)(
 		il_net_t *net, uint16_t id, il_net_sw_subscriber_cb_t cb,
@@ -378,6 +742,21 @@ typedef struct {
 	/** Unsubscribe to emergencies. */
 	void (*_emcy_unsubscribe)(
 		il_net_t *net, int slot);
+	/** Hand over to (or take back from) a connection manager. */
+	int (*_mgr_attach)(
+		il_net_t *net, int attach);
+	/** Obtain the socket polled by a connection manager. */
+	int (*_mgr_fd)(
+		il_net_t *net);
+	/** Send a statusword probe (net.lock held). */
+	int (*_probe_send)(
+		il_net_t *net, uint8_t subnode);
+	/** Receive a statusword probe reply (net.lock held). */
+	int (*_probe_recv)(
+		il_net_t *net, uint8_t subnode, uint16_t *sw);
+	/** Reopen the connection (net.lock held). */
+	int (*_reopen)(
+		il_net_t *net);
 	/** Create network. */
 	il_net_t *(*create)(
 		const il_net_opts_t *opts);
@@ -435,6 +814,7 @@ typedef struct {
 	int (*SDO_read)();
 	int (*SDO_read_complete_access)();
 	int (*SDO_write)();
+	int (*set_wait_write_timeout)();
 } il_ecat_net_ops_t;
 
 #endif
@@ -3,6 +3,19 @@
 
 #include "public/ingenialink/registers.h"
 
+#include <stddef.h>
+
+/**
+ * Obtain the transfer size of a register data type.
+ *
+ * @param [in] dtype
+ *	Data type.
+ *
+ * @return
+ *	Size in bytes (0 if the type has no fixed size).
+ */
+size_t il_reg__dtype_sz(il_reg_dtype_t dtype);
+
 /*
  * CiA 301
  */
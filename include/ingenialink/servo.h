@@ -101,6 +101,8 @@ typedef struct {
 	int (*read)(
 		il_servo_t *servo, const il_reg_t *reg, const char *id,
 		double *buf);
+	int (*read_many)(
+		il_servo_t *servo, il_servo_access_t *accs, size_t n);
 	int (*raw_write_u8)(
 		il_servo_t *servo, const il_reg_t *reg, const char *id,
 		uint8_t val, int confirm, uint16_t extended);
@@ -134,6 +136,8 @@ typedef struct {
 	int (*write)(
 		il_servo_t *servo, const il_reg_t *reg, const char *id,
 		double val, int confirm, uint16_t extended);
+	int (*write_many)(
+		il_servo_t *servo, il_servo_access_t *accs, size_t n);
 	int (*disable)(il_servo_t *servo, uint8_t subnode, int timeout);
 	int (*switch_on)(il_servo_t *servo, int timeout, uint8_t subnode);
 	int (*enable)(il_servo_t *servo, uint8_t subnode, int timeout);
@@ -8,6 +8,9 @@
 /** Obtain the minimum of a, b. */
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
+/** Obtain the maximum of a, b. */
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
 /** Obtain the size of an array. */
 #define ARRAY_SIZE(arr) (sizeof((arr)) / sizeof((arr)[0]))
 
@@ -127,4 +130,115 @@ void il_utils__refcnt_retain(il_utils_refcnt_t *refcnt);
  */
 void il_utils__refcnt_release(il_utils_refcnt_t *refcnt);
 
+
+/*
+ * Single-producer/single-consumer ring
+ */
+
+/** Ring. */
+typedef struct il_utils_ring il_utils_ring_t;
+
+/**
+ * Create a ring.
+ *
+ * @note
+ *	One thread may push while another pops without any lock. Elements that
+ *	do not fit are dropped and accounted.
+ *
+ * @param [in] elem_sz
+ *	Element size (bytes).
+ * @param [in] cap
+ *	Capacity (elements, rounded up to a power of two).
+ *
+ * @return
+ *	Ring (NULL if it could not be created).
+ */
+il_utils_ring_t *il_utils__ring_create(size_t elem_sz, size_t cap);
+
+/**
+ * Destroy a ring.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ */
+void il_utils__ring_destroy(il_utils_ring_t *ring);
+
+/**
+ * Push elements (producer).
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [in] elems
+ *	Elements.
+ * @param [in] n
+ *	Number of elements.
+ *
+ * @return
+ *	Number of elements pushed (the rest are dropped).
+ */
+size_t il_utils__ring_push(il_utils_ring_t *ring, const void *elems, size_t n);
+
+/**
+ * Pop elements (consumer).
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [out] elems
+ *	Buffer where elements will be copied.
+ * @param [in] n
+ *	Maximum number of elements.
+ *
+ * @return
+ *	Number of elements popped.
+ */
+size_t il_utils__ring_pop(il_utils_ring_t *ring, void *elems, size_t n);
+
+/**
+ * Obtain a view of the contiguous readable elements (consumer).
+ *
+ * @note
+ *	The view stays valid until il_utils__ring_consume is called.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [out] elems
+ *	Where the first readable element will be pointed.
+ *
+ * @return
+ *	Number of contiguous readable elements.
+ */
+size_t il_utils__ring_peek(il_utils_ring_t *ring, void **elems);
+
+/**
+ * Release elements obtained with il_utils__ring_peek (consumer).
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [in] n
+ *	Number of elements.
+ */
+void il_utils__ring_consume(il_utils_ring_t *ring, size_t n);
+
+/**
+ * Obtain the number of readable elements.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ *
+ * @return
+ *	Number of elements.
+ */
+size_t il_utils__ring_cnt(il_utils_ring_t *ring);
+
+/**
+ * Obtain the number of elements dropped because the ring was full.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ *
+ * @return
+ *	Number of dropped elements.
+ */
+uint64_t il_utils__ring_dropped(il_utils_ring_t *ring);
+
 #endif
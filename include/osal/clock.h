@@ -77,6 +77,40 @@ int osal_clock_perf_get(osal_clock_perf_t *perf, osal_timespec_t *ts);
  */
 int osal_clock_gettime(osal_timespec_t *ts);
 
+/**
+ * Set a deadline relative to the current (monotonic) time.
+ *
+ * @param [out] deadline
+ *	Where the deadline will be stored.
+ * @param [in] ns
+ *	Nanoseconds from now.
+ */
+void osal_clock_deadline_set(osal_timespec_t *deadline, long long ns);
+
+/**
+ * Obtain the time left until a deadline.
+ *
+ * @param [in] deadline
+ *	Deadline (see osal_clock_deadline_set).
+ *
+ * @return
+ *	Nanoseconds left (<= 0 if the deadline has expired).
+ */
+long long osal_clock_deadline_left(const osal_timespec_t *deadline);
+
+/**
+ * Sleep until a deadline.
+ *
+ * @note
+ *	Returns immediately if the deadline has already expired. The wake-up
+ *	may be delayed by the platform sleep granularity (e.g. the scheduler
+ *	tick on Windows).
+ *
+ * @param [in] deadline
+ *	Deadline (monotonic, see osal_clock_gettime).
+ */
+void osal_clock_sleep_until(const osal_timespec_t *deadline);
+
 /**
  * Sleep (ms).
  *
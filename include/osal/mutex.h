@@ -37,6 +37,20 @@ void osal_mutex_destroy(osal_mutex_t *mutex);
  */
 void osal_mutex_lock(osal_mutex_t *mutex);
 
+/**
+ * Try to acquire a mutex without blocking.
+ *
+ * @param [in] mutex
+ *     Valid mutex.
+ *
+ * @return
+ *      0 if acquired, OSAL_EFAIL if it is held elsewhere.
+ *
+ * @see
+ *      osal_mutex_unlock
+ */
+int osal_mutex_trylock(osal_mutex_t *mutex);
+
 /**
  * Release a mutex.
  *
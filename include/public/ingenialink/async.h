@@ -0,0 +1,194 @@
+#ifndef PUBLIC_INGENIALINK_ASYNC_H_
+#define PUBLIC_INGENIALINK_ASYNC_H_
+
+#include "servo.h"
+
+IL_BEGIN_DECL
+
+/**
+ * @file ingenialink/async.h
+ * @brief Asynchronous register access.
+ * @defgroup IL_ASYNC Asynchronous register access
+ * @ingroup IL
+ * @{
+ */
+
+/** IngeniaLink asynchronous context. */
+typedef struct il_async il_async_t;
+
+/** IngeniaLink asynchronous request. */
+typedef struct il_async_req il_async_req_t;
+
+/**
+ * Asynchronous request completion callback.
+ *
+ * @note
+ *	It is called from a library thread. The request can be released from
+ *	within the callback.
+ *
+ * @param [in] ctx
+ *	Context.
+ * @param [in] req
+ *	Completed request.
+ */
+typedef void (*il_async_cb_t)(void *ctx, il_async_req_t *req);
+
+/**
+ * Create an asynchronous context.
+ *
+ * @note
+ *	Requests are served by one thread per network, so that requests to
+ *	drives on different networks progress in parallel, while requests on
+ *	the same network are served in submission order.
+ *
+ * @return
+ *	Asynchronous context instance (NULL if it could not be created).
+ */
+IL_EXPORT il_async_t *il_async_create(void);
+
+/**
+ * Destroy an asynchronous context.
+ *
+ * @note
+ *	Requests not yet started are completed with an error. All request
+ *	handles must have been released before calling this function.
+ *
+ * @param [in] async
+ *	Asynchronous context instance.
+ */
+IL_EXPORT void il_async_destroy(il_async_t *async);
+
+/**
+ * Submit an asynchronous register read.
+ *
+ * @param [in] async
+ *	Asynchronous context instance.
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] reg
+ *	Pre-defined register.
+ * @param [in] id
+ *	Register ID.
+ * @param [in] cb
+ *	Completion callback (NULL to use the completion queue).
+ * @param [in] ctx
+ *	Callback context.
+ *
+ * @return
+ *	Request handle (NULL if it could not be submitted).
+ *
+ * @see
+ *	il_servo_read
+ */
+IL_EXPORT il_async_req_t *il_async_read(il_async_t *async, il_servo_t *servo,
+					const il_reg_t *reg, const char *id,
+					il_async_cb_t cb, void *ctx);
+
+/**
+ * Submit an asynchronous register write.
+ *
+ * @param [in] async
+ *	Asynchronous context instance.
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] reg
+ *	Pre-defined register.
+ * @param [in] id
+ *	Register ID.
+ * @param [in] val
+ *	Value.
+ * @param [in] confirm
+ *	Confirm the write.
+ * @param [in] cb
+ *	Completion callback (NULL to use the completion queue).
+ * @param [in] ctx
+ *	Callback context.
+ *
+ * @return
+ *	Request handle (NULL if it could not be submitted).
+ *
+ * @see
+ *	il_servo_write
+ */
+IL_EXPORT il_async_req_t *il_async_write(il_async_t *async, il_servo_t *servo,
+					 const il_reg_t *reg, const char *id,
+					 double val, int confirm,
+					 il_async_cb_t cb, void *ctx);
+
+/**
+ * Obtain the result of a request.
+ *
+ * @param [in] req
+ *	Request handle.
+ * @param [out] val
+ *	Value read (optional, only set for completed reads).
+ *
+ * @return
+ *	0 on success, IL_ESTATE if the request has not completed yet, request
+ *	error code otherwise.
+ */
+IL_EXPORT int il_async_req_result(il_async_req_t *req, double *val);
+
+/**
+ * Obtain the user context of a request.
+ *
+ * @param [in] req
+ *	Request handle.
+ *
+ * @return
+ *	Context given on submission.
+ */
+IL_EXPORT void *il_async_req_ctx_get(il_async_req_t *req);
+
+/**
+ * Release a request handle.
+ *
+ * @note
+ *	A request can be released before it completes, in which case its result
+ *	is discarded.
+ *
+ * @param [in] req
+ *	Request handle.
+ */
+IL_EXPORT void il_async_req_release(il_async_req_t *req);
+
+/**
+ * Obtain the next completed request from the completion queue.
+ *
+ * @note
+ *	Only requests submitted without callback are queued.
+ *
+ * @param [in] async
+ *	Asynchronous context instance.
+ * @param [out] req
+ *	Completed request handle.
+ * @param [in] timeout
+ *	Timeout (ms, 0 to return immediately, negative to wait forever).
+ *
+ * @return
+ *	0 on success, IL_ETIMEDOUT if no request completed in time.
+ */
+IL_EXPORT int il_async_completed_get(il_async_t *async, il_async_req_t **req,
+				     int timeout);
+
+/**
+ * Obtain a pollable file descriptor for the completion queue.
+ *
+ * @note
+ *	The descriptor is readable while the completion queue is not empty, so
+ *	it can be added to an external event loop (epoll, libuv, ...). It must
+ *	not be read or closed by the caller.
+ *
+ * @param [in] async
+ *	Asynchronous context instance.
+ *
+ * @return
+ *	File descriptor, IL_ENOTSUP if not available on this platform.
+ */
+IL_EXPORT int il_async_fd_get(il_async_t *async);
+
+/** @} */
+
+IL_END_DECL
+
+#endif
@@ -17,6 +17,16 @@ IL_BEGIN_DECL
 /** IngeniaLink dictionary. */
 typedef struct il_dict il_dict_t;
 
+/** Register storage value (bulk updates). */
+typedef struct {
+	/** Register ID. */
+	const char *id;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Storage value. */
+	il_reg_value_t storage;
+} il_dict_storage_t;
+
 /**
  * Create a dictionary.
  *
@@ -200,6 +210,29 @@ IL_EXPORT size_t il_dict_reg_cnt(il_dict_t *dict, uint8_t subnode);
  */
 IL_EXPORT int il_dict_reg_storage_update(il_dict_t *dict, const char *id,
 					 il_reg_value_t storage, uint8_t subnode);
+
+/**
+ * Update storage values of multiple registers.
+ *
+ * @note
+ *	Values are available right away, while the XML document is only
+ *	updated once, when the dictionary is saved.
+ *
+ * @param [in] dict
+ *	Dictionary instance.
+ * @param [in] storages
+ *	Storage values.
+ * @param [in] n
+ *	Number of storage values.
+ *
+ * @return
+ *	0 on success, last error code otherwise (other values are still
+ *	updated).
+ */
+IL_EXPORT int il_dict_reg_storage_update_many(il_dict_t *dict,
+					      const il_dict_storage_t *storages,
+					      size_t n);
+
 /**
  * Obtain the list of register IDs.
  *
@@ -1,9 +1,12 @@
 #ifndef PUBLIC_INGENIALINK_INGENIALINK_H_
 #define PUBLIC_INGENIALINK_INGENIALINK_H_
 
+#include "async.h"
 #include "const.h"
 #include "dict.h"
 #include "err.h"
+#include "mon_stream.h"
+#include "net_mgr.h"
 #include "poller.h"
 #include "version.h"
 
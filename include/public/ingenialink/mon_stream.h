@@ -0,0 +1,198 @@
+#ifndef PUBLIC_INGENIALINK_MON_STREAM_H_
+#define PUBLIC_INGENIALINK_MON_STREAM_H_
+
+#include "net.h"
+
+IL_BEGIN_DECL
+
+/**
+ * @file ingenialink/mon_stream.h
+ * @brief Continuous monitoring stream.
+ * @defgroup IL_MON_STREAM Continuous monitoring stream
+ * @ingroup IL
+ * @{
+ */
+
+/** IngeniaLink monitoring stream. */
+typedef struct il_mon_stream il_mon_stream_t;
+
+/**
+ * Monitoring stream samples callback.
+ *
+ * @note
+ *	It is called from the stream thread, so it should return quickly.
+ *
+ * @param [in] ctx
+ *	Context.
+ * @param [in] samples
+ *	Samples (n x n_ch values, interleaved by channel).
+ * @param [in] n
+ *	Number of samples.
+ * @param [in] n_ch
+ *	Number of channels.
+ */
+typedef void (*il_mon_stream_cb_t)(void *ctx, const double *samples, size_t n,
+				   size_t n_ch);
+
+/** Monitoring stream statistics. */
+typedef struct {
+	/** Samples received from the drive. */
+	uint64_t samples;
+	/** Samples dropped because the ring was full (overruns). */
+	uint64_t dropped;
+	/** Non-empty monitoring buffer reads. */
+	uint64_t bursts;
+	/** Monitoring re-arms. */
+	uint64_t rearms;
+	/** Failed monitoring transactions. */
+	uint64_t errors;
+} il_mon_stream_stats_t;
+
+/**
+ * Create a monitoring stream.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] cap
+ *	Ring capacity (samples).
+ *
+ * @return
+ *	Monitoring stream instance (NULL if it could not be created).
+ */
+IL_EXPORT il_mon_stream_t *il_mon_stream_create(il_net_t *net, size_t cap);
+
+/**
+ * Destroy a monitoring stream.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ */
+IL_EXPORT void il_mon_stream_destroy(il_mon_stream_t *stream);
+
+/**
+ * Set the samples callback.
+ *
+ * @note
+ *	When a callback is set, samples are delivered to it instead of being
+ *	queued on the ring. It can only be changed while stopped.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ * @param [in] cb
+ *	Callback (NULL to use the ring).
+ * @param [in] ctx
+ *	Callback context.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_mon_stream_cb_set(il_mon_stream_t *stream,
+				   il_mon_stream_cb_t cb, void *ctx);
+
+/**
+ * Capture the current monitoring mapping and (re)create the ring.
+ *
+ * @note
+ *	It can only be called while stopped, and no thread may be reading
+ *	from the stream meanwhile. Samples still queued are discarded.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_mon_stream_configure(il_mon_stream_t *stream);
+
+/**
+ * Start streaming.
+ *
+ * @note
+ *	Monitoring must have been configured (mapping, frequency, trigger)
+ *	beforehand. The mapping is captured on the first start (or with
+ *	il_mon_stream_configure), and later starts fail if it changed. The
+ *	ring is kept across starts, so readers may keep reading while the
+ *	stream is restarted. The stream then arms monitoring and keeps
+ *	draining and re-arming it until stopped.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ * @param [in] period
+ *	Polling period used while the drive buffer is empty (ms).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_mon_stream_start(il_mon_stream_t *stream, int period);
+
+/**
+ * Stop streaming.
+ *
+ * @note
+ *	Samples still queued on the ring can be read after stopping.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ */
+IL_EXPORT void il_mon_stream_stop(il_mon_stream_t *stream);
+
+/**
+ * Obtain the number of channels of the stream.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ *
+ * @return
+ *	Number of channels (0 if never configured).
+ */
+IL_EXPORT size_t il_mon_stream_channels_get(il_mon_stream_t *stream);
+
+/**
+ * Read samples from the ring.
+ *
+ * @note
+ *	It does not block. Only one thread may read from a stream.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ * @param [out] samples
+ *	Buffer (n x n_ch values, interleaved by channel).
+ * @param [in] n
+ *	Maximum number of samples.
+ *
+ * @return
+ *	Number of samples read.
+ */
+IL_EXPORT size_t il_mon_stream_read(il_mon_stream_t *stream, double *samples,
+				    size_t n);
+
+/**
+ * Obtain the number of samples available on the ring.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ *
+ * @return
+ *	Number of samples.
+ */
+IL_EXPORT size_t il_mon_stream_available(il_mon_stream_t *stream);
+
+/**
+ * Obtain the stream statistics.
+ *
+ * @note
+ *	Statistics are reset on every start.
+ *
+ * @param [in] stream
+ *	Monitoring stream instance.
+ * @param [out] stats
+ *	Statistics.
+ */
+IL_EXPORT void il_mon_stream_stats_get(il_mon_stream_t *stream,
+				       il_mon_stream_stats_t *stats);
+
+/** @} */
+
+IL_END_DECL
+
+#endif
@@ -124,12 +124,51 @@ typedef struct {
 	int slave;
 } il_ecat_net_opts_t;
 
+/** Monitoring/disturbance channel configuration. */
+typedef struct {
+	/** Register address. */
+	uint32_t address;
+	/** Register subnode. */
+	uint8_t subnode;
+	/** Register data type. */
+	il_reg_dtype_t dtype;
+	/** Register size (bytes). */
+	uint8_t size;
+} il_net_mon_channel_t;
+
+/**
+ * Monitoring download progress callback.
+ *
+ * @param [in] ctx
+ *	Context.
+ * @param [in] done
+ *	Bytes downloaded.
+ * @param [in] total
+ *	Bytes expected (may grow while downloading).
+ */
+typedef void (*il_net_mon_progress_cb_t)(void *ctx, size_t done, size_t total);
+
+/** Monitoring download statistics. */
+typedef struct {
+	/** Bytes downloaded. */
+	size_t bytes;
+	/** Blocks downloaded. */
+	size_t blocks;
+	/** Elapsed time (ns). */
+	uint64_t elapsed_ns;
+	/** Throughput (bytes/s). */
+	double throughput;
+} il_net_mon_download_stats_t;
+
 /** Default read timeout (ms). */
 #define IL_NET_TIMEOUT_RD_DEF	500
 
 /** Default write timeout (ms). */
 #define IL_NET_TIMEOUT_WR_DEF	500
 
+/** Default heartbeat idle interval (ms). */
+#define IL_NET_HEARTBEAT_IDLE_DEF	500
+
 /** Network state. */
 typedef enum {
 	/** Connected. */
@@ -295,6 +334,22 @@ IL_EXPORT int il_net_status_get(il_net_t *net);
  */
 IL_EXPORT int il_net_mon_stop(il_net_t *net);
 
+/**
+ * Set the heartbeat idle interval.
+ *
+ * @note
+ *	Any successful transaction counts as a heartbeat, so liveness probes
+ *	(statusword reads) are only sent once the network has been idle for
+ *	the given interval. Statusword values read by the application are
+ *	also delivered to the servo, saving the periodic state reads.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] idle
+ *	  Idle interval (ms), 0 to always probe.
+ */
+IL_EXPORT void il_net_heartbeat_idle_set(il_net_t *net, int idle);
+
 /**
  * Obtain network port.
  *
@@ -371,7 +426,7 @@ IL_EXPORT uint16_t il_net_monitornig_bytes_per_block_get(il_net_t *net);
  *	  Network.
  *
  * @returns
- *	Network disturbance data.
+ *	Network disturbance data (NULL if not set yet).
  */
 IL_EXPORT uint16_t *il_net_disturbance_data_get(il_net_t *net);
 
@@ -432,6 +487,78 @@ IL_EXPORT int il_net_remove_all_mapped_registers(il_net_t *net);
 IL_EXPORT int il_net_set_mapped_register(il_net_t *net, int channel, uint32_t address,
 											uint8_t subnode, il_reg_dtype_t dtype, uint8_t size);
 
+/**
+ * Set the monitoring download progress callback.
+ *
+ * @note
+ *	The callback is invoked from il_net_read_monitoring_data after each
+ *	block is received.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] cb
+ *	  Callback (NULL to disable).
+ * @param [in] ctx
+ *	  Callback context.
+ */
+IL_EXPORT void il_net_monitoring_progress_cb_set(il_net_t *net,
+						 il_net_mon_progress_cb_t cb,
+						 void *ctx);
+
+/**
+ * Obtain the statistics of the last monitoring download.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [out] stats
+ *	  Statistics.
+ */
+IL_EXPORT void il_net_monitoring_download_stats_get(
+	il_net_t *net, il_net_mon_download_stats_t *stats);
+
+/**
+ * Configure the monitoring channels.
+ *
+ * @note
+ *	Only the channels that differ from the configuration currently applied
+ *	are written, in a single (pipelined) transaction together with the
+ *	number of channels and the block size read back. Nothing is sent if
+ *	the configuration is already applied.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] channels
+ *	  Channels.
+ * @param [in] n
+ *	  Number of channels.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_monitoring_configure(il_net_t *net,
+					  const il_net_mon_channel_t *channels,
+					  size_t n);
+
+/**
+ * Configure the disturbance channels.
+ *
+ * @note
+ *	See il_net_monitoring_configure.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] channels
+ *	  Channels.
+ * @param [in] n
+ *	  Number of channels.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_disturbance_configure(il_net_t *net,
+					   const il_net_mon_channel_t *channels,
+					   size_t n);
+
 
 /**
  * Obtain number of mapped registers.
@@ -516,7 +643,7 @@ IL_EXPORT int il_net_read_monitoring_data(il_net_t *net);
  *	  Channel.
  *
  * @returns
- *	Network monitoring channel data.
+ *	Network monitoring channel data (NULL if the channel is not mapped).
  */
 IL_EXPORT uint16_t *il_net_monitoring_channel_u16(il_net_t *net, int channel);
 
@@ -530,7 +657,7 @@ IL_EXPORT uint16_t *il_net_monitoring_channel_u16(il_net_t *net, int channel);
  *	  Channel.
  *
  * @returns
- *	Network monitoring channel data.
+ *	Network monitoring channel data (NULL if the channel is not mapped).
  */
 IL_EXPORT int16_t *il_net_monitoring_channel_s16(il_net_t *net, int channel);
 
@@ -545,7 +672,7 @@ IL_EXPORT int16_t *il_net_monitoring_channel_s16(il_net_t *net, int channel);
  *	  Channel.
  *
  * @returns
- *	Network monitoring channel data.
+ *	Network monitoring channel data (NULL if the channel is not mapped).
  */
 IL_EXPORT uint32_t *il_net_monitoring_channel_u32(il_net_t *net, int channel);
 
@@ -559,7 +686,7 @@ IL_EXPORT uint32_t *il_net_monitoring_channel_u32(il_net_t *net, int channel);
  *	  Channel.
  *
  * @returns
- *	Network monitoring channel data.
+ *	Network monitoring channel data (NULL if the channel is not mapped).
  */
 IL_EXPORT int32_t *il_net_monitoring_channel_s32(il_net_t *net, int channel);
 
@@ -573,10 +700,80 @@ IL_EXPORT int32_t *il_net_monitoring_channel_s32(il_net_t *net, int channel);
  *	  Channel.
  *
  * @returns
- *	Network monitoring channel data.
+ *	Network monitoring channel data (NULL if the channel is not mapped).
  */
 IL_EXPORT float *il_net_monitoring_channel_flt(il_net_t *net, int channel);
 
+/**
+ * Obtain network monitoring channel data.
+ *
+ * @param [in] net
+ *	  Network.
+ *
+ * @param [in] channel
+ *	  Channel.
+ *
+ * @returns
+ *	Network monitoring channel data (NULL if the channel is not mapped).
+ */
+IL_EXPORT uint8_t *il_net_monitoring_channel_u8(il_net_t *net, int channel);
+
+/**
+ * Obtain network monitoring channel data.
+ *
+ * @param [in] net
+ *	  Network.
+ *
+ * @param [in] channel
+ *	  Channel.
+ *
+ * @returns
+ *	Network monitoring channel data (NULL if the channel is not mapped).
+ */
+IL_EXPORT int8_t *il_net_monitoring_channel_s8(il_net_t *net, int channel);
+
+/**
+ * Obtain network monitoring channel data.
+ *
+ * @param [in] net
+ *	  Network.
+ *
+ * @param [in] channel
+ *	  Channel.
+ *
+ * @returns
+ *	Network monitoring channel data (NULL if the channel is not mapped).
+ */
+IL_EXPORT uint64_t *il_net_monitoring_channel_u64(il_net_t *net, int channel);
+
+/**
+ * Obtain network monitoring channel data.
+ *
+ * @param [in] net
+ *	  Network.
+ *
+ * @param [in] channel
+ *	  Channel.
+ *
+ * @returns
+ *	Network monitoring channel data (NULL if the channel is not mapped).
+ */
+IL_EXPORT int64_t *il_net_monitoring_channel_s64(il_net_t *net, int channel);
+
+/**
+ * Obtain network monitoring channel data.
+ *
+ * @param [in] net
+ *	  Network.
+ *
+ * @param [in] channel
+ *	  Channel.
+ *
+ * @returns
+ *	Network monitoring channel data (NULL if the channel is not mapped).
+ */
+IL_EXPORT double *il_net_monitoring_channel_dbl(il_net_t *net, int channel);
+
 /**
  * Remove all Mapped registers from disturbance.
  *
@@ -649,6 +846,30 @@ IL_EXPORT void il_net_disturbance_data_s32_set(il_net_t *net, int channel, int32
  */
 IL_EXPORT void il_net_disturbance_data_flt_set(il_net_t *net, int channel, float disturbance_data[2048]);
 
+/**
+ * Set network disturbance channel data of any length.
+ *
+ * @note
+ *	Channels are interleaved into the upload payload as soon as their data
+ *	is set, and the disturbance data size is updated to the payload size.
+ *	Channels with fewer samples are padded with zeros. The payload is
+ *	uploaded in as many frames as needed by an extended write.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] channel
+ *	  Channel (must be mapped).
+ * @param [in] data
+ *	  Samples (channel data type).
+ * @param [in] n
+ *	  Number of samples.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_disturbance_channel_data_set(il_net_t *net, int channel,
+						  const void *data, size_t n);
+
 /**
  * Close socket connected.
  *
@@ -684,6 +905,80 @@ IL_EXPORT int il_net_set_recv_timeout(il_net_t *net, uint32_t timeout);
 
 IL_EXPORT int il_net_set_status_check_stop(il_net_t *net, int status_check);
 
+/**
+ * Set the time given to operations that are only acknowledged once they
+ * complete (e.g. store all).
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] timeout
+ *	  Timeout (ms).
+ *
+ * @return
+ *	  0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_set_wait_write_timeout(il_net_t *net, uint32_t timeout);
+
+/**
+ * Set the maximum number of outstanding requests (pipelined transfers).
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] depth
+ *	  Number of requests (1 disables pipelining).
+ *
+ * @return
+ *	  0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_set_pipeline_depth(il_net_t *net, size_t depth);
+
+/**
+ * Enable or disable the reactor mode.
+ *
+ * @note
+ *	In reactor mode a dedicated I/O thread owns the network socket and
+ *	serves register transactions, transfers and monitoring data downloads
+ *	submitted through a lock-free queue, so application threads, pollers
+ *	and the state monitor no longer contend for the network lock; each
+ *	caller only waits for its own completion. It may be toggled while
+ *	transactions are in progress: disabling it makes new transactions take
+ *	the direct path and waits for the submitted ones to complete. It must
+ *	not be toggled concurrently from several threads.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] enable
+ *	  Enable (1) or disable (0).
+ *
+ * @return
+ *	  0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_set_reactor(il_net_t *net, int enable);
+
+/**
+ * Set the reconnection backoff.
+ *
+ * @note
+ *	Once a disconnection is detected the first reconnection attempt is made
+ *	immediately. Subsequent attempts are delayed by an exponentially
+ *	growing, jittered interval (between half and the full value), starting
+ *	at the base interval and never exceeding the ceiling. The session
+ *	state known to the library (monitoring/disturbance mappings and data,
+ *	monitoring/disturbance enabled state) is restored after reconnecting.
+ *
+ * @param [in] net
+ *	  Network.
+ * @param [in] base
+ *	  First retry interval (ms).
+ * @param [in] ceiling
+ *	  Maximum retry interval (ms).
+ *
+ * @return
+ *	  0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_set_reconnection_backoff(il_net_t *net, uint32_t base,
+					      uint32_t ceiling);
+
 IL_EXPORT int il_net_SDO_read(il_net_t *net, uint8_t slave, uint16_t index, uint8_t subindex, il_reg_dtype_t dtype, double *buf);
 
 IL_EXPORT int il_net_SDO_read_array(il_net_t *net, uint8_t slave, uint16_t index, uint8_t subindex, int size, void *buf);
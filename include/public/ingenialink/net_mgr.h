@@ -0,0 +1,165 @@
+#ifndef PUBLIC_INGENIALINK_NET_MGR_H_
+#define PUBLIC_INGENIALINK_NET_MGR_H_
+
+#include "net.h"
+#include "servo.h"
+
+IL_BEGIN_DECL
+
+/**
+ * @file ingenialink/net_mgr.h
+ * @brief Connection manager.
+ * @defgroup IL_NET_MGR Connection manager
+ * @ingroup IL
+ * @{
+ */
+
+/** IngeniaLink connection manager. */
+typedef struct il_net_mgr il_net_mgr_t;
+
+/** Default heartbeat period (ms). */
+#define IL_NET_MGR_HEARTBEAT_DEF	500
+
+/** Default state polling period (ms). */
+#define IL_NET_MGR_STATE_PERIOD_DEF	200
+
+/** Default reconnection period (ms). */
+#define IL_NET_MGR_RECONNECT_DEF	1000
+
+/** Connection manager statistics. */
+typedef struct {
+	/** Managed networks. */
+	size_t nets;
+	/** Managed servos. */
+	size_t servos;
+	/** Event loop wake-ups. */
+	uint64_t wakeups;
+	/** Statusword probes sent. */
+	uint64_t probes;
+	/** Probes skipped because the network was in use. */
+	uint64_t busy;
+	/** Probes saved because regular traffic was seen recently. */
+	uint64_t skipped;
+	/** Failed probes. */
+	uint64_t errors;
+	/** Disconnections detected. */
+	uint64_t disconnects;
+	/** Successful reconnections. */
+	uint64_t reconnects;
+} il_net_mgr_stats_t;
+
+/**
+ * Create a connection manager.
+ *
+ * @note
+ *	A single thread serves all the networks and servos added to the
+ *	manager: statusword probes (heartbeat and state polling) are sent to
+ *	all drives and their replies are awaited at the same time on an event
+ *	loop (epoll on Linux), while periodic work is scheduled on a timer
+ *	wheel. This replaces the listener thread each network runs and the
+ *	state and emergency monitor threads each servo runs, so the number of
+ *	threads no longer grows with the number of drives.
+ *
+ * @return
+ *	Connection manager instance (NULL if it could not be created).
+ */
+IL_EXPORT il_net_mgr_t *il_net_mgr_create(void);
+
+/**
+ * Destroy a connection manager.
+ *
+ * @note
+ *	Networks still managed get their own listener back.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ */
+IL_EXPORT void il_net_mgr_destroy(il_net_mgr_t *mgr);
+
+/**
+ * Set the heartbeat period.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [in] period
+ *	Period (ms), 0 to disable heartbeats.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_mgr_heartbeat_set(il_net_mgr_t *mgr, int period);
+
+/**
+ * Add a network to the manager.
+ *
+ * @note
+ *	Only Ethernet networks can be managed.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_mgr_net_add(il_net_mgr_t *mgr, il_net_t *net);
+
+/**
+ * Remove a network (and its servos) from the manager.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [in] net
+ *	IngeniaLink network.
+ */
+IL_EXPORT void il_net_mgr_net_remove(il_net_mgr_t *mgr, il_net_t *net);
+
+/**
+ * Add a servo to the manager.
+ *
+ * @note
+ *	The servo network must have been added first. State and emergency
+ *	subscribers are notified from the manager thread (without holding any
+ *	manager lock), so callbacks must return quickly. They must not remove
+ *	networks or servos, as removal waits for the manager thread.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [in] servo
+ *	IngeniaLink servo.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_net_mgr_servo_add(il_net_mgr_t *mgr, il_servo_t *servo);
+
+/**
+ * Remove a servo from the manager.
+ *
+ * @note
+ *	The servo gets its own state and emergency monitors back.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [in] servo
+ *	IngeniaLink servo.
+ */
+IL_EXPORT void il_net_mgr_servo_remove(il_net_mgr_t *mgr, il_servo_t *servo);
+
+/**
+ * Obtain connection manager statistics.
+ *
+ * @param [in] mgr
+ *	Connection manager instance.
+ * @param [out] stats
+ *	Statistics.
+ */
+IL_EXPORT void il_net_mgr_stats_get(il_net_mgr_t *mgr,
+				    il_net_mgr_stats_t *stats);
+
+/** @} */
+
+IL_END_DECL
+
+#endif
@@ -26,8 +26,32 @@ typedef struct {
 	size_t cnt;
 	/** Data lost flag. */
 	int lost;
+	/** Sampling deadlines missed (see il_poller_overrun_t). */
+	uint64_t missed;
 } il_poller_acq_t;
 
+/** Poller ring statistics. */
+typedef struct {
+	/** Samples acquired. */
+	uint64_t samples;
+	/** Samples dropped because the ring was full. */
+	uint64_t dropped;
+	/** Sampling deadlines missed (see il_poller_overrun_t). */
+	uint64_t missed;
+	/** Failed acquisitions. */
+	uint64_t errors;
+} il_poller_ring_stats_t;
+
+/** Poller overrun policies (what to do when a deadline has been missed). */
+typedef enum {
+	/** Skip missed deadlines and wait for the next one on schedule. */
+	IL_POLLER_OVERRUN_SKIP,
+	/** Sample back to back until the schedule is recovered. */
+	IL_POLLER_OVERRUN_CATCH_UP,
+	/** Sample now and restart the schedule from this sample. */
+	IL_POLLER_OVERRUN_STRETCH,
+} il_poller_overrun_t;
+
 /**
  * Create a register poller.
  *
@@ -52,6 +76,11 @@ IL_EXPORT void il_poller_destroy(il_poller_t *poller);
 /**
  * Start poller.
  *
+ * @note
+ *	All the configured channels are read in a single batch every sample
+ *	(pipelined when the network supports it), so that channels are
+ *	sampled at the same instant.
+ *
  * @param [in] poller
  *	Poller instance.
  *
@@ -86,8 +115,7 @@ IL_EXPORT void il_poller_data_get(il_poller_t *poller, il_poller_acq_t **acq);
  * Configure poller parameters.
  *
  * @note
- *	- The maximum stable polling rate is ~500 Hz (2 ms) for a single
- *	  register when the servo is enabled.
+ *	- See il_poller_configure_ns for sub-millisecond periods.
  *	- The buffer size must be set according to your application needs. It
  *	  should be large enough so that it can store all samples collected
  *	  between subsequent calls to `il_poller_data_get`.
@@ -105,6 +133,62 @@ IL_EXPORT void il_poller_data_get(il_poller_t *poller, il_poller_acq_t **acq);
 IL_EXPORT int il_poller_configure(il_poller_t *poller, unsigned int t_s,
 				  size_t buf_sz);
 
+/**
+ * Configure poller parameters (nanoseconds period).
+ *
+ * @note
+ *	Samples are scheduled on absolute deadlines (start time plus a
+ *	multiple of the period), so the sampling instants do not drift.
+ *	Deadlines missed because acquisition took longer than the period are
+ *	handled as given by il_poller_overrun_set, and reported in the
+ *	acquisition results.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [in] period
+ *	Sampling period (ns).
+ * @param [in] buf_sz
+ *	Buffer size.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_poller_configure_ns(il_poller_t *poller, uint64_t period,
+				     size_t buf_sz);
+
+/**
+ * Set the poller overrun policy.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [in] overrun
+ *	Overrun policy (IL_POLLER_OVERRUN_SKIP by default).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_poller_overrun_set(il_poller_t *poller,
+				    il_poller_overrun_t overrun);
+
+/**
+ * Set the poller spin window.
+ *
+ * @note
+ *	The poller sleeps until the spin window before each deadline, and
+ *	busy-waits for the rest. This trades CPU time for lower wake-up
+ *	jitter at sub-millisecond periods.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [in] spin
+ *	Spin window (ns, 0 to always sleep, the default; wake-ups are then
+ *	subject to the platform sleep granularity).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_poller_spin_set(il_poller_t *poller, uint64_t spin);
+
 /**
  * Configure a poller channel.
  *
@@ -147,6 +231,88 @@ IL_EXPORT int il_poller_ch_disable(il_poller_t *poller, unsigned int ch);
  */
 IL_EXPORT int il_poller_ch_disable_all(il_poller_t *poller);
 
+/**
+ * Configure the poller ring.
+ *
+ * @note
+ *	When a ring capacity is set, samples are pushed as records to a
+ *	lock-free single producer/single consumer ring instead of the double
+ *	buffered acquisition (il_poller_data_get then returns no samples).
+ *	Neither side ever waits for the other: records that do not fit are
+ *	dropped and accounted. The ring is kept across starts and stops, so
+ *	consumers may keep reading while the poller is restarted, but not
+ *	while the ring is (re)configured.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [in] cap
+ *	Ring capacity (records, rounded up to a power of two), 0 to use double
+ *	buffering (the default).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_poller_ring_configure(il_poller_t *poller, size_t cap);
+
+/**
+ * Obtain a view of the records available on the ring.
+ *
+ * @note
+ *	Each record holds the sample time followed by the value of every
+ *	channel (n_ch + 1 values, disabled channels are left to 0). The view
+ *	is valid until il_poller_ring_consume is called. Only one thread may
+ *	consume from a poller.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [out] samples
+ *	Where the first record will be pointed.
+ *
+ * @return
+ *	Number of contiguous records in the view (more may follow once they
+ *	are consumed).
+ */
+IL_EXPORT size_t il_poller_ring_peek(il_poller_t *poller,
+				     const double **samples);
+
+/**
+ * Release records obtained with il_poller_ring_peek.
+ *
+ * @note
+ *	At most the available records are released.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [in] n
+ *	Number of records.
+ */
+IL_EXPORT void il_poller_ring_consume(il_poller_t *poller, size_t n);
+
+/**
+ * Obtain the number of records available on the ring.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ *
+ * @return
+ *	Number of records.
+ */
+IL_EXPORT size_t il_poller_ring_available(il_poller_t *poller);
+
+/**
+ * Obtain the ring statistics.
+ *
+ * @note
+ *	Statistics are reset on every start.
+ *
+ * @param [in] poller
+ *	Poller instance.
+ * @param [out] stats
+ *	Statistics.
+ */
+IL_EXPORT void il_poller_ring_stats_get(il_poller_t *poller,
+					il_poller_ring_stats_t *stats);
+
 /** @} */
 
 IL_END_DECL
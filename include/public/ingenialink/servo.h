@@ -20,6 +20,9 @@ typedef struct il_servo il_servo_t;
 /** Set-point acknowledge default timeout (ms). */
 #define IL_SERVO_SP_TIMEOUT_DEF	1000
 
+/** Statusword polling period while waiting for state changes (ms). */
+#define IL_SERVO_SW_POLL_DEF	10
+
 /** Servo name size (includes null termination). */
 #define IL_SERVO_NAME_SZ	9
 
@@ -194,6 +197,107 @@ typedef enum {
 	IL_UNITS_ACC_M_S2,
 } il_units_acc_t;
 
+/** Register access (batched read/write). */
+typedef struct {
+	/** Pre-defined register (NULL to use id). */
+	const il_reg_t *reg;
+	/** Register ID (used if reg is NULL). */
+	const char *id;
+	/** Subnode (used to look up id). */
+	uint8_t subnode;
+	/** Value (read result or value to be written). */
+	double val;
+	/** Result (0 on success, error code otherwise). */
+	int r;
+} il_servo_access_t;
+
+/**
+ * Progress callback.
+ *
+ * @param [in] ctx
+ *	Context.
+ * @param [in] done
+ *	Registers processed so far.
+ * @param [in] total
+ *	Total number of registers.
+ */
+typedef void (*il_servo_progress_cb_t)(void *ctx, size_t done, size_t total);
+
+/** Configuration restore outcome of a register. */
+typedef enum {
+	/** Value written. */
+	IL_SERVO_RESTORE_WRITTEN,
+	/** Value already held by the drive, not written. */
+	IL_SERVO_RESTORE_SKIPPED,
+	/** Value could not be written (or is out of range). */
+	IL_SERVO_RESTORE_FAILED,
+} il_servo_restore_status_t;
+
+/** Configuration restore report entry. */
+typedef struct {
+	/** Register ID (owned by the configuration dictionary). */
+	const char *id;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Outcome. */
+	il_servo_restore_status_t status;
+	/** Result (0 on success, error code otherwise). */
+	int r;
+} il_servo_restore_entry_t;
+
+/** Configuration restore report. */
+typedef struct {
+	/** Entries (one per register considered). */
+	il_servo_restore_entry_t *entries;
+	/** Number of entries. */
+	size_t n;
+	/** Registers written. */
+	size_t written;
+	/** Registers skipped (value already held by the drive). */
+	size_t skipped;
+	/** Registers that could not be written. */
+	size_t failed;
+} il_servo_restore_report_t;
+
+/** Pre-resolved register handle. */
+typedef struct il_reg_handle il_reg_handle_t;
+
+/** Register mirror policies. */
+typedef enum {
+	/** Not mirrored, always read from the drive. */
+	IL_SERVO_MIRROR_NONE,
+	/** Read once, then served from the mirror. */
+	IL_SERVO_MIRROR_STATIC,
+	/** Served from the mirror until older than its time to live. */
+	IL_SERVO_MIRROR_TTL,
+	/** Kept fresh by the background refresher, served while recent. */
+	IL_SERVO_MIRROR_LIVE,
+} il_servo_mirror_policy_t;
+
+/** Register mirror statistics. */
+typedef struct {
+	/** Mirrored registers. */
+	size_t entries;
+	/** Reads served from the mirror. */
+	uint64_t hits;
+	/** Reads of mirrored registers that went to the drive. */
+	uint64_t misses;
+	/** Background refresh rounds. */
+	uint64_t refreshes;
+	/** Failed background register reads. */
+	uint64_t errors;
+} il_servo_mirror_stats_t;
+
+/** Servo axis (group state transitions). */
+typedef struct {
+	/** Servo. */
+	il_servo_t *servo;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Result (0 on success, error code otherwise). */
+	int r;
+} il_servo_axis_t;
+
 /**
  * Create IngeniaLink servo instance.
  *
@@ -280,6 +384,22 @@ IL_EXPORT int il_servo_state_subscribe(il_servo_t *servo,
  */
 IL_EXPORT void il_servo_state_unsubscribe(il_servo_t *servo, int slot);
 
+/**
+ * Set the statusword polling period used while waiting for state changes.
+ *
+ * @note
+ *	Waiters (e.g. il_servo_enable) are also woken up as soon as a new
+ *	statusword is pushed by the state monitor, the connection manager or
+ *	regular traffic. With polling disabled they rely on those alone, which
+ *	only track the first subnodes (others are always polled).
+ *
+ * @param [in] servo
+ *	IngeniaLink servo instance.
+ * @param [in] period
+ *	Polling period (ms), 0 to disable polling.
+ */
+IL_EXPORT void il_servo_sw_poll_set(il_servo_t *servo, int period);
+
 /**
  * Subscribe to emergency messages.
  *
@@ -340,25 +460,101 @@ IL_EXPORT int il_servo_dict_load(il_servo_t *servo, const char *dict);
 /**
  * Read all dictionary registers content and put it to the dictionary storage.
  *
+ * @note
+ *	Registers are read in pipelined batches, with the registers of all
+ *	subnodes interleaved, and stored in the dictionary in bulk. Registers
+ *	that can not be read keep their previous storage value.
+ *
  * @param [in] servo
  *	Servo instance.
  *
  * @return
- *	0 on success, error code otherwise.
+ *	0 on success, error code otherwise (no register could be read).
  */
 IL_EXPORT int il_servo_dict_storage_read(il_servo_t *servo);
 
+/**
+ * Read all dictionary registers content and put it to the dictionary storage,
+ * reporting progress.
+ *
+ * @param [in] servo
+ *	Servo instance.
+ * @param [in] cb
+ *	Progress callback (called after each batch).
+ * @param [in] ctx
+ *	Callback context.
+ *
+ * @return
+ *	0 on success, error code otherwise (no register could be read).
+ *
+ * @see
+ *	il_servo_dict_storage_read
+ */
+IL_EXPORT int il_servo_dict_storage_read_progress(il_servo_t *servo,
+						  il_servo_progress_cb_t cb,
+						  void *ctx);
+
 /**
  * Write current dictionary storage to the servo drive.
  *
+ * @note
+ *	See il_servo_dict_storage_restore, which is used with the parsed
+ *	dictionary file.
+ *
  * @param [in] servo
  *	Servo instance.
+ * @param [in] dict_path
+ *	Configuration dictionary file.
+ * @param [in] subnode
+ *	Subnode to be written (-1 for all).
  *
  * @return
  *	0 on success, error code otherwise.
  */
 IL_EXPORT int il_servo_dict_storage_write(il_servo_t *servo, const char *dict_path, int subnode);
 
+/**
+ * Restore a configuration (dictionary storage) to the servo drive.
+ *
+ * @note
+ *	Only registers whose value differs from the one held by the drive are
+ *	written. Current values are taken from the register mirror if fresh
+ *	(see il_servo_mirror_enable), or read in pipelined batches otherwise.
+ *	Writes are pipelined as well. RW registers without a storage value
+ *	are not considered, and storage values out of the register range are
+ *	not written but reported as failed.
+ *
+ *	The configuration is not modified, so the same parsed dictionary can
+ *	be restored to any number of drives.
+ *
+ * @param [in] servo
+ *	Servo instance.
+ * @param [in] cfg
+ *	Configuration dictionary.
+ * @param [in] subnode
+ *	Subnode to be written (-1 for all).
+ * @param [out] report
+ *	Per-register report (optional, NULL if not needed).
+ *
+ * @return
+ *	0 on success, first error code otherwise.
+ *
+ * @see
+ *	il_servo_restore_report_destroy
+ */
+IL_EXPORT int il_servo_dict_storage_restore(il_servo_t *servo, il_dict_t *cfg,
+					    int subnode,
+					    il_servo_restore_report_t **report);
+
+/**
+ * Destroy a configuration restore report.
+ *
+ * @param [in] report
+ *	Report.
+ */
+IL_EXPORT void il_servo_restore_report_destroy(
+		il_servo_restore_report_t *report);
+
 /**
  * Obtain servo name.
  *
@@ -749,6 +945,26 @@ IL_EXPORT int il_servo_raw_read_float(il_servo_t *servo, const il_reg_t *reg,
 IL_EXPORT int il_servo_read(il_servo_t *servo, const il_reg_t *reg,
 			    const char *id, double *buf);
 
+/**
+ * Read multiple registers.
+ *
+ * All registers are read in a single batch: requests are pipelined when the
+ * network supports it, so the cost is close to one round-trip instead of one
+ * per register.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in, out] accs
+ *	Register accesses (value and result are filled for each entry).
+ * @param [in] n
+ *	Number of accesses.
+ *
+ * @returns
+ *	0 if all registers were read, first error code otherwise.
+ */
+IL_EXPORT int il_servo_read_many(il_servo_t *servo, il_servo_access_t *accs,
+				 size_t n);
+
 /**
  * Write unsigned 8-bit integer to a register.
  *
@@ -955,6 +1171,210 @@ IL_EXPORT int il_servo_raw_write_float(il_servo_t *servo, const il_reg_t *reg,
 IL_EXPORT int il_servo_write(il_servo_t *servo, const il_reg_t *reg,
 			     const char *id, double val, int confirm, uint16_t extended);
 
+/**
+ * Write multiple registers.
+ *
+ * All registers are written in a single batch: requests are pipelined when
+ * the network supports it. Every write is confirmed.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in, out] accs
+ *	Register accesses (result is filled for each entry).
+ * @param [in] n
+ *	Number of accesses.
+ *
+ * @returns
+ *	0 if all registers were written, first error code otherwise.
+ */
+IL_EXPORT int il_servo_write_many(il_servo_t *servo, il_servo_access_t *accs,
+				  size_t n);
+
+/**
+ * Create a register handle.
+ *
+ * @note
+ *	The register is resolved once, and its location, data type, access,
+ *	range and units factor are kept in the handle, so that accesses
+ *	through the handle skip the dictionary look up and checks. The units
+ *	factor is obtained when the handle is created.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] reg
+ *	Pre-defined register.
+ * @param [in] id
+ *	Register ID (used if reg is NULL).
+ * @param [in] subnode
+ *	Subnode (used to look up id).
+ *
+ * @return
+ *	Register handle (NULL if it could not be created).
+ *
+ * @see
+ *	il_reg_handle_destroy
+ */
+IL_EXPORT il_reg_handle_t *il_reg_handle_create(il_servo_t *servo,
+						const il_reg_t *reg,
+						const char *id,
+						uint8_t subnode);
+
+/**
+ * Destroy a register handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ */
+IL_EXPORT void il_reg_handle_destroy(il_reg_handle_t *handle);
+
+/**
+ * Obtain the data type of a register handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ *
+ * @return
+ *	Data type (selects the il_reg_value_t member used by read/write).
+ */
+IL_EXPORT il_reg_dtype_t il_reg_handle_dtype_get(il_reg_handle_t *handle);
+
+/**
+ * Read a register through its handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [out] val
+ *	Value (member given by the register data type).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_reg_handle_read(il_reg_handle_t *handle, il_reg_value_t *val);
+
+/**
+ * Write a register through its handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [in] val
+ *	Value (member given by the register data type).
+ * @param [in] confirm
+ *	Confirm the write.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_reg_handle_write(il_reg_handle_t *handle, il_reg_value_t val,
+				  int confirm);
+
+/**
+ * Read a register through its handle, in units.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [out] val
+ *	Value, with the units factor applied.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_reg_handle_read_units(il_reg_handle_t *handle, double *val);
+
+/**
+ * Write a register through its handle, in units.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [in] val
+ *	Value, with the units factor applied.
+ * @param [in] confirm
+ *	Confirm the write.
+ *
+ * @return
+ *	0 on success, error code otherwise (e.g. value out of range).
+ */
+IL_EXPORT int il_reg_handle_write_units(il_reg_handle_t *handle, double val,
+					int confirm);
+
+/**
+ * Enable the register mirror.
+ *
+ * @note
+ *	The mirror keeps the last known value of the registers given a policy
+ *	(see il_servo_mirror_policy_set), so that reads (il_servo_read,
+ *	il_servo_raw_read_*, il_servo_read_many) can be served without going
+ *	to the drive. Writes go through the mirror, keeping it coherent with
+ *	the values written. Registers without a policy are not affected.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] refresh
+ *	Background refresh period of live registers (ms), 0 to read live
+ *	registers from the drive every time.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_servo_mirror_enable(il_servo_t *servo, int refresh);
+
+/**
+ * Disable the register mirror.
+ *
+ * @note
+ *	Policies and mirrored values are dropped.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ */
+IL_EXPORT void il_servo_mirror_disable(il_servo_t *servo);
+
+/**
+ * Set the mirror policy of a register.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] reg
+ *	Pre-defined register.
+ * @param [in] id
+ *	Register ID (used if reg is NULL).
+ * @param [in] subnode
+ *	Subnode (used to look up id).
+ * @param [in] policy
+ *	Policy.
+ * @param [in] ttl
+ *	Time to live (ms), only used by IL_SERVO_MIRROR_TTL.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+IL_EXPORT int il_servo_mirror_policy_set(il_servo_t *servo, const il_reg_t *reg,
+					 const char *id, uint8_t subnode,
+					 il_servo_mirror_policy_t policy,
+					 int ttl);
+
+/**
+ * Invalidate all mirrored values.
+ *
+ * @note
+ *	Policies are kept, values are read again from the drive on next use
+ *	(e.g. after a configuration has been loaded by other means).
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ */
+IL_EXPORT void il_servo_mirror_invalidate(il_servo_t *servo);
+
+/**
+ * Obtain register mirror statistics.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [out] stats
+ *	Statistics.
+ */
+IL_EXPORT void il_servo_mirror_stats_get(il_servo_t *servo,
+					 il_servo_mirror_stats_t *stats);
+
 /**
  * Disable servo PDS.
  *
@@ -1015,6 +1435,70 @@ IL_EXPORT int il_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout);
  */
 IL_EXPORT int il_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int timeout);
 
+/**
+ * Disable the PDS of a group of axes.
+ *
+ * @note
+ *	All axes are driven through the state machine at the same time:
+ *	controlwords are sent to every axis and their statuswords are then
+ *	checked in turns, so that the drives change state concurrently instead
+ *	of one after the other. Axes may belong to different servos and
+ *	networks.
+ *
+ * @param [in, out] axes
+ *	Axes (result is filled for each entry).
+ * @param [in] n
+ *	Number of axes.
+ * @param [in] timeout
+ *	Timeout between state changes of each axis (ms), a value <= 0 waits
+ *	forever.
+ *
+ * @return
+ *	0 if all axes were disabled, first error code otherwise.
+ */
+IL_EXPORT int il_servo_group_disable(il_servo_axis_t *axes, size_t n,
+				     int timeout);
+
+/**
+ * Enable the PDS of a group of axes.
+ *
+ * @note
+ *	See il_servo_group_disable.
+ *
+ * @param [in, out] axes
+ *	Axes (result is filled for each entry).
+ * @param [in] n
+ *	Number of axes.
+ * @param [in] timeout
+ *	Timeout between state changes of each axis (ms), a value <= 0 waits
+ *	forever.
+ *
+ * @return
+ *	0 if all axes were enabled, first error code otherwise.
+ */
+IL_EXPORT int il_servo_group_enable(il_servo_axis_t *axes, size_t n,
+				    int timeout);
+
+/**
+ * Reset the fault state of a group of axes.
+ *
+ * @note
+ *	See il_servo_group_disable.
+ *
+ * @param [in, out] axes
+ *	Axes (result is filled for each entry).
+ * @param [in] n
+ *	Number of axes.
+ * @param [in] timeout
+ *	Timeout between state changes of each axis (ms), a value <= 0 waits
+ *	forever.
+ *
+ * @return
+ *	0 if all axes left the fault state, first error code otherwise.
+ */
+IL_EXPORT int il_servo_group_fault_reset(il_servo_axis_t *axes, size_t n,
+					 int timeout);
+
 /**
  * Get the servo operation mode.
  *
@@ -0,0 +1,536 @@
+#include "async.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "ingenialink/err.h"
+#include "ingenialink/servo.h"
+#include "servo.h"
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/**
+ * Drop a request reference.
+ *
+ * @note
+ *	Must be called with the context lock held.
+ *
+ * @param [in] req
+ *	Request.
+ */
+static void req_unref(il_async_req_t *req)
+{
+	if (--req->refs > 0)
+		return;
+
+	il_servo__release(req->servo);
+	free(req->id);
+	free(req);
+}
+
+/**
+ * Notify the completion queue file descriptor.
+ *
+ * @param [in] async
+ *	Asynchronous context.
+ */
+static void fd_notify(il_async_t *async)
+{
+#ifndef _WIN32
+	char c = 0;
+
+	if (async->fds[1] >= 0)
+		(void)write(async->fds[1], &c, sizeof(c));
+#else
+	(void)async;
+#endif
+}
+
+/**
+ * Clear the completion queue file descriptor.
+ *
+ * @param [in] async
+ *	Asynchronous context.
+ */
+static void fd_clear(il_async_t *async)
+{
+#ifndef _WIN32
+	char buf[64];
+
+	if (async->fds[0] >= 0) {
+		while (read(async->fds[0], buf, sizeof(buf)) > 0)
+			;
+	}
+#else
+	(void)async;
+#endif
+}
+
+/**
+ * Complete a request.
+ *
+ * @note
+ *	Must be called with the context lock held, which is temporarily
+ *	released while the callback runs.
+ *
+ * @param [in] async
+ *	Asynchronous context.
+ * @param [in] req
+ *	Request.
+ */
+static void req_complete(il_async_t *async, il_async_req_t *req)
+{
+	req->done = 1;
+
+	if (req->refs == 1) {
+		/* handle already released, nobody is waiting for it */
+		req_unref(req);
+	} else if (req->cb) {
+		osal_mutex_unlock(async->lock);
+		req->cb(req->ctx, req);
+		osal_mutex_lock(async->lock);
+
+		req_unref(req);
+	} else {
+		req->next = NULL;
+		if (async->tail)
+			async->tail->next = req;
+		else
+			async->head = req;
+		async->tail = req;
+
+		if (async->head == req)
+			fd_notify(async);
+
+		osal_cond_broadcast(async->cond);
+	}
+}
+
+/**
+ * Network worker thread.
+ *
+ * @param [in] args
+ *	Worker.
+ */
+static int worker_td(void *args)
+{
+	il_async_worker_t *w = args;
+	il_async_t *async = w->async;
+
+	osal_mutex_lock(async->lock);
+
+	for (;;) {
+		il_async_req_t *req;
+
+		while (!w->head && !w->stop)
+			(void)osal_cond_wait(w->cond, async->lock, 0);
+
+		req = w->head;
+		if (!req)
+			break;
+
+		w->head = req->next;
+		if (!w->head)
+			w->tail = NULL;
+
+		if (w->stop) {
+			ilerr__set("Request cancelled");
+			req->r = IL_EFAIL;
+		} else if (req->refs == 1) {
+			/* released before being served, skip the transaction */
+			req->r = IL_EFAIL;
+		} else {
+			double val = req->val;
+			int r;
+
+			osal_mutex_unlock(async->lock);
+
+			if (req->write)
+				r = il_servo_write(req->servo, req->reg, req->id,
+						   val, req->confirm, 0);
+			else
+				r = il_servo_read(req->servo, req->reg, req->id,
+						  &val);
+
+			osal_mutex_lock(async->lock);
+
+			req->r = r;
+			req->val = val;
+		}
+
+		req_complete(async, req);
+	}
+
+	osal_mutex_unlock(async->lock);
+
+	return 0;
+}
+
+/**
+ * Obtain (or create) the worker serving a network.
+ *
+ * @note
+ *	Must be called with the context lock held.
+ *
+ * @param [in] async
+ *	Asynchronous context.
+ * @param [in] net
+ *	Network.
+ *
+ * @return
+ *	Worker (NULL if it could not be created).
+ */
+static il_async_worker_t *worker_get(il_async_t *async, il_net_t *net)
+{
+	il_async_worker_t *w;
+
+	for (w = async->workers; w; w = w->next) {
+		if (w->net == net)
+			return w;
+	}
+
+	w = calloc(1, sizeof(*w));
+	if (!w) {
+		ilerr__set("Worker allocation failed");
+		return NULL;
+	}
+
+	w->async = async;
+	w->net = net;
+
+	w->cond = osal_cond_create();
+	if (!w->cond) {
+		ilerr__set("Worker condition allocation failed");
+		goto cleanup_w;
+	}
+
+	w->td = osal_thread_create_(worker_td, w);
+	if (!w->td) {
+		ilerr__set("Worker thread creation failed");
+		goto cleanup_cond;
+	}
+
+	w->next = async->workers;
+	async->workers = w;
+
+	return w;
+
+cleanup_cond:
+	osal_cond_destroy(w->cond);
+
+cleanup_w:
+	free(w);
+
+	return NULL;
+}
+
+/**
+ * Submit a request.
+ *
+ * @param [in] async
+ *	Asynchronous context.
+ * @param [in] servo
+ *	Servo.
+ * @param [in] reg
+ *	Pre-defined register.
+ * @param [in] id
+ *	Register ID.
+ * @param [in] write
+ *	Write flag.
+ * @param [in] val
+ *	Value to be written.
+ * @param [in] confirm
+ *	Confirm write.
+ * @param [in] cb
+ *	Completion callback.
+ * @param [in] ctx
+ *	Callback context.
+ *
+ * @return
+ *	Request (NULL if it could not be submitted).
+ */
+static il_async_req_t *req_submit(il_async_t *async, il_servo_t *servo,
+				  const il_reg_t *reg, const char *id,
+				  int write, double val, int confirm,
+				  il_async_cb_t cb, void *ctx)
+{
+	il_async_req_t *req;
+	il_async_worker_t *w;
+
+	if (!reg && !id) {
+		ilerr__set("No register given");
+		return NULL;
+	}
+
+	req = calloc(1, sizeof(*req));
+	if (!req) {
+		ilerr__set("Request allocation failed");
+		return NULL;
+	}
+
+	if (id) {
+		req->id = malloc(strlen(id) + 1);
+		if (!req->id) {
+			ilerr__set("Request ID allocation failed");
+			goto cleanup_req;
+		}
+
+		strcpy(req->id, id);
+	}
+
+	req->async = async;
+	req->servo = servo;
+	req->reg = reg;
+	req->write = write;
+	req->val = val;
+	req->confirm = confirm;
+	req->cb = cb;
+	req->ctx = ctx;
+	req->refs = 2;
+
+	osal_mutex_lock(async->lock);
+
+	w = worker_get(async, servo->net);
+	if (!w) {
+		osal_mutex_unlock(async->lock);
+		goto cleanup_id;
+	}
+
+	il_servo__retain(servo);
+
+	if (w->tail)
+		w->tail->next = req;
+	else
+		w->head = req;
+	w->tail = req;
+
+	osal_cond_signal(w->cond);
+
+	osal_mutex_unlock(async->lock);
+
+	return req;
+
+cleanup_id:
+	free(req->id);
+
+cleanup_req:
+	free(req);
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Public
+ ******************************************************************************/
+
+il_async_t *il_async_create(void)
+{
+	il_async_t *async;
+
+	async = calloc(1, sizeof(*async));
+	if (!async) {
+		ilerr__set("Asynchronous context allocation failed");
+		return NULL;
+	}
+
+	async->fds[0] = -1;
+	async->fds[1] = -1;
+
+	async->lock = osal_mutex_create();
+	if (!async->lock) {
+		ilerr__set("Asynchronous context lock allocation failed");
+		goto cleanup_async;
+	}
+
+	async->cond = osal_cond_create();
+	if (!async->cond) {
+		ilerr__set("Asynchronous context condition allocation failed");
+		goto cleanup_lock;
+	}
+
+#ifndef _WIN32
+	if (pipe(async->fds) < 0) {
+		ilerr__set("Notification pipe creation failed");
+		goto cleanup_cond;
+	}
+
+	(void)fcntl(async->fds[0], F_SETFL, O_NONBLOCK);
+	(void)fcntl(async->fds[1], F_SETFL, O_NONBLOCK);
+#endif
+
+	return async;
+
+#ifndef _WIN32
+cleanup_cond:
+	osal_cond_destroy(async->cond);
+#endif
+
+cleanup_lock:
+	osal_mutex_destroy(async->lock);
+
+cleanup_async:
+	free(async);
+
+	return NULL;
+}
+
+void il_async_destroy(il_async_t *async)
+{
+	il_async_worker_t *w, *next;
+
+	osal_mutex_lock(async->lock);
+	for (w = async->workers; w; w = w->next) {
+		w->stop = 1;
+		osal_cond_signal(w->cond);
+	}
+	osal_mutex_unlock(async->lock);
+
+	for (w = async->workers; w; w = next) {
+		next = w->next;
+
+		osal_thread_join(w->td, NULL);
+		osal_cond_destroy(w->cond);
+		free(w);
+	}
+
+#ifndef _WIN32
+	close(async->fds[0]);
+	close(async->fds[1]);
+#endif
+
+	osal_cond_destroy(async->cond);
+	osal_mutex_destroy(async->lock);
+
+	free(async);
+}
+
+il_async_req_t *il_async_read(il_async_t *async, il_servo_t *servo,
+			      const il_reg_t *reg, const char *id,
+			      il_async_cb_t cb, void *ctx)
+{
+	return req_submit(async, servo, reg, id, 0, 0., 0, cb, ctx);
+}
+
+il_async_req_t *il_async_write(il_async_t *async, il_servo_t *servo,
+			       const il_reg_t *reg, const char *id,
+			       double val, int confirm,
+			       il_async_cb_t cb, void *ctx)
+{
+	return req_submit(async, servo, reg, id, 1, val, confirm, cb, ctx);
+}
+
+int il_async_req_result(il_async_req_t *req, double *val)
+{
+	int r;
+
+	osal_mutex_lock(req->async->lock);
+
+	if (!req->done) {
+		ilerr__set("Request has not completed");
+		r = IL_ESTATE;
+	} else {
+		r = req->r;
+		if (r == 0 && !req->write && val)
+			*val = req->val;
+	}
+
+	osal_mutex_unlock(req->async->lock);
+
+	return r;
+}
+
+void *il_async_req_ctx_get(il_async_req_t *req)
+{
+	return req->ctx;
+}
+
+void il_async_req_release(il_async_req_t *req)
+{
+	il_async_t *async = req->async;
+
+	osal_mutex_lock(async->lock);
+
+	/* drop it from the completion queue if still there */
+	if (req->done && !req->cb) {
+		il_async_req_t *prev = NULL, *curr;
+
+		for (curr = async->head; curr; prev = curr, curr = curr->next) {
+			if (curr != req)
+				continue;
+
+			if (prev)
+				prev->next = curr->next;
+			else
+				async->head = curr->next;
+
+			if (async->tail == curr)
+				async->tail = prev;
+
+			if (!async->head)
+				fd_clear(async);
+
+			/* drop the queue reference too */
+			req_unref(req);
+			break;
+		}
+	}
+
+	req_unref(req);
+
+	osal_mutex_unlock(async->lock);
+}
+
+int il_async_completed_get(il_async_t *async, il_async_req_t **req,
+			   int timeout)
+{
+	osal_mutex_lock(async->lock);
+
+	while (!async->head) {
+		int r;
+
+		if (timeout == 0) {
+			osal_mutex_unlock(async->lock);
+			ilerr__set("No request completed");
+			return IL_ETIMEDOUT;
+		}
+
+		r = osal_cond_wait(async->cond, async->lock,
+				   timeout < 0 ? 0 : timeout);
+		if (r == OSAL_ETIMEDOUT && !async->head) {
+			osal_mutex_unlock(async->lock);
+			ilerr__set("No request completed");
+			return IL_ETIMEDOUT;
+		}
+	}
+
+	*req = async->head;
+	async->head = (*req)->next;
+	if (!async->head) {
+		async->tail = NULL;
+		fd_clear(async);
+	}
+
+	/* the caller keeps its own reference, drop the queue one */
+	req_unref(*req);
+
+	osal_mutex_unlock(async->lock);
+
+	return 0;
+}
+
+int il_async_fd_get(il_async_t *async)
+{
+	if (async->fds[0] < 0) {
+		ilerr__set("Not supported on this platform");
+		return IL_ENOTSUP;
+	}
+
+	return async->fds[0];
+}
@@ -0,0 +1,74 @@
+#ifndef ASYNC_H_
+#define ASYNC_H_
+
+#include "public/ingenialink/async.h"
+
+#include "osal/osal.h"
+
+/** IngeniaLink asynchronous request. */
+struct il_async_req {
+	/** Next request (submission or completion queue). */
+	il_async_req_t *next;
+	/** Associated servo. */
+	il_servo_t *servo;
+	/** Pre-defined register. */
+	const il_reg_t *reg;
+	/** Register ID (copy). */
+	char *id;
+	/** Write flag. */
+	int write;
+	/** Value (read result or value to be written). */
+	double val;
+	/** Confirm write. */
+	int confirm;
+	/** Result. */
+	int r;
+	/** Completion flag. */
+	int done;
+	/** Completion callback. */
+	il_async_cb_t cb;
+	/** Callback context. */
+	void *ctx;
+	/** References (user and library). */
+	int refs;
+	/** Owner. */
+	il_async_t *async;
+};
+
+/** Asynchronous network worker. */
+typedef struct il_async_worker {
+	/** Next worker. */
+	struct il_async_worker *next;
+	/** Owner. */
+	il_async_t *async;
+	/** Served network. */
+	il_net_t *net;
+	/** Submission queue head. */
+	il_async_req_t *head;
+	/** Submission queue tail. */
+	il_async_req_t *tail;
+	/** Submission condition. */
+	osal_cond_t *cond;
+	/** Thread. */
+	osal_thread_t *td;
+	/** Stop flag. */
+	int stop;
+} il_async_worker_t;
+
+/** IngeniaLink asynchronous context. */
+struct il_async {
+	/** Lock (queues and request state). */
+	osal_mutex_t *lock;
+	/** Completion condition. */
+	osal_cond_t *cond;
+	/** Workers (one per network). */
+	il_async_worker_t *workers;
+	/** Completion queue head. */
+	il_async_req_t *head;
+	/** Completion queue tail. */
+	il_async_req_t *tail;
+	/** Notification pipe (read end exposed, -1 if not available). */
+	int fds[2];
+};
+
+#endif
@@ -159,6 +159,7 @@ int il_net_base__init(il_net_t *net, const il_net_opts_t *opts)
 	net->port = strdup(opts->port);
 	net->timeout_rd = opts->timeout_rd;
 	net->timeout_wr = opts->timeout_wr;
+	net->heartbeat_idle = IL_NET_HEARTBEAT_IDLE_DEF;
 
 	/* initialize network lock */
 	net->lock = osal_mutex_create();
@@ -238,6 +239,9 @@ cleanup_init:
 
 void il_net_base__deinit(il_net_t *net)
 {
+	il_net__monitoring_release(net);
+	il_net__disturbance_release(net);
+
 	osal_mutex_destroy(net->emcy_subs.lock);
 	free(net->emcy_subs.subs);
 
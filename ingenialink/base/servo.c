@@ -1,6 +1,11 @@
 #include "../servo.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "ingenialink/err.h"
+#include "ingenialink/mc.h"
+#include "ingenialink/registers.h"
 #ifdef _WIN32
 	#define _WINSOCKAPI_
 	#include <windows.h>
@@ -13,6 +18,11 @@
  * Private
  ******************************************************************************/
 
+void il_servo_base__sw_process(il_servo_t *servo, uint8_t subnode,
+			       uint16_t sw);
+void il_servo_base__emcy_dispatch(il_servo_t *servo);
+int il_servo_base__monitors_start(il_servo_t *servo);
+
 /**
  * Obtain register (pre-defined or from dictionary).
  *
@@ -74,6 +84,7 @@ static int raw_read(il_servo_t *servo, const il_reg_t *reg_pdef,
 {
 	int r;
 	const il_reg_t *reg;
+	uint64_t gen;
 
 	/* obtain register (predefined or from dictionary) */
 	r = get_reg(servo->dict, reg_pdef, id, &reg, subnode);
@@ -90,8 +101,18 @@ static int raw_read(il_servo_t *servo, const il_reg_t *reg_pdef,
 		ilerr__set("Register is write-only");
 		return IL_EACCESS;
 	}
-	Sleep(2);
-	return il_net__read(servo->net, servo->id, reg->subnode, reg->address, buf, sz);
+
+	/* serve from the mirror if possible */
+	if (il_servo_mirror__lookup(&servo->mirror, reg->subnode,
+				    (uint16_t)reg->address, buf, sz, &gen))
+		return 0;
+
+	r = il_net__read(servo->net, servo->id, reg->subnode, reg->address, buf, sz);
+	if (r == 0)
+		il_servo_mirror__fill(&servo->mirror, reg->subnode,
+				      (uint16_t)reg->address, buf, sz, gen);
+
+	return r;
 }
 
 /**
@@ -117,6 +138,7 @@ static int raw_write(il_servo_t *servo, const il_reg_t *reg,
 		     il_reg_dtype_t dtype, const void *data, size_t sz,
 		     int confirmed, uint16_t extended)
 {
+	int r;
 	int confirmed_;
 
 	/* verify register properties */
@@ -133,14 +155,21 @@ static int raw_write(il_servo_t *servo, const il_reg_t *reg,
 	/* skip confirmation on write-only registers */
 	confirmed_ = (reg->access == IL_REG_ACCESS_WO) ? 0 : confirmed;
 
-	return il_net__write(servo->net, servo->id, reg->subnode, reg->address, data, sz,
+	r = il_net__write(servo->net, servo->id, reg->subnode, reg->address, data, sz,
 			     confirmed_, extended);
+
+	/* write-through */
+	il_servo_mirror__written(&servo->mirror, reg->subnode,
+				 (uint16_t)reg->address, data, sz, r);
+
+	return r;
 }
 
 static int raw_wait_write(il_servo_t *servo, const il_reg_t *reg,
 		     il_reg_dtype_t dtype, const void *data, size_t sz,
 		     int confirmed, uint16_t extended)
 {
+	int r;
 	int confirmed_;
 
 	/* verify register properties */
@@ -157,86 +186,299 @@ static int raw_wait_write(il_servo_t *servo, const il_reg_t *reg,
 	/* skip confirmation on write-only registers */
 	confirmed_ = (reg->access == IL_REG_ACCESS_WO) ? 0 : confirmed;
 
-	return il_net__wait_write(servo->net, servo->id, reg->subnode, reg->address, data, sz,
+	r = il_net__wait_write(servo->net, servo->id, reg->subnode, reg->address, data, sz,
 			     confirmed_, extended);
+
+	/* write-through */
+	il_servo_mirror__written(&servo->mirror, reg->subnode,
+				 (uint16_t)reg->address, data, sz, r);
+
+	return r;
 }
 
 
 /**
- * Wait until the statusword changes its value.
+ * Publish a statusword value, waking up waiters if it changed.
  *
  * @param [in] servo
  *	IngeniaLink servo.
- * @param [in, out] sw
- *	Current statusword value, where next value will be stored.
- * @param [in, out] timeout
- *	Timeout (ms), if positive will be updated with remaining ms.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] sw
+ *	Statusword value.
+ */
+static void sw_publish(il_servo_t *servo, uint8_t subnode, uint16_t sw)
+{
+	int changed = 0;
+
+	osal_mutex_lock(servo->sw.lock);
+
+	if (subnode >= 1 && subnode <= STATE_SUBS_SUBNODES_MAX &&
+	    servo->sw.values[subnode - 1] != sw) {
+		servo->sw.values[subnode - 1] = sw;
+		changed = 1;
+	}
+
+	if (servo->sw.value != sw) {
+		servo->sw.value = sw;
+		changed = 1;
+	}
+
+	if (changed)
+		osal_cond_broadcast(servo->sw.changed);
+
+	osal_mutex_unlock(servo->sw.lock);
+}
+
+/**
+ * Read the statusword, publishing its value.
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [out] sw
+ *	Statusword value (last known value if it could not be read).
  *
  * @return
  *	0 on success, error code otherwise.
  */
-static int sw_wait_change(il_servo_t *servo, uint16_t *sw, int *timeout)
+static int sw_read(il_servo_t *servo, uint8_t subnode, uint16_t *sw)
 {
-	int r = 0;
-	osal_timespec_t start = { 0, 0 }, end, diff;
+	il_reg_t reg = IL_REG_MCB_STS_WORD;
+	int r;
 
-	/* obtain start time */
-	if (*timeout > 0) {
-		if (osal_clock_gettime(&start) < 0) {
-			ilerr__set("Could not obtain system time");
-			return IL_EFAIL;
-		}
+	reg.subnode = subnode;
+
+	r = il_servo_raw_read_u16(servo, &reg, NULL, sw);
+	if (r == 0) {
+		sw_publish(servo, subnode, *sw);
+		return 0;
 	}
 
-	/* wait for change */
+	/* fall back to the last known value */
+	osal_mutex_lock(servo->sw.lock);
+	if (subnode >= 1 && subnode <= STATE_SUBS_SUBNODES_MAX)
+		*sw = servo->sw.values[subnode - 1];
+	else
+		*sw = servo->sw.value;
+	osal_mutex_unlock(servo->sw.lock);
+
+	return r;
+}
+
+/**
+ * Wait until the statusword fulfills a condition.
+ *
+ * @note
+ *	Waiters sleep on the statusword condition, so values pushed by the
+ *	state monitor, the connection manager or regular traffic wake them up
+ *	immediately. Unless disabled, the statusword is also read every polling
+ *	period (always for subnodes whose values are not tracked).
+ *
+ * @param [in] servo
+ *	IngeniaLink servo.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] msk
+ *	Statusword mask.
+ * @param [in] val
+ *	Statusword (masked) value.
+ * @param [in] differ
+ *	Wait for the masked statusword to differ from the value instead.
+ * @param [out] sw
+ *	Statusword value fulfilling the condition.
+ * @param [in, out] timeout
+ *	Timeout (ms, <= 0 to wait forever), if positive will be updated with
+ *	remaining ms.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int sw_wait(il_servo_t *servo, uint8_t subnode, uint16_t msk,
+		   uint16_t val, int differ, uint16_t *sw, int *timeout)
+{
+	osal_timespec_t deadline;
+	int tracked, poll, r = 0;
+	uint16_t v;
+
+	tracked = subnode >= 1 && subnode <= STATE_SUBS_SUBNODES_MAX;
+
+	poll = servo->sw.poll;
+	if (!tracked && poll <= 0)
+		poll = IL_SERVO_SW_POLL_DEF;
+
+	if (*timeout > 0)
+		osal_clock_deadline_set(&deadline, (long long)*timeout *
+					OSAL_CLOCK_NANOSPERMSEC);
+
+	/* start from a fresh value */
+	(void)sw_read(servo, subnode, &v);
+
 	osal_mutex_lock(servo->sw.lock);
 
-	if (servo->sw.value == *sw) {
-		r = osal_cond_wait(servo->sw.changed, servo->sw.lock, *timeout);
-		if (r == OSAL_ETIMEDOUT) {
-			ilerr__set("Operation timed out");
-			r = IL_ETIMEDOUT;
-			goto out;
-		} else if (r < 0) {
+	for (;;) {
+		int wait = poll;
+
+		if (tracked)
+			v = servo->sw.values[subnode - 1];
+
+		if (differ ? (v & msk) != val : (v & msk) == val)
+			break;
+
+		if (*timeout > 0) {
+			long long left = osal_clock_deadline_left(&deadline);
+
+			if (left <= 0) {
+				ilerr__set("Operation timed out");
+				r = IL_ETIMEDOUT;
+				break;
+			}
+
+			left = (left + OSAL_CLOCK_NANOSPERMSEC - 1) /
+			       OSAL_CLOCK_NANOSPERMSEC;
+			if (wait <= 0 || left < wait)
+				wait = (int)left;
+		}
+
+		r = osal_cond_wait(servo->sw.changed, servo->sw.lock, wait);
+		if (r == OSAL_ETIMEDOUT && poll > 0) {
+			/* nothing pushed meanwhile, poll */
+			osal_mutex_unlock(servo->sw.lock);
+			(void)sw_read(servo, subnode, &v);
+			osal_mutex_lock(servo->sw.lock);
+		} else if (r < 0 && r != OSAL_ETIMEDOUT) {
 			ilerr__set("Statusword wait change failed");
 			r = IL_EFAIL;
-			goto out;
+			break;
 		}
+
+		r = 0;
 	}
 
-	*sw = servo->sw.value;
+	osal_mutex_unlock(servo->sw.lock);
+
+	if (r < 0)
+		return r;
+
+	*sw = v;
 
-out:
 	/* update timeout */
-	if ((*timeout > 0) && (r == 0)) {
-		/* obtain end time */
-		if (osal_clock_gettime(&end) < 0) {
-			ilerr__set("Could not obtain system time");
-			r = IL_EFAIL;
-			goto unlock;
-		}
+	if (*timeout > 0) {
+		long long left = osal_clock_deadline_left(&deadline);
 
-		/* compute difference */
-		if ((end.ns - start.ns) < 0) {
-			diff.s = end.s - start.s - 1;
-			diff.ns = end.ns - start.ns + OSAL_CLOCK_NANOSPERSEC;
-		} else {
-			diff.s = end.s - start.s;
-			diff.ns = end.ns - start.ns;
+		*timeout = (int)MAX(1, left / OSAL_CLOCK_NANOSPERMSEC);
+	}
+
+	return 0;
+}
+
+/** Group axis transition context. */
+typedef struct {
+	/** Last statusword. */
+	uint16_t sw;
+	/** Fault reset attempts. */
+	int retries;
+	/** Done flag. */
+	int done;
+	/** State change deadline. */
+	osal_timespec_t deadline;
+} group_axis_t;
+
+/**
+ * Write the controlword of a group axis.
+ *
+ * @param [in] axis
+ *	Axis.
+ * @param [in] cmd
+ *	Command.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int group_cw_write(il_servo_axis_t *axis, uint16_t cmd)
+{
+	il_reg_t cw = IL_REG_MCB_CTL_WORD;
+
+	cw.subnode = axis->subnode;
+
+	return il_servo_raw_write_u16(axis->servo, &cw, NULL, cmd, 1, 0);
+}
+
+/**
+ * Advance a group axis towards the goal.
+ *
+ * @note
+ *	The next command is decided from the last statusword, and sent without
+ *	waiting for its effect.
+ *
+ * @param [in, out] axis
+ *	Axis.
+ * @param [in] ctx
+ *	Axis transition context.
+ * @param [in] goal
+ *	Goal.
+ * @param [in] timeout
+ *	Timeout between state changes (ms), a value <= 0 waits forever.
+ */
+static void group_step(il_servo_axis_t *axis, group_axis_t *ctx,
+		       il_servo_group_goal_t goal, int timeout)
+{
+	il_servo_state_t state;
+	uint16_t cmd;
+	int r;
+
+	axis->servo->ops->_state_decode(ctx->sw, &state, NULL);
+
+	if ((state == IL_SERVO_STATE_FAULT) ||
+	    (state == IL_SERVO_STATE_FAULTR)) {
+		if (ctx->retries == GROUP_FAULT_RESET_RETRIES) {
+			ilerr__set("Fault reset failed");
+			axis->r = IL_ESTATE;
+			ctx->done = 1;
+			return;
 		}
 
-		/* update timeout */
-		*timeout -= diff.s * 1000 + diff.ns / OSAL_CLOCK_NANOSPERMSEC;
-		if (*timeout <= 0) {
-			ilerr__set("Operation timed out");
-			r = IL_ETIMEDOUT;
+		/* fault reset acts on the rising edge (0->1) */
+		r = group_cw_write(axis, 0);
+		if (r == 0)
+			r = group_cw_write(axis, IL_MC_PDS_CMD_FR);
+
+		ctx->retries++;
+	} else {
+		if ((goal == SERVO_GROUP_FAULT_RESET) ||
+		    ((goal == SERVO_GROUP_DISABLE) &&
+		     (state == IL_SERVO_STATE_DISABLED)) ||
+		    ((goal == SERVO_GROUP_ENABLE) &&
+		     (state == IL_SERVO_STATE_ENABLED))) {
+			axis->r = 0;
+			ctx->done = 1;
+			return;
 		}
+
+		if ((goal == SERVO_GROUP_DISABLE) ||
+		    (state == IL_SERVO_STATE_NRDY))
+			cmd = IL_MC_PDS_CMD_DV;
+		else if (state == IL_SERVO_STATE_DISABLED)
+			cmd = IL_MC_PDS_CMD_SD;
+		else if (state == IL_SERVO_STATE_RDY)
+			cmd = IL_MC_PDS_CMD_SOEO;
+		else
+			cmd = IL_MC_PDS_CMD_EO;
+
+		r = group_cw_write(axis, cmd);
 	}
 
-unlock:
-	osal_mutex_unlock(servo->sw.lock);
+	if (r < 0) {
+		axis->r = r;
+		ctx->done = 1;
+		return;
+	}
 
-	return r;
+	if (timeout > 0)
+		osal_clock_deadline_set(&ctx->deadline,
+					(long long)timeout *
+					OSAL_CLOCK_NANOSPERMSEC);
 }
 
 /**
@@ -251,13 +493,7 @@ static void sw_update(void *ctx, uint16_t sw)
 {
 	il_servo_t *servo = ctx;
 
-	osal_mutex_lock(servo->sw.lock);
-
-	if (servo->sw.value != sw) {
-		servo->sw.value = sw;
-		osal_cond_broadcast(servo->sw.changed);
-	}
-	osal_mutex_unlock(servo->sw.lock);
+	sw_publish(servo, 1, sw);
 }
 
 /**
@@ -287,48 +523,28 @@ static int state_subs_monitor(void *args)
 		.enums = NULL,
 		.enums_count = 0
 	};
-	il_servo_state_t states[5] = { IL_SERVO_STATE_NRDY, IL_SERVO_STATE_NRDY, IL_SERVO_STATE_NRDY, IL_SERVO_STATE_NRDY, IL_SERVO_STATE_NRDY };
-	Sleep(200);
+	Sleep(STATE_SUBS_PERIOD);
 	while (servo->state_subs.kill != 1) {
 		if (servo->state_subs.stop != 1) {
 			for (uint8_t i = 0; i < servo->subnodes; i++) {
+				int r = 0;
+
 				subnode = i + 1;
 				status_word_register.subnode = subnode;
-				osal_mutex_lock(servo->sw.lock);
-				int r = il_servo_raw_read_u16(servo, &status_word_register, NULL, &sw);
-				if (r < 0) {
-					osal_mutex_unlock(servo->sw.lock);
-				}
-				else {
-					if (servo->sw.value != sw) {
-						servo->sw.value = sw;
-						osal_cond_broadcast(servo->sw.changed);
-					}
-					osal_mutex_unlock(servo->sw.lock);
-					/* obtain state/flags */
-					il_servo_state_t current_state;
-					int flags;
-					servo->ops->_state_decode(sw, &current_state, &flags);
-					if (current_state != states[i]) {
-						states[i] = current_state;
-						/* notify all subscribers */
-						size_t sz;
-						osal_mutex_lock(servo->state_subs.lock);
-						for (sz = 0; sz < servo->state_subs.sz; sz++) {
-							void *ctx;
-							if (!servo->state_subs.subs[sz].cb)
-								continue;
-							ctx = servo->state_subs.subs[sz].ctx;
-							servo->state_subs.subs[sz].cb(ctx, current_state, flags, subnode);
-						}
-
-						osal_mutex_unlock(servo->state_subs.lock);
-					}
-				}
+
+				/* skip the read if traffic carried it recently */
+				if (subnode != 1 ||
+				    !il_net__sw_fresh(servo->net,
+						      STATE_SUBS_PERIOD, &sw))
+					r = il_servo_raw_read_u16(
+						servo, &status_word_register,
+						NULL, &sw);
+				if (r >= 0)
+					il_servo_base__sw_process(servo, subnode, sw);
 			}
-			Sleep(200);
+			Sleep(STATE_SUBS_PERIOD);
 		}
-		Sleep(200);
+		Sleep(STATE_SUBS_PERIOD);
 	}
 
 	return 0;
@@ -377,39 +593,217 @@ static int emcy_subs_monitor(void *args)
 		/* wait until emcy queue not empty */
 		osal_mutex_lock(emcy->lock);
 
-		r = osal_cond_wait(emcy->not_empty, emcy->lock,
-				   EMCY_SUBS_TIMEOUT);
+		r = 0;
+		if (!CIRC_CNT(emcy->head, emcy->tail, emcy->sz))
+			r = osal_cond_wait(emcy->not_empty, emcy->lock,
+					   EMCY_SUBS_TIMEOUT);
+
+		osal_mutex_unlock(emcy->lock);
+
+		if (r == 0)
+			il_servo_base__emcy_dispatch(servo);
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Internal
+ ******************************************************************************/
+
+void il_servo_base__sw_process(il_servo_t *servo, uint8_t subnode,
+			       uint16_t sw)
+{
+	il_servo_state_subscriber_lst_t *state_subs = &servo->state_subs;
+	il_servo_state_t state;
+	int flags;
+	size_t i;
+
+	sw_publish(servo, subnode, sw);
 
-		if (r == 0) {
-			/* process all available emergencies */
-			while (CIRC_CNT(emcy->head, emcy->tail, emcy->sz)) {
-				size_t i;
-				uint32_t code;
+	if (subnode < 1 || subnode > STATE_SUBS_SUBNODES_MAX ||
+	    state_subs->stop == 1)
+		return;
+
+	/* notify all subscribers on state changes */
+	servo->ops->_state_decode(sw, &state, &flags);
+	if (state == state_subs->states[subnode - 1])
+		return;
+
+	state_subs->states[subnode - 1] = state;
+
+	osal_mutex_lock(state_subs->lock);
+
+	for (i = 0; i < state_subs->sz; i++) {
+		if (!state_subs->subs[i].cb)
+			continue;
+
+		state_subs->subs[i].cb(state_subs->subs[i].ctx, state, flags,
+				       subnode);
+	}
+
+	osal_mutex_unlock(state_subs->lock);
+}
+
+int il_servo_base__sw_read(il_servo_t *servo, uint8_t subnode, uint16_t *sw)
+{
+	return sw_read(servo, subnode, sw);
+}
+
+int il_servo_base__sw_wait_change(il_servo_t *servo, uint8_t subnode,
+				  uint16_t *sw, int *timeout)
+{
+	return sw_wait(servo, subnode, 0xFFFF, *sw, 1, sw, timeout);
+}
 
-				code = emcy->queue[emcy->tail];
-				emcy->tail = (emcy->tail + 1) & (emcy->sz - 1);
+int il_servo_base__sw_wait_value(il_servo_t *servo, uint8_t subnode,
+				 uint16_t msk, uint16_t val, int timeout)
+{
+	uint16_t sw;
 
-				osal_mutex_unlock(emcy->lock);
+	return sw_wait(servo, subnode, msk, val, 0, &sw, &timeout);
+}
 
-				/* notify all subscribers */
-				osal_mutex_lock(emcy_subs->lock);
+int il_servo_base__group_transition(il_servo_axis_t *axes, size_t n,
+				    il_servo_group_goal_t goal, int timeout)
+{
+	group_axis_t *ctx;
+	size_t i, left = n;
+	int r = 0;
 
-				for (i = 0; i < emcy_subs->sz; i++) {
-					void *ctx;
+	if (n == 0)
+		return 0;
 
-					if (!emcy_subs->subs[i].cb)
-						continue;
+	ctx = calloc(n, sizeof(*ctx));
+	if (!ctx) {
+		ilerr__set("Group context allocation failed");
+		return IL_ENOMEM;
+	}
 
-					ctx = emcy_subs->subs[i].ctx;
-					emcy_subs->subs[i].cb(ctx, code);
-				}
+	/* command all axes before waiting for any of them */
+	for (i = 0; i < n; i++) {
+		axes[i].r = 0;
+		(void)sw_read(axes[i].servo, axes[i].subnode, &ctx[i].sw);
+		group_step(&axes[i], &ctx[i], goal, timeout);
+		if (ctx[i].done)
+			left--;
+	}
 
-				osal_mutex_unlock(emcy_subs->lock);
-				osal_mutex_lock(emcy->lock);
+	/* check statuswords in turns, advancing axes as they change */
+	while (left > 0) {
+		int progress = 0;
+
+		for (i = 0; i < n; i++) {
+			uint16_t sw;
+
+			if (ctx[i].done)
+				continue;
+
+			(void)sw_read(axes[i].servo, axes[i].subnode, &sw);
+			if (sw != ctx[i].sw) {
+				ctx[i].sw = sw;
+				group_step(&axes[i], &ctx[i], goal, timeout);
+				progress = 1;
+			} else if ((timeout > 0) &&
+				   (osal_clock_deadline_left(&ctx[i].deadline) <=
+				    0)) {
+				ilerr__set("State change timed out");
+				axes[i].r = IL_ETIMEDOUT;
+				ctx[i].done = 1;
 			}
+
+			if (ctx[i].done)
+				left--;
 		}
 
+		if (left > 0 && !progress)
+			osal_clock_sleep_ms(GROUP_POLL);
+	}
+
+	free(ctx);
+
+	for (i = 0; i < n; i++) {
+		if (axes[i].r < 0) {
+			r = axes[i].r;
+			break;
+		}
+	}
+
+	return r;
+}
+
+void il_servo_base__emcy_dispatch(il_servo_t *servo)
+{
+	il_servo_emcy_t *emcy = &servo->emcy;
+	il_servo_emcy_subscriber_lst_t *emcy_subs = &servo->emcy_subs;
+
+	osal_mutex_lock(emcy->lock);
+
+	/* process all available emergencies */
+	while (CIRC_CNT(emcy->head, emcy->tail, emcy->sz)) {
+		size_t i;
+		uint32_t code;
+
+		code = emcy->queue[emcy->tail];
+		emcy->tail = (emcy->tail + 1) & (emcy->sz - 1);
+
 		osal_mutex_unlock(emcy->lock);
+
+		/* notify all subscribers */
+		osal_mutex_lock(emcy_subs->lock);
+
+		for (i = 0; i < emcy_subs->sz; i++) {
+			void *ctx;
+
+			if (!emcy_subs->subs[i].cb)
+				continue;
+
+			ctx = emcy_subs->subs[i].ctx;
+			emcy_subs->subs[i].cb(ctx, code);
+		}
+
+		osal_mutex_unlock(emcy_subs->lock);
+		osal_mutex_lock(emcy->lock);
+	}
+
+	osal_mutex_unlock(emcy->lock);
+}
+
+void il_servo_base__monitors_stop(il_servo_t *servo)
+{
+	if (servo->state_subs.monitor) {
+		servo->state_subs.kill = 1;
+		(void)osal_thread_join(servo->state_subs.monitor, NULL);
+		servo->state_subs.monitor = NULL;
+	}
+
+	if (servo->emcy_subs.monitor) {
+		servo->emcy_subs.stop = 1;
+		(void)osal_thread_join(servo->emcy_subs.monitor, NULL);
+		servo->emcy_subs.monitor = NULL;
+	}
+}
+
+int il_servo_base__monitors_start(il_servo_t *servo)
+{
+	if (!servo->state_subs.monitor) {
+		servo->state_subs.kill = 0;
+		servo->state_subs.monitor = osal_thread_create_(
+			state_subs_monitor, servo);
+		if (!servo->state_subs.monitor) {
+			ilerr__set("State change monitor could not be created");
+			return IL_EFAIL;
+		}
+	}
+
+	if (!servo->emcy_subs.monitor) {
+		servo->emcy_subs.stop = 0;
+		servo->emcy_subs.monitor = osal_thread_create_(
+			emcy_subs_monitor, servo);
+		if (!servo->emcy_subs.monitor) {
+			ilerr__set("Emergency monitor could not be created");
+			return IL_EFAIL;
+		}
 	}
 
 	return 0;
@@ -423,6 +817,7 @@ int il_servo_base__init(il_servo_t *servo, il_net_t *net, uint16_t id,
 			const char *dict)
 {
 	int r;
+	size_t i;
 
 	/* initialize */
 	servo->net = net;
@@ -470,6 +865,8 @@ int il_servo_base__init(il_servo_t *servo, il_net_t *net, uint16_t id,
 	}
 
 	servo->sw.value = 0;
+	memset(servo->sw.values, 0, sizeof(servo->sw.values));
+	servo->sw.poll = IL_SERVO_SW_POLL_DEF;
 
 	r = il_net__sw_subscribe(servo->net, servo->id, sw_update, servo);
 	if (r < 0)
@@ -497,6 +894,8 @@ int il_servo_base__init(il_servo_t *servo, il_net_t *net, uint16_t id,
 
 	servo->state_subs.kill = 0;
 	servo->state_subs.stop = 1;
+	for (i = 0; i < STATE_SUBS_SUBNODES_MAX; i++)
+		servo->state_subs.states[i] = IL_SERVO_STATE_NRDY;
 
 	servo->state_subs.monitor = osal_thread_create_(state_subs_monitor,
 		servo);
@@ -557,8 +956,17 @@ int il_servo_base__init(il_servo_t *servo, il_net_t *net, uint16_t id,
 		goto cleanup_emcy_subs_lock;
 	}
 
+	/* configure register mirror (disabled) */
+	r = il_servo_mirror__init(&servo->mirror);
+	if (r < 0)
+		goto cleanup_emcy_subs_monitor;
+
 	return 0;
 
+cleanup_emcy_subs_monitor:
+	servo->emcy_subs.stop = 1;
+	(void)osal_thread_join(servo->emcy_subs.monitor, NULL);
+
 cleanup_emcy_subs_lock:
 	osal_mutex_destroy(servo->emcy_subs.lock);
 
@@ -609,7 +1017,10 @@ cleanup_net:
 
 void il_servo_base__deinit(il_servo_t *servo)
 {
-	servo->emcy_subs.stop = 1;
+	il_servo_base__monitors_stop(servo);
+
+	il_servo_mirror__deinit(&servo->mirror);
+
 	osal_mutex_destroy(servo->emcy_subs.lock);
 	free(servo->emcy_subs.subs);
 
@@ -617,9 +1028,6 @@ void il_servo_base__deinit(il_servo_t *servo)
 	osal_cond_destroy(servo->emcy.not_empty);
 	osal_mutex_destroy(servo->emcy.lock);
 
-	servo->state_subs.stop = 1;
-	servo->state_subs.kill = 1;
-	(void)osal_thread_join(servo->state_subs.monitor, NULL);
 	osal_mutex_destroy(servo->state_subs.lock);
 	free(servo->state_subs.subs);
 
@@ -653,9 +1061,7 @@ void il_servo_base__state_get(il_servo_t *servo, il_servo_state_t *state,
 		.enums = NULL,
 		.enums_count = 0
 	};
-	osal_mutex_lock(servo->sw.lock);
 	int r = il_servo_raw_read_u16(servo, &status_word_register, NULL, &sw);
-	osal_mutex_unlock(servo->sw.lock);
 
 	servo->ops->_state_decode(sw, state, flags);
 }
@@ -1334,3 +1740,963 @@ int il_servo_base__write(il_servo_t *servo, const il_reg_t *reg, const char *id,
 		return IL_EINVAL;
 	}
 }
+
+/**
+ * Convert a raw (wire) value to double.
+ *
+ * @param [in] dtype
+ *	Data type.
+ * @param [in] raw
+ *	Raw value.
+ *
+ * @return
+ *	Value.
+ */
+static double raw_to_double(il_reg_dtype_t dtype, const il_reg_value_t *raw)
+{
+	switch (dtype) {
+	case IL_REG_DTYPE_U8:
+		return (double)raw->u8;
+	case IL_REG_DTYPE_S8:
+		return (double)raw->s8;
+	case IL_REG_DTYPE_U16:
+		return (double)__swap_be_16(raw->u16);
+	case IL_REG_DTYPE_S16:
+		return (double)(int16_t)__swap_be_16(raw->s16);
+	case IL_REG_DTYPE_U32:
+	case IL_REG_DTYPE_STR:
+		return (double)__swap_be_32(raw->u32);
+	case IL_REG_DTYPE_S32:
+		return (double)(int32_t)__swap_be_32(raw->s32);
+	case IL_REG_DTYPE_U64:
+		return (double)__swap_be_64(raw->u64);
+	case IL_REG_DTYPE_S64:
+		return (double)(int64_t)__swap_be_64(raw->s64);
+	case IL_REG_DTYPE_FLOAT:
+		return (double)__swap_be_float(raw->flt);
+	case IL_REG_DTYPE_FLOAT64: {
+		uint64_t u64 = __swap_be_64(raw->u64);
+		double dbl;
+
+		memcpy(&dbl, &u64, sizeof(dbl));
+		return dbl;
+	}
+	default:
+		return 0.;
+	}
+}
+
+/**
+ * Convert a double to a raw (wire) value, checking the register range.
+ *
+ * @param [in] reg
+ *	Register.
+ * @param [in] val
+ *	Value.
+ * @param [out] raw
+ *	Raw value.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int double_to_raw(const il_reg_t *reg, double val, il_reg_value_t *raw)
+{
+	int in_range;
+
+	switch (reg->dtype) {
+	case IL_REG_DTYPE_U8:
+		raw->u8 = (uint8_t)val;
+		in_range = (raw->u8 >= reg->range.min.u8) &&
+			   (raw->u8 <= reg->range.max.u8);
+		break;
+	case IL_REG_DTYPE_S8:
+		raw->s8 = (int8_t)val;
+		in_range = (raw->s8 >= reg->range.min.s8) &&
+			   (raw->s8 <= reg->range.max.s8);
+		break;
+	case IL_REG_DTYPE_U16:
+		raw->u16 = (uint16_t)val;
+		in_range = (raw->u16 >= reg->range.min.u16) &&
+			   (raw->u16 <= reg->range.max.u16);
+		raw->u16 = __swap_be_16(raw->u16);
+		break;
+	case IL_REG_DTYPE_S16:
+		raw->s16 = (int16_t)val;
+		in_range = (raw->s16 >= reg->range.min.s16) &&
+			   (raw->s16 <= reg->range.max.s16);
+		raw->s16 = (int16_t)__swap_be_16(raw->s16);
+		break;
+	case IL_REG_DTYPE_U32:
+		raw->u32 = (uint32_t)val;
+		in_range = (raw->u32 >= reg->range.min.u32) &&
+			   (raw->u32 <= reg->range.max.u32);
+		raw->u32 = __swap_be_32(raw->u32);
+		break;
+	case IL_REG_DTYPE_S32:
+		raw->s32 = (int32_t)val;
+		in_range = (raw->s32 >= reg->range.min.s32) &&
+			   (raw->s32 <= reg->range.max.s32);
+		raw->s32 = (int32_t)__swap_be_32(raw->s32);
+		break;
+	case IL_REG_DTYPE_U64:
+		raw->u64 = (uint64_t)val;
+		in_range = (raw->u64 >= reg->range.min.u64) &&
+			   (raw->u64 <= reg->range.max.u64);
+		raw->u64 = __swap_be_64(raw->u64);
+		break;
+	case IL_REG_DTYPE_S64:
+		raw->s64 = (int64_t)val;
+		in_range = (raw->s64 >= reg->range.min.s64) &&
+			   (raw->s64 <= reg->range.max.s64);
+		raw->s64 = (int64_t)__swap_be_64(raw->s64);
+		break;
+	case IL_REG_DTYPE_FLOAT:
+		raw->flt = __swap_be_float((float)val);
+		in_range = 1;
+		break;
+	case IL_REG_DTYPE_FLOAT64:
+		memcpy(&raw->u64, &val, sizeof(val));
+		raw->u64 = __swap_be_64(raw->u64);
+		in_range = 1;
+		break;
+	default:
+		ilerr__set("Unsupported register data type");
+		return IL_EINVAL;
+	}
+
+	if (!in_range) {
+		ilerr__set("Value out of range");
+		return IL_EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * Swap a raw (wire) value to host byte order and vice versa.
+ *
+ * @param [in] dtype
+ *	Data type.
+ * @param [in, out] raw
+ *	Value.
+ */
+static void raw_swap(il_reg_dtype_t dtype, il_reg_value_t *raw)
+{
+	switch (il_reg__dtype_sz(dtype)) {
+	case sizeof(uint16_t):
+		raw->u16 = __swap_be_16(raw->u16);
+		break;
+	case sizeof(uint32_t):
+		raw->u32 = __swap_be_32(raw->u32);
+		break;
+	case sizeof(uint64_t):
+		raw->u64 = __swap_be_64(raw->u64);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Convert a storage (host) value to a raw (wire) value, checking the register
+ * range.
+ *
+ * @param [in] reg
+ *	Register.
+ * @param [out] raw
+ *	Raw value.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int storage_to_raw(const il_reg_t *reg, il_reg_value_t *raw)
+{
+	const il_reg_value_t *val = &reg->storage;
+	int in_range;
+
+	switch (reg->dtype) {
+	case IL_REG_DTYPE_U8:
+		in_range = (val->u8 >= reg->range.min.u8) &&
+			   (val->u8 <= reg->range.max.u8);
+		break;
+	case IL_REG_DTYPE_S8:
+		in_range = (val->s8 >= reg->range.min.s8) &&
+			   (val->s8 <= reg->range.max.s8);
+		break;
+	case IL_REG_DTYPE_U16:
+		in_range = (val->u16 >= reg->range.min.u16) &&
+			   (val->u16 <= reg->range.max.u16);
+		break;
+	case IL_REG_DTYPE_S16:
+		in_range = (val->s16 >= reg->range.min.s16) &&
+			   (val->s16 <= reg->range.max.s16);
+		break;
+	case IL_REG_DTYPE_U32:
+		in_range = (val->u32 >= reg->range.min.u32) &&
+			   (val->u32 <= reg->range.max.u32);
+		break;
+	case IL_REG_DTYPE_S32:
+		in_range = (val->s32 >= reg->range.min.s32) &&
+			   (val->s32 <= reg->range.max.s32);
+		break;
+	case IL_REG_DTYPE_U64:
+		in_range = (val->u64 >= reg->range.min.u64) &&
+			   (val->u64 <= reg->range.max.u64);
+		break;
+	case IL_REG_DTYPE_S64:
+		in_range = (val->s64 >= reg->range.min.s64) &&
+			   (val->s64 <= reg->range.max.s64);
+		break;
+	case IL_REG_DTYPE_FLOAT:
+	case IL_REG_DTYPE_FLOAT64:
+		in_range = 1;
+		break;
+	default:
+		ilerr__set("Unsupported register data type");
+		return IL_EINVAL;
+	}
+
+	if (!in_range) {
+		ilerr__set("Storage value out of range");
+		return IL_EINVAL;
+	}
+
+	*raw = *val;
+	raw_swap(reg->dtype, raw);
+
+	return 0;
+}
+
+/**
+ * Transfer multiple register accesses as a single network batch.
+ *
+ * @param [in] servo
+ *	Servo.
+ * @param [in, out] accs
+ *	Register accesses.
+ * @param [in] n
+ *	Number of accesses.
+ * @param [in] write
+ *	Write (1) or read (0).
+ *
+ * @return
+ *	0 on success, first error code otherwise.
+ */
+static int access_many(il_servo_t *servo, il_servo_access_t *accs, size_t n,
+		       int write)
+{
+	int r = 0;
+	il_net_req_t *reqs;
+	il_reg_value_t *raws;
+	const il_reg_t **regs;
+	uint64_t *gens;
+	size_t *idx;
+	size_t i, cnt = 0;
+
+	if (n == 0)
+		return 0;
+
+	reqs = malloc(n * sizeof(*reqs));
+	if (!reqs) {
+		ilerr__set("Requests allocation failed");
+		return IL_ENOMEM;
+	}
+
+	raws = malloc(n * sizeof(*raws));
+	if (!raws) {
+		ilerr__set("Values allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_reqs;
+	}
+
+	regs = malloc(n * sizeof(*regs));
+	if (!regs) {
+		ilerr__set("Registers allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_raws;
+	}
+
+	idx = malloc(n * sizeof(*idx));
+	if (!idx) {
+		ilerr__set("Index allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_regs;
+	}
+
+	gens = malloc(n * sizeof(*gens));
+	if (!gens) {
+		ilerr__set("Generations allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_idx;
+	}
+
+	/* resolve and validate every access, only valid ones are sent */
+	for (i = 0; i < n; i++) {
+		il_servo_access_t *acc = &accs[i];
+		const il_reg_t *reg;
+		size_t sz;
+
+		acc->r = get_reg(servo->dict, acc->reg, acc->id, &reg,
+				 acc->subnode);
+		if (acc->r < 0)
+			continue;
+
+		sz = il_reg__dtype_sz(reg->dtype);
+		if (sz == 0) {
+			ilerr__set("Unsupported register data type");
+			acc->r = IL_EINVAL;
+			continue;
+		}
+
+		if (write && reg->access == IL_REG_ACCESS_RO) {
+			ilerr__set("Register is read-only");
+			acc->r = IL_EACCESS;
+			continue;
+		}
+
+		if (!write && reg->access == IL_REG_ACCESS_WO) {
+			ilerr__set("Register is write-only");
+			acc->r = IL_EACCESS;
+			continue;
+		}
+
+		raws[cnt].u64 = 0;
+		gens[cnt] = 0;
+		if (write) {
+			acc->r = double_to_raw(reg, acc->val, &raws[cnt]);
+			if (acc->r < 0)
+				continue;
+		} else if (il_servo_mirror__lookup(&servo->mirror,
+						   reg->subnode,
+						   (uint16_t)reg->address,
+						   &raws[cnt], sz,
+						   &gens[cnt])) {
+			/* served from the mirror */
+			acc->val = raw_to_double(reg->dtype, &raws[cnt]);
+			continue;
+		}
+
+		regs[cnt] = reg;
+		idx[cnt] = i;
+
+		reqs[cnt].id = servo->id;
+		reqs[cnt].subnode = reg->subnode;
+		reqs[cnt].address = (uint16_t)reg->address;
+		reqs[cnt].buf = &raws[cnt];
+		reqs[cnt].sz = sz;
+		reqs[cnt].write = write;
+		reqs[cnt].r = 0;
+
+		cnt++;
+	}
+
+	if (cnt > 0)
+		(void)il_net__transfer(servo->net, reqs, cnt);
+
+	for (i = 0; i < cnt; i++) {
+		il_servo_access_t *acc = &accs[idx[i]];
+
+		acc->r = reqs[i].r;
+		if (write) {
+			il_servo_mirror__written(&servo->mirror,
+						 reqs[i].subnode,
+						 reqs[i].address, &raws[i],
+						 reqs[i].sz, acc->r);
+		} else if (acc->r == 0) {
+			il_servo_mirror__fill(&servo->mirror, reqs[i].subnode,
+					      reqs[i].address, &raws[i],
+					      reqs[i].sz, gens[i]);
+			acc->val = raw_to_double(regs[i]->dtype, &raws[i]);
+		}
+	}
+
+	/* report the first failure in request order */
+	for (i = 0; i < n; i++) {
+		if (accs[i].r < 0) {
+			r = accs[i].r;
+			break;
+		}
+	}
+
+	free(gens);
+
+cleanup_idx:
+	free(idx);
+
+cleanup_regs:
+	free(regs);
+
+cleanup_raws:
+	free(raws);
+
+cleanup_reqs:
+	free(reqs);
+
+	return r;
+}
+
+int il_servo_base__read_many(il_servo_t *servo, il_servo_access_t *accs,
+			     size_t n)
+{
+	return access_many(servo, accs, n, 0);
+}
+
+int il_servo_base__write_many(il_servo_t *servo, il_servo_access_t *accs,
+			      size_t n)
+{
+	return access_many(servo, accs, n, 1);
+}
+
+int il_servo_base__dict_storage_read(il_servo_t *servo,
+				     il_servo_progress_cb_t cb, void *ctx)
+{
+	int r = 0;
+	const char ***ids;
+	size_t *cnts;
+	il_dict_storage_t *items;
+	const il_reg_t **regs;
+	il_net_req_t *reqs;
+	size_t i, j, row, rows = 0, n = 0, ok = 0, done, subnodes;
+
+	if (!servo->dict) {
+		ilerr__set("No dictionary loaded");
+		return IL_EFAIL;
+	}
+
+	/* axes available at the servo + subnode of general parameters */
+	subnodes = (size_t)MIN(servo->subnodes + 1,
+			       il_dict_subnodes_get(servo->dict));
+
+	ids = calloc(subnodes, sizeof(*ids));
+	if (!ids) {
+		ilerr__set("Register IDs allocation failed");
+		return IL_ENOMEM;
+	}
+
+	cnts = calloc(subnodes, sizeof(*cnts));
+	if (!cnts) {
+		ilerr__set("Register counts allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_ids;
+	}
+
+	for (j = 0; j < subnodes; j++) {
+		ids[j] = il_dict_reg_ids_get(servo->dict, (uint8_t)j);
+		if (!ids[j]) {
+			r = IL_EFAIL;
+			goto cleanup_lists;
+		}
+
+		while (ids[j][cnts[j]])
+			cnts[j]++;
+
+		rows = MAX(rows, cnts[j]);
+		n += cnts[j];
+	}
+
+	if (n == 0)
+		goto cleanup_lists;
+
+	items = malloc(n * sizeof(*items));
+	if (!items) {
+		ilerr__set("Storage values allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_lists;
+	}
+
+	regs = malloc(n * sizeof(*regs));
+	if (!regs) {
+		ilerr__set("Registers allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_items;
+	}
+
+	reqs = malloc(n * sizeof(*reqs));
+	if (!reqs) {
+		ilerr__set("Requests allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_regs;
+	}
+
+	/* interleave subnodes, so that their registers are read side by side */
+	n = 0;
+	for (row = 0; row < rows; row++) {
+		for (j = 0; j < subnodes; j++) {
+			const il_reg_t *reg;
+			size_t sz;
+
+			if (row >= cnts[j])
+				continue;
+
+			if (il_dict_reg_get(servo->dict, ids[j][row], &reg,
+					    (uint8_t)j) < 0)
+				continue;
+
+			if (reg->access != IL_REG_ACCESS_RW)
+				continue;
+
+			sz = il_reg__dtype_sz(reg->dtype);
+			if (sz == 0)
+				continue;
+
+			items[n].id = ids[j][row];
+			items[n].subnode = (uint8_t)j;
+			items[n].storage.u64 = 0;
+			regs[n] = reg;
+
+			reqs[n].id = servo->id;
+			reqs[n].subnode = reg->subnode;
+			reqs[n].address = (uint16_t)reg->address;
+			reqs[n].buf = &items[n].storage;
+			reqs[n].sz = sz;
+			reqs[n].write = 0;
+			reqs[n].r = 0;
+
+			n++;
+		}
+	}
+
+	/* read in pipelined batches */
+	for (done = 0; done < n;) {
+		size_t chunk = MIN(n - done, STORAGE_CHUNK);
+
+		(void)il_net__transfer(servo->net, &reqs[done], chunk);
+		done += chunk;
+
+		if (cb)
+			cb(ctx, done, n);
+	}
+
+	/* keep values read (in host order), store all of them at once */
+	for (i = 0; i < n; i++) {
+		if (reqs[i].r < 0) {
+			if (r == 0)
+				r = reqs[i].r;
+			continue;
+		}
+
+		raw_swap(regs[i]->dtype, &items[i].storage);
+		items[ok++] = items[i];
+	}
+
+	/* unreadable registers are skipped unless nothing could be read */
+	if (ok > 0)
+		r = il_dict_reg_storage_update_many(servo->dict, items, ok);
+
+	free(reqs);
+
+cleanup_regs:
+	free(regs);
+
+cleanup_items:
+	free(items);
+
+cleanup_lists:
+	for (j = 0; j < subnodes; j++) {
+		if (ids[j])
+			il_dict_reg_ids_destroy(ids[j]);
+	}
+
+	free(cnts);
+
+cleanup_ids:
+	free(ids);
+
+	return r;
+}
+
+int il_servo_base__dict_storage_restore(il_servo_t *servo, il_dict_t *cfg,
+					int subnode,
+					il_servo_restore_report_t **report)
+{
+	int r = 0;
+	il_servo_restore_entry_t *entries;
+	const il_reg_t **regs;
+	il_reg_value_t *vals;
+	il_net_req_t *reqs;
+	size_t *idx;
+	size_t i, n = 0, m, done, total = 0, written = 0, skipped = 0;
+	int j, subnodes, src;
+
+	/* axes available at the servo + subnode of general parameters */
+	subnodes = servo->subnodes + 1;
+
+	for (j = 0; j < subnodes; j++) {
+		if (subnode == -1 || j == subnode) {
+			src = (subnode == -1) ? j :
+				il_servo_dict_get_subnode(servo, cfg, subnode);
+			if (src >= 0 && src < il_dict_subnodes_get(cfg))
+				total += il_dict_reg_cnt(cfg, (uint8_t)src);
+		}
+	}
+
+	entries = calloc(MAX(total, 1), sizeof(*entries));
+	if (!entries) {
+		ilerr__set("Report allocation failed");
+		return IL_ENOMEM;
+	}
+
+	regs = malloc(MAX(total, 1) * sizeof(*regs));
+	if (!regs) {
+		ilerr__set("Registers allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_entries;
+	}
+
+	vals = malloc(MAX(total, 1) * sizeof(*vals));
+	if (!vals) {
+		ilerr__set("Values allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_regs;
+	}
+
+	reqs = malloc(MAX(total, 1) * sizeof(*reqs));
+	if (!reqs) {
+		ilerr__set("Requests allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_vals;
+	}
+
+	idx = malloc(MAX(total, 1) * sizeof(*idx));
+	if (!idx) {
+		ilerr__set("Index allocation failed");
+		r = IL_ENOMEM;
+		goto cleanup_reqs;
+	}
+
+	/* collect RW registers holding a storage value */
+	for (j = 0; j < subnodes; j++) {
+		const char **ids;
+
+		if (subnode != -1 && j != subnode)
+			continue;
+
+		src = (subnode == -1) ? j :
+			il_servo_dict_get_subnode(servo, cfg, subnode);
+		if (src < 0 || src >= il_dict_subnodes_get(cfg))
+			continue;
+
+		ids = il_dict_reg_ids_get(cfg, (uint8_t)src);
+		if (!ids) {
+			r = IL_EFAIL;
+			goto cleanup_idx;
+		}
+
+		for (i = 0; ids[i] && n < total; i++) {
+			const il_reg_t *reg;
+
+			if (il_dict_reg_get(cfg, ids[i], &reg, (uint8_t)src) < 0)
+				continue;
+
+			/* strings are not restored (as before batching) */
+			if (reg->access != IL_REG_ACCESS_RW ||
+			    !reg->storage_valid ||
+			    reg->dtype == IL_REG_DTYPE_STR ||
+			    il_reg__dtype_sz(reg->dtype) == 0)
+				continue;
+
+			entries[n].id = ids[i];
+			entries[n].subnode = (uint8_t)j;
+			regs[n] = reg;
+			n++;
+		}
+
+		il_dict_reg_ids_destroy(ids);
+	}
+
+	/* current values: fresh mirror values first, batched reads otherwise */
+	for (i = 0, m = 0; i < n; i++) {
+		uint64_t gen;
+
+		entries[i].status = IL_SERVO_RESTORE_WRITTEN;
+		vals[i].u64 = 0;
+
+		if (il_servo_mirror__lookup(&servo->mirror, entries[i].subnode,
+					    (uint16_t)regs[i]->address,
+					    &vals[i], il_reg__dtype_sz(regs[i]->dtype),
+					    &gen)) {
+			entries[i].status = IL_SERVO_RESTORE_SKIPPED;
+			continue;
+		}
+
+		reqs[m].id = servo->id;
+		reqs[m].subnode = entries[i].subnode;
+		reqs[m].address = (uint16_t)regs[i]->address;
+		reqs[m].buf = &vals[i];
+		reqs[m].sz = il_reg__dtype_sz(regs[i]->dtype);
+		reqs[m].write = 0;
+		reqs[m].r = 0;
+		idx[m] = i;
+		m++;
+	}
+
+	for (done = 0; done < m; done += MIN(m - done, STORAGE_CHUNK))
+		(void)il_net__transfer(servo->net, &reqs[done],
+				       MIN(m - done, STORAGE_CHUNK));
+
+	for (i = 0; i < m; i++) {
+		if (reqs[i].r == 0)
+			entries[idx[i]].status = IL_SERVO_RESTORE_SKIPPED;
+	}
+
+	/* write values that differ (or could not be read), compared and sent
+	 * in wire order */
+	for (i = 0, m = 0; i < n; i++) {
+		size_t sz = il_reg__dtype_sz(regs[i]->dtype);
+		il_reg_value_t raw;
+
+		raw.u64 = 0;
+		entries[i].r = storage_to_raw(regs[i], &raw);
+		if (entries[i].r < 0) {
+			entries[i].status = IL_SERVO_RESTORE_FAILED;
+			if (r == 0)
+				r = entries[i].r;
+			continue;
+		}
+
+		if (entries[i].status == IL_SERVO_RESTORE_SKIPPED &&
+		    memcmp(&vals[i], &raw, sz) == 0) {
+			skipped++;
+			continue;
+		}
+
+		entries[i].status = IL_SERVO_RESTORE_WRITTEN;
+		vals[i] = raw;
+
+		reqs[m].id = servo->id;
+		reqs[m].subnode = entries[i].subnode;
+		reqs[m].address = (uint16_t)regs[i]->address;
+		reqs[m].buf = &vals[i];
+		reqs[m].sz = sz;
+		reqs[m].write = 1;
+		reqs[m].r = 0;
+		idx[m] = i;
+		m++;
+	}
+
+	for (done = 0; done < m; done += MIN(m - done, STORAGE_CHUNK))
+		(void)il_net__transfer(servo->net, &reqs[done],
+				       MIN(m - done, STORAGE_CHUNK));
+
+	for (i = 0; i < m; i++) {
+		il_servo_restore_entry_t *entry = &entries[idx[i]];
+
+		il_servo_mirror__written(&servo->mirror, reqs[i].subnode,
+					 reqs[i].address, reqs[i].buf,
+					 reqs[i].sz, reqs[i].r);
+
+		entry->r = reqs[i].r;
+		if (entry->r < 0) {
+			entry->status = IL_SERVO_RESTORE_FAILED;
+			if (r == 0)
+				r = entry->r;
+		} else {
+			written++;
+		}
+	}
+
+	if (report) {
+		*report = malloc(sizeof(**report));
+		if (!*report) {
+			ilerr__set("Report allocation failed");
+			r = IL_ENOMEM;
+			goto cleanup_idx;
+		}
+
+		(*report)->entries = entries;
+		(*report)->n = n;
+		(*report)->written = written;
+		(*report)->skipped = skipped;
+		(*report)->failed = n - written - skipped;
+		entries = NULL;
+	}
+
+cleanup_idx:
+	free(idx);
+
+cleanup_reqs:
+	free(reqs);
+
+cleanup_vals:
+	free(vals);
+
+cleanup_regs:
+	free(regs);
+
+cleanup_entries:
+	free(entries);
+
+	return r;
+}
+
+il_reg_handle_t *il_servo_base__reg_handle_create(il_servo_t *servo,
+						  const il_reg_t *reg,
+						  const char *id,
+						  uint8_t subnode)
+{
+	il_reg_handle_t *handle;
+	const il_reg_t *reg_;
+	double factor;
+	size_t sz;
+
+	if (get_reg(servo->dict, reg, id, &reg_, subnode) < 0)
+		return NULL;
+
+	sz = il_reg__dtype_sz(reg_->dtype);
+	if (sz == 0) {
+		ilerr__set("Unsupported register data type");
+		return NULL;
+	}
+
+	handle = malloc(sizeof(*handle));
+	if (!handle) {
+		ilerr__set("Register handle allocation failed");
+		return NULL;
+	}
+
+	memcpy(&handle->reg, reg_, sizeof(*reg_));
+	handle->sz = sz;
+
+	/* native units if the servo does not provide a factor */
+	factor = il_servo_units_factor(servo, reg_);
+	handle->factor = (factor > 0.) ? factor : 1.;
+
+	handle->servo = servo;
+	il_servo__retain(handle->servo);
+
+	return handle;
+}
+
+void il_servo_base__reg_handle_destroy(il_reg_handle_t *handle)
+{
+	il_servo__release(handle->servo);
+	free(handle);
+}
+
+/**
+ * Read the raw (wire) value of a register handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [out] raw
+ *	Raw value.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int handle_read(il_reg_handle_t *handle, il_reg_value_t *raw)
+{
+	il_servo_t *servo = handle->servo;
+	const il_reg_t *reg = &handle->reg;
+	uint64_t gen;
+	int r;
+
+	if (reg->access == IL_REG_ACCESS_WO) {
+		ilerr__set("Register is write-only");
+		return IL_EACCESS;
+	}
+
+	raw->u64 = 0;
+
+	if (il_servo_mirror__lookup(&servo->mirror, reg->subnode,
+				    (uint16_t)reg->address, raw, handle->sz,
+				    &gen))
+		return 0;
+
+	r = il_net__read(servo->net, servo->id, reg->subnode, reg->address,
+			 raw, handle->sz);
+	if (r == 0)
+		il_servo_mirror__fill(&servo->mirror, reg->subnode,
+				      (uint16_t)reg->address, raw, handle->sz,
+				      gen);
+
+	return r;
+}
+
+/**
+ * Write the raw (wire) value of a register handle.
+ *
+ * @param [in] handle
+ *	Register handle.
+ * @param [in] raw
+ *	Raw value.
+ * @param [in] confirm
+ *	Confirm the write.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int handle_write(il_reg_handle_t *handle, const il_reg_value_t *raw,
+			int confirm)
+{
+	il_servo_t *servo = handle->servo;
+	const il_reg_t *reg = &handle->reg;
+	int r;
+
+	if (reg->access == IL_REG_ACCESS_RO) {
+		ilerr__set("Register is read-only");
+		return IL_EACCESS;
+	}
+
+	/* skip confirmation on write-only registers */
+	if (reg->access == IL_REG_ACCESS_WO)
+		confirm = 0;
+
+	r = il_net__write(servo->net, servo->id, reg->subnode, reg->address,
+			  raw, handle->sz, confirm, 0);
+
+	il_servo_mirror__written(&servo->mirror, reg->subnode,
+				 (uint16_t)reg->address, raw, handle->sz, r);
+
+	return r;
+}
+
+int il_servo_base__reg_handle_read(il_reg_handle_t *handle,
+				   il_reg_value_t *val)
+{
+	int r;
+
+	r = handle_read(handle, val);
+	if (r < 0)
+		return r;
+
+	raw_swap(handle->reg.dtype, val);
+
+	return 0;
+}
+
+int il_servo_base__reg_handle_write(il_reg_handle_t *handle,
+				    il_reg_value_t val, int confirm)
+{
+	raw_swap(handle->reg.dtype, &val);
+
+	return handle_write(handle, &val, confirm);
+}
+
+int il_servo_base__reg_handle_read_units(il_reg_handle_t *handle, double *val)
+{
+	il_reg_value_t raw;
+	int r;
+
+	r = handle_read(handle, &raw);
+	if (r < 0)
+		return r;
+
+	*val = raw_to_double(handle->reg.dtype, &raw) * handle->factor;
+
+	return 0;
+}
+
+int il_servo_base__reg_handle_write_units(il_reg_handle_t *handle, double val,
+					  int confirm)
+{
+	il_reg_value_t raw;
+	int r;
+
+	raw.u64 = 0;
+	r = double_to_raw(&handle->reg, val / handle->factor, &raw);
+	if (r < 0)
+		return r;
+
+	return handle_write(handle, &raw, confirm);
+}
@@ -628,6 +628,7 @@ static int parse_reg(xmlNodePtr node, il_dict_t *dict, int subnode)
 
 	/* store XML node (for later editions) */
 	kh_val(dict->h_regs[subnode], k).xml_node = node;
+	kh_val(dict->h_regs[subnode], k).dirty = 0;
 
 	/* initialize register */
 	reg = &kh_val(dict->h_regs[subnode], k).reg;
@@ -779,6 +780,81 @@ static int parse_reg(xmlNodePtr node, il_dict_t *dict, int subnode)
 	return parse_reg_props(node, reg);
 }
 
+/**
+ * Write the storage value of a register to its XML node.
+ *
+ * @param [in] entry
+ *	Register container.
+ */
+static void storage_sync(il_dict_reg_t *entry)
+{
+	char value[NUM_STR_LEN];
+	il_reg_value_t storage = entry->reg.storage;
+
+	switch (entry->reg.dtype) {
+	case IL_REG_DTYPE_U8:
+		snprintf(value, sizeof(value), "%" PRIu8, storage.u8);
+		break;
+	case IL_REG_DTYPE_S8:
+		snprintf(value, sizeof(value), "%" PRId8, storage.s8);
+		break;
+	case IL_REG_DTYPE_U16:
+		snprintf(value, sizeof(value), "%" PRIu16, storage.u16);
+		break;
+	case IL_REG_DTYPE_S16:
+		snprintf(value, sizeof(value), "%" PRId16, storage.s16);
+		break;
+	case IL_REG_DTYPE_U32:
+		snprintf(value, sizeof(value), "%" PRIu32, storage.u32);
+		break;
+	case IL_REG_DTYPE_S32:
+		snprintf(value, sizeof(value), "%" PRId32, storage.s32);
+		break;
+	case IL_REG_DTYPE_U64:
+		snprintf(value, sizeof(value), "%" PRIu64, storage.u64);
+		break;
+	case IL_REG_DTYPE_S64:
+		snprintf(value, sizeof(value), "%" PRId64, storage.s64);
+		break;
+	case IL_REG_DTYPE_FLOAT:
+		snprintf(value, sizeof(value), "%f", storage.flt);
+		break;
+	default:
+		break;
+	}
+
+	(void)xmlSetProp(entry->xml_node, (const xmlChar *)"storage",
+			 (const xmlChar *)value);
+
+	entry->dirty = 0;
+}
+
+/**
+ * Write all pending storage values to the XML document.
+ *
+ * @param [in] dict
+ *	Dictionary instance.
+ */
+static void storage_flush(il_dict_t *dict)
+{
+	int i;
+	khint_t k;
+
+	if (!dict->dirty)
+		return;
+
+	for (i = 0; i < dict->subnodes; i++) {
+		khash_t(reg_id) *h_regs = dict->h_regs[i];
+
+		for (k = 0; k < kh_end(h_regs); ++k) {
+			if (kh_exist(h_regs, k) && kh_value(h_regs, k).dirty)
+				storage_sync(&kh_value(h_regs, k));
+		}
+	}
+
+	dict->dirty = 0;
+}
+
 /*******************************************************************************
  * Public
  ******************************************************************************/
@@ -802,6 +878,8 @@ il_dict_t *il_dict_create(const char *dict_f)
 		return NULL;
 	}
 
+	dict->dirty = 0;
+
 	/* create hash table for categories and registers */
 	dict->h_cats = kh_init(cat_id);
 	if (!dict->h_cats) {
@@ -1102,6 +1180,8 @@ void il_dict_destroy(il_dict_t *dict)
 
 int il_dict_save(il_dict_t *dict, const char *fname)
 {
+	storage_flush(dict);
+
 	if (xmlSaveFile(fname, dict->xml_doc) < 0) {
 		ilerr__set("xml: %s",
 			   xmlCtxtGetLastError(dict->xml_ctxt)->message);
@@ -1269,9 +1349,7 @@ int il_dict_reg_storage_update(il_dict_t *dict, const char *id,
 			       il_reg_value_t storage, uint8_t subnode)
 {
 	khint_t k;
-	char value[NUM_STR_LEN];
-	il_reg_t *reg;
-	xmlNodePtr node;
+	il_dict_reg_t *entry;
 
 	k = kh_get(reg_id, dict->h_regs[subnode], id);
 	if (k == kh_end(dict->h_regs[subnode])) {
@@ -1280,48 +1358,50 @@ int il_dict_reg_storage_update(il_dict_t *dict, const char *id,
 	}
 
 	/* update register */
-	reg = &kh_value(dict->h_regs[subnode], k).reg;
-	reg->storage = storage;
-	reg->storage_valid = 1;
+	entry = &kh_value(dict->h_regs[subnode], k);
+	entry->reg.storage = storage;
+	entry->reg.storage_valid = 1;
 
-	/* update XML node */
-	switch (reg->dtype) {
-	case IL_REG_DTYPE_U8:
-		snprintf(value, sizeof(value), "%" PRIu8, storage.u8);
-		break;
-	case IL_REG_DTYPE_S8:
-		snprintf(value, sizeof(value), "%" PRId8, storage.s8);
-		break;
-	case IL_REG_DTYPE_U16:
-		snprintf(value, sizeof(value), "%" PRIu16, storage.u16);
-		break;
-	case IL_REG_DTYPE_S16:
-		snprintf(value, sizeof(value), "%" PRId16, storage.s16);
-		break;
-	case IL_REG_DTYPE_U32:
-		snprintf(value, sizeof(value), "%" PRIu32, storage.u32);
-		break;
-	case IL_REG_DTYPE_S32:
-		snprintf(value, sizeof(value), "%" PRId32, storage.s32);
-		break;
-	case IL_REG_DTYPE_U64:
-		snprintf(value, sizeof(value), "%" PRIu64, storage.u64);
-		break;
-	case IL_REG_DTYPE_S64:
-		snprintf(value, sizeof(value), "%" PRId64, storage.s64);
-		break;
-	case IL_REG_DTYPE_FLOAT:
-		snprintf(value, sizeof(value), "%f", storage.flt);
-		break;
-	default:
-		break;
+	storage_sync(entry);
+
+	return 0;
+}
+
+int il_dict_reg_storage_update_many(il_dict_t *dict,
+				    const il_dict_storage_t *storages, size_t n)
+{
+	size_t i;
+	int r = 0;
+
+	for (i = 0; i < n; i++) {
+		khash_t(reg_id) *h_regs;
+		il_dict_reg_t *entry;
+		khint_t k;
+
+		if (storages[i].subnode >= dict->subnodes) {
+			ilerr__set("Invalid subnode (%d)", storages[i].subnode);
+			r = IL_EINVAL;
+			continue;
+		}
+
+		h_regs = dict->h_regs[storages[i].subnode];
+		k = kh_get(reg_id, h_regs, storages[i].id);
+		if (k == kh_end(h_regs)) {
+			ilerr__set("Register not found (%s)", storages[i].id);
+			r = IL_EFAIL;
+			continue;
+		}
+
+		/* XML node is updated when saving */
+		entry = &kh_value(h_regs, k);
+		entry->reg.storage = storages[i].storage;
+		entry->reg.storage_valid = 1;
+		entry->dirty = 1;
 	}
 
-	node = kh_value(dict->h_regs[subnode], k).xml_node;
-	(void)xmlSetProp(node, (const xmlChar *)"storage",
-			 (const xmlChar *)value);
+	dict->dirty = 1;
 
-	return 0;
+	return r;
 }
 
 const char **il_dict_reg_ids_get(il_dict_t *dict, uint8_t subnode)
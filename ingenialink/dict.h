@@ -20,6 +20,8 @@ typedef struct {
 	il_reg_t reg;
 	/** XML node. */
 	xmlNodePtr xml_node;
+	/** Storage not yet written to the XML node. */
+	int dirty;
 } il_dict_reg_t;
 
 /** khash type for reg_id<->register dictionary. */
@@ -92,6 +94,8 @@ struct il_dict {
 	const char *version;
 	/** Dictionary subnodes. */
 	int subnodes;
+	/** Some register storage not yet written to the XML document. */
+	int dirty;
 };
 
 #endif
@@ -9,6 +9,12 @@
 /** Ethernet MCB frame size (words). */
 #define ECAT_MCB_FRAME_SZ	7
 
+/** Ethernet MCB maximum extended payload size (bytes). */
+#define ECAT_MCB_EXT_MAX_SZ	2048
+
+/** Ethernet MCB extended write payload size per frame (bytes). */
+#define ECAT_MCB_EXT_WR_SZ	1010
+
 /** Ethernet MCB Header */
 /** Ethernet MCB frame header high word position. */
 #define ECAT_MCB_HDR_H_POS	0
@@ -15,6 +15,7 @@
 #include <stdbool.h>
 #include <inttypes.h>
 
+#include "ingenialink/crc.h"
 #include "ingenialink/err.h"
 #include "ingenialink/base/net.h"
 #include "external/log.c/src/log.h"
@@ -86,16 +87,22 @@ uint16 argslave;
 * Private
 ******************************************************************************/
 static int il_ecat_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, void *buf, size_t sz);
-static int il_ecat_net__read_monitoring(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-    void *buf, size_t sz);
+static int read_locked(il_ecat_net_t *this, uint16_t id, uint8_t subnode,
+                       uint32_t address, void *buf, size_t sz);
+static int monitoring_download_locked(il_ecat_net_t *this);
 int il_ecat_net_SDO_read(il_net_t *net, uint8_t slave, uint16_t index, uint8_t subindex, int size, void *buf);
 static int net_send(il_ecat_net_t *this, uint8_t subnode, uint16_t address, const void *data,
-    size_t sz, uint16_t extended, il_net_t *net);
+    size_t sz);
+static int disturbance_upload_locked(il_ecat_net_t *this, uint8_t subnode,
+                                     uint16_t address);
 int il_ecat_net_SDO_write(il_net_t *net, uint8_t slave, uint16_t index, uint8_t subindex, int size, void *buf);
 static int il_ecat_net_recv_monitoring(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
      size_t sz, uint16_t *monitoring_raw_data, il_net_t *net, int num_bytes);
 static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
-    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net);
+    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net, const osal_timespec_t *deadline);
+static int mailbox_frame_wait(il_ecat_net_t *this, uint16_t *frame, size_t sz,
+                              const osal_timespec_t *deadline);
+static void mailbox_payload_set(il_ecat_net_t *this, uint8_t *dst, size_t cap);
 static int process_monitoring_data(il_ecat_net_t *this, il_net_t *net);
 static int il_ecat_net_remove_all_mapped_registers_v1(il_net_t *net);
 static int il_ecat_net_remove_all_mapped_registers_v2(il_net_t *net);
@@ -170,96 +177,6 @@ static int not_supported(void)
     return IL_ENOTSUP;
 }
 
-bool crc_tabccitt_init_ecat = false;
-uint16_t crc_tabccitt_ecat[256];
-
-/**
-* Compute CRC of the given buffer.
-*
-* @param [in] buf
-*   Buffer.
-* @param [in] sz
-*   Buffer size (bytes).
-*
-* @return
-*   CRC.
-*/
-static void init_crcccitt_tab_ecat(void) {
-
-    uint16_t i;
-    uint16_t j;
-    uint16_t crc;
-    uint16_t c;
-
-    for (i = 0; i<256; i++) {
-        crc = 0;
-        c = i << 8;
-        for (j = 0; j<8; j++) {
-            if ((crc ^ c) & 0x8000) crc = (crc << 1) ^ 0x1021;
-            else crc = crc << 1;
-            c = c << 1;
-        }
-        crc_tabccitt_ecat[i] = crc;
-    }
-    crc_tabccitt_init_ecat = true;
-}
-
-static uint16_t update_crc_ccitt_ecat(uint16_t crc, unsigned char c) {
-
-    if (!crc_tabccitt_init_ecat) init_crcccitt_tab_ecat();
-    return (crc << 8) ^ crc_tabccitt_ecat[((crc >> 8) ^ (uint16_t)c) & 0x00FF];
-
-}
-
-static uint16_t crc_calc_ecat(const uint16_t *buf, uint16_t u16Sz)
-{
-
-    uint16_t crc = 0x0000;
-    uint8_t* pu8In = (uint8_t*)buf;
-
-    for (uint16_t u16Idx = 0; u16Idx < u16Sz * 2; u16Idx++)
-    {
-        crc = update_crc_ccitt_ecat(crc, pu8In[u16Idx]);
-    }
-    return crc;
-}
-
-/**
-* Process asynchronous statusword messages.
-*
-* @param [in] this
-*   ECAT Network.
-* @param [in] frame
-*   IngeniaLink frame.
-*/
-static void process_statusword(il_ecat_net_t *this, uint8_t subnode, uint16_t *data)
-{
-    il_net_sw_subscriber_lst_t *subs;
-    int i;
-    uint8_t id;
-    uint16_t sw;
-
-    subs = &this->net.sw_subs;
-
-    id = subnode;
-    sw = data;
-
-    osal_mutex_lock(subs->lock);
-
-    for (i = 0; i < subs->sz; i++) {
-        if (subs->subs[i].id == id && subs->subs[i].cb) {
-            void *ctx;
-
-            ctx = subs->subs[i].ctx;
-            subs->subs[i].cb(ctx, sw);
-
-            break;
-        }
-    }
-
-    osal_mutex_unlock(subs->lock);
-}
-
 /**
 * Listener thread.
 *
@@ -279,9 +196,13 @@ restart:
     while (error_count < 3 && this != NULL && this->stop_reconnect == 0 ) {
         uint16_t sw;
 
-        /* try to read the status word register to see if a servo is alive */
+        /* try to read the status word register to see if a servo is alive,
+         * unless regular traffic already proved it recently (the read
+         * notifies statusword subscribers by itself) */
         if (this != NULL && this->status_check_stop == 0) {
-            r = il_net__read(&this->net, 1, 1, STATUSWORD_ADDRESS, &sw, sizeof(sw));
+            r = 0;
+            if (il_net__heartbeat_due(&this->net))
+                r = il_net__read(&this->net, 1, 1, STATUSWORD_ADDRESS, &sw, sizeof(sw));
             if (r < 0) {
                 if (il_net_status_get(this) != IL_NET_STATE_DISCONNECTED) {
                     error_count = error_count + 1;
@@ -294,7 +215,6 @@ restart:
                 }
                 error_count = 0;
                 this->stop = IL_NET_STATE_CONNECTED;
-                process_statusword(this, 1, sw);
             }
 
         }
@@ -379,6 +299,7 @@ static il_net_t *il_ecat_net_create(const il_ecat_net_opts_t *opts)
     this->if_address_ip = opts->if_address_ip;
     this->slave = opts->slave;
     this->recv_timeout = EC_TIMEOUTRET;
+    this->wait_write_timeout = WAIT_WRITE_TIMEOUT_DEF;
     this->status_check_stop = 1;
     this->use_eoe_comms = opts->use_eoe_comms;
 
@@ -502,6 +423,13 @@ static int il_ecat_net_connect(il_net_t *net, const char *ip)
     return 0;
 }
 
+static void il_ecat_net__retain(il_net_t *net)
+{
+    il_ecat_net_t *this = to_ecat_net(net);
+
+    il_utils__refcnt_retain(this->refcnt);
+}
+
 static void il_ecat_net__release(il_net_t *net)
 {
     il_ecat_net_t *this = to_ecat_net(net);
@@ -585,7 +513,7 @@ static int il_ecat_net_remove_all_mapped_registers(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_ecat_net_remove_all_mapped_registers_v1(net);
@@ -609,6 +537,8 @@ static int il_ecat_net_remove_all_mapped_registers_v1(il_net_t *net)
     }
 
     net->monitoring_number_mapped_registers = 0;
+    il_net__monitoring_release(net);
+
     return r;
 }
 
@@ -624,6 +554,8 @@ static int il_ecat_net_remove_all_mapped_registers_v2(il_net_t *net)
     }
 
     net->monitoring_number_mapped_registers = 0;
+    il_net__monitoring_release(net);
+
     return r;
 }
 
@@ -639,7 +571,7 @@ static int il_ecat_net_set_mapped_register(il_net_t *net, int channel, uint32_t
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_ecat_net_set_mapped_register_v1(net, channel, address, dtype);
@@ -658,7 +590,9 @@ static int il_ecat_net_set_mapped_register_v1(il_net_t *net, int channel, uint32
     int r = 0;
     il_ecat_net_t *this = to_ecat_net(net);
 
-    net->monitoring_data_channels[channel].type = dtype;
+    r = il_net__monitoring_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     // Map address
     r = il_net__write(&this->net, 1, 0, 0x00E0, &address, 2, 1, 0);
@@ -671,6 +605,8 @@ static int il_ecat_net_set_mapped_register_v1(il_net_t *net, int channel, uint32
     if (r < 0) {
 
     }
+    if (r >= 0)
+        r = il_net__monitoring_layout_update(net);
 
     return r;
 }
@@ -682,7 +618,14 @@ static int il_ecat_net_set_mapped_register_v2(il_net_t *net, int channel, uint32
     int r = 0;
     il_ecat_net_t *this = to_ecat_net(net);
 
-    net->monitoring_data_channels[channel].type = dtype;
+    if (net->monitoring_number_mapped_registers >= ARRAY_SIZE(il_net_ecat_monitoring_mapping_registers)) {
+        ilerr__set("No monitoring mapping registers left");
+        return IL_EINVAL;
+    }
+
+    r = il_net__monitoring_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     uint16_t frame[2];
     uint16_t hdr_h, hdr_l;
@@ -707,6 +650,8 @@ static int il_ecat_net_set_mapped_register_v2(il_net_t *net, int channel, uint32
     if (r < 0) {
 
     }
+    if (r >= 0)
+        r = il_net__monitoring_layout_update(net);
 
     return r;
 }
@@ -721,7 +666,7 @@ static int il_ecat_net_disturbance_remove_all_mapped_registers(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_ecat_net_disturbance_remove_all_mapped_registers_v1(net);
@@ -745,6 +690,7 @@ static int il_ecat_net_disturbance_remove_all_mapped_registers_v1(il_net_t *net)
     }
 
     net->disturbance_number_mapped_registers = 0;
+    il_net__disturbance_release(net);
     return r;
 }
 
@@ -760,6 +706,7 @@ static int il_ecat_net_disturbance_remove_all_mapped_registers_v2(il_net_t *net)
     }
 
     net->disturbance_number_mapped_registers = 0;
+    il_net__disturbance_release(net);
     return r;
 }
 
@@ -775,7 +722,7 @@ static int il_ecat_net_disturbance_set_mapped_register(il_net_t *net, int channe
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_ecat_net_disturbance_set_mapped_register_v1(net, channel, address, subnode, dtype, size);
@@ -795,7 +742,9 @@ static int il_ecat_net_disturbance_set_mapped_register_v1(il_net_t *net, int cha
     il_ecat_net_t *this = to_ecat_net(net);
 
     // Always 0 for the moment
-    net->disturbance_data_channels[channel].type = dtype;
+    r = il_net__disturbance_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     // Map address
     r = il_net__write(&this->net, 1, 0, 0x00E5, &address, 2, 1, 0);
@@ -813,7 +762,9 @@ static int il_ecat_net_disturbance_set_mapped_register_v2(il_net_t *net, int cha
     int r = 0;
     il_ecat_net_t *this = to_ecat_net(net);
 
-    net->disturbance_data_channels[channel].type = dtype;
+    r = il_net__disturbance_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     uint16_t frame[2];
     uint16_t hdr_h, hdr_l;
@@ -853,7 +804,7 @@ static int il_ecat_net_enable_disturbance(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old version
         r = il_net__write(&this->net, 1, 0, 0x00C0, &enable_disturbance_val, 2, 1, 0);
@@ -895,7 +846,7 @@ static int il_ecat_net_disable_disturbance(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old version
         r = il_net__write(&this->net, 1, 0, 0x00C0, &disable_disturbance_val, 2, 1, 0);
@@ -985,18 +936,13 @@ static int il_ecat_net_disturbance_remove_data(il_net_t *net)
 
 static int il_ecat_net_read_monitoring_data(il_net_t *net)
 {
-    int r = 0;
     il_ecat_net_t *this = to_ecat_net(net);
-
-    uint64_t vid;
-
+    int r;
 
     osal_mutex_lock(this->net.lock);
-    r = il_ecat_net__read_monitoring(&this->net, 1, 0, 0x00B2, &vid, sizeof(vid));
-    if (r < 0) {
-
-    }
+    r = monitoring_download_locked(this);
     osal_mutex_unlock(this->net.lock);
+
     return r;
 }
 
@@ -1054,25 +1000,27 @@ static void il_ecat_net_dev_mon_stop(il_net_dev_mon_t *mon)
 	}
 }
 
-static int il_ecat_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-    void *buf, size_t sz)
+/**
+ * Read a register (net.lock must be held).
+ */
+static int read_locked(il_ecat_net_t *this, uint16_t id, uint8_t subnode,
+                       uint32_t address, void *buf, size_t sz)
 {
-    il_ecat_net_t *this = to_ecat_net(net);
+    il_net_t *net = &this->net;
     int r;
 
-    osal_mutex_lock(this->net.lock);
     if (this->use_eoe_comms)
     {
         int num_retries = 0;
         while (num_retries < NUMBER_OP_RETRIES_DEF)
         {
-            r = net_send(this, subnode, (uint16_t)address, NULL, 0, 0, net);
+            r = net_send(this, subnode, (uint16_t)address, NULL, 0);
             if (r < 0) {
                 goto unlock;
             }
 
             uint16_t *monitoring_raw_data = NULL;
-            r = net_recv(this, subnode, (uint16_t)address, buf, sz, monitoring_raw_data, net);
+            r = net_recv(this, subnode, (uint16_t)address, buf, sz, monitoring_raw_data, net, NULL);
             if (r == IL_ETIMEDOUT || r == IL_EWRONGREG || r == IL_EFAIL)
             {
                 ++num_retries;
@@ -1097,71 +1045,97 @@ static int il_ecat_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32
         r = il_ecat_net_SDO_read(this, id, addr, 0x00, sz, buf);
     }
 
-
-    if (r < 0)
-    {
-        if (r == IL_ETIMEDOUT || r == IL_EWRONGREG)
-        {
-
-        }
-        goto unlock;
-    }
-
-
 unlock:
-    osal_mutex_unlock(this->net.lock);
     return r;
 }
 
-static int il_ecat_net__read_monitoring(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
+static int il_ecat_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
     void *buf, size_t sz)
 {
     il_ecat_net_t *this = to_ecat_net(net);
     int r;
-    (void)id;
 
-    int num_bytes;
-    r = il_net__read(&this->net, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
-    if (r < 0)
-    {
-        // Old monitoring method
-        uint64_t vid;
-        r = il_net__read(&this->net, 1, 0, 0x00B2, &vid, sizeof(vid));
+    osal_mutex_lock(this->net.lock);
+    r = read_locked(this, id, subnode, address, buf, sz);
+    osal_mutex_unlock(this->net.lock);
+
+    return r;
+}
+
+/**
+ * Download the monitoring data available in the drive (net.lock must be held).
+ *
+ * @note
+ *	The number of pending bytes (0x00B7) is read once, then blocks are
+ *	requested back-to-back and the count is only re-checked once they have
+ *	all been received. Unlike Ethernet, requests are not pipelined: the
+ *	mailbox only holds a single frame in flight.
+ */
+static int monitoring_download_locked(il_ecat_net_t *this)
+{
+    il_net_t *net = &this->net;
+    osal_timespec_t start;
+    uint32_t num_bytes = 0;
+    uint64_t vid;
+    size_t got, blocks = 0;
+    int r;
+
+    r = read_locked(this, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+    if (r < 0) {
+        /* old monitoring method */
+        return read_locked(this, 1, 0, 0x00B2, &vid, sizeof(vid));
     }
-    else
-    {
-        // Initialize monitoring data size value
-        net->monitoring_data_size = 0;
 
-        while (num_bytes > 0)
-        {
-            // osal_mutex_lock(this->net.lock);
-            r = net_send(this, subnode, (uint16_t)address, NULL, 0, 0, net);
-            if (r < 0) {
-                goto unlock;
-            }
-            uint8_t *monitoring_raw_data = NULL;
-            r = il_ecat_net_recv_monitoring(this, subnode, (uint16_t)address, buf, sz, monitoring_raw_data, net, num_bytes);
+    net->monitoring_data_size = 0;
+    (void)osal_clock_gettime(&start);
+
+    while (num_bytes > 0) {
+        got = 0;
+
+        while (got < num_bytes) {
+            size_t prev = net->monitoring_data_size;
+
+            r = il_net__monitoring_raw_reserve(net, net->monitoring_data_size +
+                                               (num_bytes - got) +
+                                               ECAT_MCB_EXT_MAX_SZ);
             if (r < 0)
-                goto unlock;
-            // osal_mutex_unlock(this->net.lock);
-            r = il_net__read(&this->net, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+                return r;
+
+            mailbox_payload_set(this, &net->monitoring_raw_data[net->monitoring_data_size],
+                                net->monitoring_raw_sz - net->monitoring_data_size);
+
+            r = net_send(this, 0, 0x00B2, NULL, 0);
             if (r < 0) {
-                goto unlock;
+                mailbox_payload_set(this, NULL, 0);
+                return r;
             }
 
-        }
+            r = il_ecat_net_recv_monitoring(this, 0, 0x00B2, (uint8_t *)&vid,
+                                            sizeof(vid), NULL, net,
+                                            (int)(num_bytes - got));
+            mailbox_payload_set(this, NULL, 0);
+            if (r < 0)
+                return r;
 
-        if (r >= 0)
-        {
-            r = process_monitoring_data(this, net);
+            /* drive ran out of data earlier than announced */
+            if (net->monitoring_data_size == prev)
+                break;
+
+            got += net->monitoring_data_size - prev;
+            blocks++;
+
+            il_net__monitoring_progress(net, net->monitoring_data_size,
+                                        net->monitoring_data_size + num_bytes - got);
         }
+
+        r = read_locked(this, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+        if (r < 0)
+            return r;
     }
 
-unlock:
-    osal_mutex_unlock(this->net.lock);
+    il_net__monitoring_download_done(net, &start, blocks);
 
-    return r;
+    return process_monitoring_data(this, net);
 }
 
 static int il_ecat_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
@@ -1176,16 +1150,20 @@ static int il_ecat_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint3
 
     osal_mutex_lock(this->net.lock);
 
-    if (this->use_eoe_comms)
+    if (this->use_eoe_comms && extended == 1)
+    {
+        r = disturbance_upload_locked(this, subnode, (uint16_t)address);
+    }
+    else if (this->use_eoe_comms)
     {
-        r = net_send(this, subnode, (uint16_t)address, buf, sz, extended, net);
+        r = net_send(this, subnode, (uint16_t)address, buf, sz);
         if (r < 0)
             goto unlock;
 
         int num_retries = 0;
         while (num_retries < NUMBER_OP_RETRIES_DEF)
         {
-            r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL);
+            r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL, NULL);
             if (r == IL_ETIMEDOUT || r == IL_EWRONGREG)
             {
                 ++num_retries;
@@ -1229,6 +1207,7 @@ static int il_ecat_net__wait_write(il_net_t *net, uint16_t id, uint8_t subnode,
     const void *buf, size_t sz, int confirmed, uint16_t extended)
 {
     il_ecat_net_t *this = to_ecat_net(net);
+    osal_timespec_t deadline;
 
     int r;
 
@@ -1237,17 +1216,23 @@ static int il_ecat_net__wait_write(il_net_t *net, uint16_t id, uint8_t subnode,
 
     osal_mutex_lock(this->net.lock);
 
+    if (extended == 1) {
+        r = disturbance_upload_locked(this, subnode, (uint16_t)address);
+        goto unlock;
+    }
 
-    r = net_send(this, subnode, (uint16_t)address, buf, sz, extended, net);
+    r = net_send(this, subnode, (uint16_t)address, buf, sz);
     if (r < 0)
         goto unlock;
 
-    Sleep(1000);
+    /* the drive acknowledges once the operation completes */
+    osal_clock_deadline_set(&deadline,
+                            (long long)this->wait_write_timeout * OSAL_CLOCK_NANOSPERMSEC);
 
     int num_retries = 0;
     while (num_retries < NUMBER_OP_RETRIES_DEF)
     {
-        r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL);
+        r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL, &deadline);
         if (r == IL_ETIMEDOUT || r == IL_EWRONGREG)
         {
             ++num_retries;
@@ -1352,103 +1337,295 @@ typedef union
     uint16_t u16[4];
 } UINT_UNION_T;
 
+/**
+ * Build an MCB frame.
+ *
+ * @param [out] frame
+ *	Frame buffer (ECAT_MCB_FRAME_SZ words).
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Register address.
+ * @param [in] cmd
+ *	Command (ECAT_MCB_CMD_*).
+ * @param [in] extended
+ *	Extended frame flag.
+ * @param [in] d
+ *	Configuration data.
+ */
+static void frame_build(uint16_t *frame, uint8_t subnode, uint16_t address,
+                        uint8_t cmd, uint16_t extended, uint64_t d)
+{
+    UINT_UNION_T u = { .u64 = d };
+
+    /* header */
+    frame[ECAT_MCB_HDR_H_POS] = (ECAT_MCB_NODE_DFLT << 4) | (subnode);
+    frame[ECAT_MCB_HDR_L_POS] = (address << 4) | (cmd << 1) | (extended);
+
+    /* cfg_data */
+    memcpy(&frame[ECAT_MCB_DATA_POS], &u.u16[0], 8);
+
+    /* crc */
+    frame[ECAT_MCB_CRC_POS] = il_crc__ccitt(frame, ECAT_MCB_CRC_POS * sizeof(uint16_t));
+}
+
 static int net_send(il_ecat_net_t *this, uint8_t subnode, uint16_t address, const void *data,
-    size_t sz, uint16_t extended, il_net_t *net)
+    size_t sz)
 {
-    int finished = 0;
+    uint16_t frame[ECAT_MCB_FRAME_SZ];
+    uint64_t d = 0;
     uint8_t cmd;
+    err_t error = -1;
 
     cmd = sz ? ECAT_MCB_CMD_WRITE : ECAT_MCB_CMD_READ;
 
-    while (!finished) {
-        int r;
-        uint16_t frame[ECAT_MCB_FRAME_SZ];
-        uint16_t hdr_h, hdr_l, crc;
-        size_t chunk_sz;
-
-        /* header */
-        hdr_h = (ECAT_MCB_NODE_DFLT << 4) | (subnode);
-        *(uint16_t *)&frame[ECAT_MCB_HDR_H_POS] = hdr_h;
-        hdr_l = (address << 4) | (cmd << 1) | (extended);
-        *(uint16_t *)&frame[ECAT_MCB_HDR_L_POS] = hdr_l;
-
-        /* cfg_data */
-        uint64_t d = 0;
-        /* Check if frame is extended */
-        if (extended == 1) {
-            d = net->disturbance_data_size;
-        }
-        else {
-            if (sz > 0) {
-                memcpy(&d, data, sz);
-            }
+    /* cfg_data */
+    if (sz > 0)
+        memcpy(&d, data, MIN(sz, sizeof(d)));
+
+    frame_build(frame, subnode, address, cmd, 0, d);
+
+    /* discard any stale reply */
+    osal_mutex_lock(this->lock_mailbox);
+    this->frame_pending = 0;
+    osal_mutex_unlock(this->lock_mailbox);
+
+    /* send frame */
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, sizeof(frame), PBUF_RAM);
+    if (p != NULL) {
+        memcpy(p->payload, frame, sizeof(frame));
+        error = udp_sendto(ptUdpPcb, p, &dstaddr, 1061);
+        pbuf_free(p);
+    }
+
+    if (error < 0)
+        return ilerr__ecat(error);
+
+    return 0;
+}
+
+/**
+ * Send an extended write frame.
+ *
+ * @param [in] this
+ *	ECAT network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Register address.
+ * @param [in] payload
+ *	Payload.
+ * @param [in] sz
+ *	Payload size (bytes).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int net_send_ext(il_ecat_net_t *this, uint8_t subnode, uint16_t address,
+                        const uint8_t *payload, size_t sz)
+{
+    uint16_t frame[ECAT_MCB_FRAME_SZ];
+    err_t error = -1;
+    struct pbuf *p;
+
+    (void)this;
+
+    frame_build(frame, subnode, address, ECAT_MCB_CMD_WRITE, 1, (uint64_t)sz);
+
+    p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)(sizeof(frame) + sz), PBUF_RAM);
+    if (p != NULL) {
+        memcpy(p->payload, frame, sizeof(frame));
+        memcpy((uint8_t *)p->payload + sizeof(frame), payload, sz);
+        error = udp_sendto(ptUdpPcb, p, &dstaddr, 1061);
+        pbuf_free(p);
+    }
+
+    if (error < 0)
+        return ilerr__ecat(error);
+
+    return 0;
+}
+
+/**
+ * Upload the packed disturbance payload (net.lock held).
+ *
+ * @note
+ *	The payload is split in as many extended frames as needed, each one
+ *	carrying whole samples, and up to EXT_WR_PIPELINE_DEPTH frames are kept
+ *	outstanding. The mailbox reader counts the acknowledges as they arrive.
+ *
+ * @param [in] this
+ *	ECAT network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Disturbance data register address.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int disturbance_upload_locked(il_ecat_net_t *this, uint8_t subnode,
+                                     uint16_t address)
+{
+    il_net_t *net = &this->net;
+    osal_timespec_t deadline;
+    size_t total, chunk, n, sent = 0, acked = 0;
+    long long left;
+    int nack = 0, r = 0;
+
+    total = net->disturbance_data_size;
+    if (total == 0 || total > net->disturbance_packed_sz) {
+        ilerr__set("Disturbance data not set (%zu bytes requested)", total);
+        return IL_EINVAL;
+    }
+
+    chunk = ECAT_MCB_EXT_WR_SZ;
+    if (total > chunk && net->disturbance_sample_sz > 0 &&
+        net->disturbance_sample_sz <= chunk)
+        chunk -= chunk % net->disturbance_sample_sz;
+
+    n = (total + chunk - 1) / chunk;
+
+    osal_mutex_lock(this->lock_mailbox);
+    this->frame_pending = 0;
+    this->frames_rcvd = 0;
+    this->frames_nack = 0;
+    osal_mutex_unlock(this->lock_mailbox);
+
+    while (acked < n) {
+        /* fill the pipeline */
+        while (sent < n && sent - acked < EXT_WR_PIPELINE_DEPTH) {
+            size_t off = sent * chunk;
+
+            r = net_send_ext(this, subnode, address,
+                             &net->disturbance_packed[off],
+                             MIN(chunk, total - off));
+            if (r < 0)
+                return r;
+
+            sent++;
         }
-        UINT_UNION_T u = { .u64 = d };
-        memcpy(&frame[ECAT_MCB_DATA_POS], &u.u16[0], 8);
-
-        /* crc */
-        crc = crc_calc_ecat(frame, ECAT_MCB_CRC_POS);
-        frame[ECAT_MCB_CRC_POS] = crc;
-
-        /* send frame */
-        if (extended == 1) {
-            uint16_t frame_size = sizeof(uint16_t) * ECAT_MCB_FRAME_SZ;
-            uint8_t extended_frame[1024];
-
-            il_reg_dtype_t type = net->disturbance_data_channels[0].type;
-
-            void* pData;
-            switch (type) {
-                case IL_REG_DTYPE_U16:
-                    pData = net->disturbance_data_channels[0].value.disturbance_data_u16;
-                    break;
-                case IL_REG_DTYPE_S16:
-                    pData = net->disturbance_data_channels[0].value.disturbance_data_s16;
-                    break;
-                case IL_REG_DTYPE_U32:
-                    pData = net->disturbance_data_channels[0].value.disturbance_data_u32;
-                    break;
-                case IL_REG_DTYPE_S32:
-                    pData = net->disturbance_data_channels[0].value.disturbance_data_s32;
-                    break;
-                case IL_REG_DTYPE_FLOAT:
-                    pData = net->disturbance_data_channels[0].value.disturbance_data_flt;
-                    break;
+
+        /* wait for acknowledges */
+        osal_clock_deadline_set(&deadline,
+                                (long long)this->recv_timeout * OSAL_CLOCK_NANOSPERUSEC);
+
+        osal_mutex_lock(this->lock_mailbox);
+        while (this->frames_rcvd == acked && !this->frames_nack) {
+            left = osal_clock_deadline_left(&deadline);
+            if (left <= 0) {
+                r = IL_ETIMEDOUT;
+                break;
             }
 
-            memcpy(&extended_frame[0], frame, frame_size);
-            memcpy(&extended_frame[frame_size], pData, 1024 - frame_size);
+            (void)osal_cond_wait(this->mailbox_check, this->lock_mailbox,
+                                 (int)((left + OSAL_CLOCK_NANOSPERMSEC - 1) / OSAL_CLOCK_NANOSPERMSEC));
+        }
 
-            int wkc = 0;
-            struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, net->disturbance_data_size + frame_size, PBUF_RAM);
-            memcpy(p->payload, extended_frame, net->disturbance_data_size + frame_size);
-            error = udp_sendto(ptUdpPcb, p, &dstaddr, 1061);
-            pbuf_free(p);
+        acked = MIN(this->frames_rcvd, sent);
+        nack = this->frames_nack;
+        this->frame_pending = 0;
+        osal_mutex_unlock(this->lock_mailbox);
 
-            if (error < 0)
-                return ilerr__ecat(error);
+        if (nack) {
+            ilerr__set("Disturbance upload rejected (NACK)");
+            return IL_ENACK;
         }
-        else {
-            int wkc = 0;
-            err_t error = -1;
-            struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 14, PBUF_RAM);
-            if (p != NULL) {
-                memcpy(p->payload, frame, 14);
-                error = udp_sendto(ptUdpPcb, p, &dstaddr, 1061);
-            }
-            pbuf_free(p);
 
-            if (error < 0)
-                return ilerr__ecat(error);
+        if (r < 0) {
+            ilerr__set("Disturbance upload timed out (%zu/%zu frames)",
+                       acked, n);
+            return r;
         }
-        finished = 1;
     }
 
     return 0;
 }
 
+/**
+ * Set where the extended payload of the next frame has to be stored.
+ *
+ * @note
+ *	Must be set before the request is sent, so that the mailbox reader
+ *	stores the payload straight into its final location.
+ *
+ * @param [in] this
+ *	ECAT network.
+ * @param [in] dst
+ *	Destination (NULL to keep the payload in frame_received).
+ * @param [in] cap
+ *	Destination size (bytes).
+ */
+static void mailbox_payload_set(il_ecat_net_t *this, uint8_t *dst, size_t cap)
+{
+    osal_mutex_lock(this->lock_mailbox);
+    this->payload_dst = dst;
+    this->payload_cap = dst ? cap : 0;
+    this->payload_len = 0;
+    osal_mutex_unlock(this->lock_mailbox);
+}
+
+/**
+ * Wait for a frame to be delivered by the mailbox reader.
+ *
+ * @param [in] this
+ *	ECAT network.
+ * @param [out] frame
+ *	Frame buffer.
+ * @param [in] sz
+ *	Frame buffer size (bytes).
+ * @param [in] deadline
+ *	Deadline (NULL to wait for the configured receive timeout).
+ *
+ * @return
+ *	Number of payload bytes stored at the payload destination (see
+ *	mailbox_payload_set), error code otherwise.
+ */
+static int mailbox_frame_wait(il_ecat_net_t *this, uint16_t *frame, size_t sz,
+                              const osal_timespec_t *deadline)
+{
+    osal_timespec_t deadline_def;
+    long long left;
+    int r = 0;
+
+    if (!deadline) {
+        osal_clock_deadline_set(&deadline_def,
+                                (long long)this->recv_timeout * OSAL_CLOCK_NANOSPERUSEC);
+        deadline = &deadline_def;
+    }
+
+    osal_mutex_lock(this->lock_mailbox);
+
+    while (!this->frame_pending) {
+        left = osal_clock_deadline_left(deadline);
+        if (left <= 0) {
+            r = IL_ETIMEDOUT;
+            break;
+        }
+
+        r = osal_cond_wait(this->mailbox_check, this->lock_mailbox,
+                           (int)((left + OSAL_CLOCK_NANOSPERMSEC - 1) / OSAL_CLOCK_NANOSPERMSEC));
+        if (r == OSAL_ETIMEDOUT) {
+            r = 0;
+        } else if (r < 0) {
+            r = IL_EFAIL;
+            break;
+        }
+    }
+
+    if (this->frame_pending) {
+        memcpy(frame, this->frame_received, MIN(sz, sizeof(this->frame_received)));
+        this->frame_pending = 0;
+        r = (int)this->payload_len;
+    }
+
+    osal_mutex_unlock(this->lock_mailbox);
+
+    return r;
+}
+
 static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
-    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net)
+    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net, const osal_timespec_t *deadline)
 {
     int finished = 0;
     size_t pending_sz = sz;
@@ -1460,21 +1637,14 @@ static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint
     uint8_t *pBuf = (uint8_t*)&frame;
     uint8_t extended_bit = 0;
 
-    int r = osal_cond_wait(this->mailbox_check, this->lock_mailbox, this->recv_timeout/1000);
-
-    if (r == -2){
-        return IL_ETIMEDOUT;
-    }
+    /* Obtain the frame received */
+    int r = mailbox_frame_wait(this, frame, sizeof(frame), deadline);
     if (r < 0) {
-        return IL_EFAIL;
+        return r;
     }
-
-    int s32SzRead = 1024;
-    /* Obtain the frame received */
-    memcpy(frame, (uint8_t*)&(this->frame_received), 1024);
     /* process frame: validate CRC, address, ACK */
     crc = *(uint16_t *)&frame[6];
-    uint16_t crc_res = crc_calc_ecat((uint16_t *)frame, 6);
+    uint16_t crc_res = il_crc__ccitt((uint16_t *)frame, 6 * sizeof(uint16_t));
     if (crc_res != crc) {
         ilerr__set("Communications error (CRC mismatch)");
         return IL_EWRONGCRC;
@@ -1509,51 +1679,32 @@ static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint
             /* Read size of data */
             memcpy(buf, &(frame[ECAT_MCB_DATA_POS]), 2);
             uint16_t size = *(uint16_t*)buf;
-            memcpy(net->monitoring_raw_data, (uint8_t*)&(this->frame_received[14]), size);
+            if ((size_t)size > sizeof(frame) - 14) {
+                ilerr__set("Extended payload exceeds the frame");
+                return IL_EIO;
+            }
 
-            net->monitoring_data_size = size;
-            int num_mapped = net->monitoring_number_mapped_registers;
-            int bytes_per_block = net->monitoring_bytes_per_block;
+            r = il_net__monitoring_raw_reserve(net, size);
+            if (r < 0)
+                return r;
 
-            int number_blocks = size / bytes_per_block;
-            uint8_t* pData = net->monitoring_raw_data;
+            memcpy(net->monitoring_raw_data, &pBuf[14], size);
 
-            for (int i = 0; i < number_blocks; ++i)
-            {
-                int OffsetIndexIntraBlockInBytes = 0;
-                for (int j = 0; j < num_mapped; ++j)
-                {
-                    il_reg_dtype_t type = net->monitoring_data_channels[j].type;
-                    switch (type) {
-                        case IL_REG_DTYPE_U16:
-                            net->monitoring_data_channels[j].value.monitoring_data_u16[i] = *((uint16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(uint16_t);
-                            break;
-                        case IL_REG_DTYPE_S16:
-                            net->monitoring_data_channels[j].value.monitoring_data_s16[i] = *((int16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(int16_t);
-                            break;
-                        case IL_REG_DTYPE_U32:
-                            net->monitoring_data_channels[j].value.monitoring_data_u32[i] = *((uint32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(uint32_t);
-                            break;
-                        case IL_REG_DTYPE_S32:
-                            net->monitoring_data_channels[j].value.monitoring_data_s32[i] = *((int32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(int32_t);
-                            break;
-                        case IL_REG_DTYPE_FLOAT:
-                            net->monitoring_data_channels[j].value.monitoring_data_flt[i] = *((float*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(float);
-                            break;
-                    }
-                }
-                pData += bytes_per_block;
-            }
+            net->monitoring_data_size = size;
+            r = il_net__monitoring_decode(net);
+            if (r < 0)
+                return r;
         }
         else {
             memcpy(buf, &(frame[ECAT_MCB_DATA_POS]), 2);
             uint16_t size = *(uint16_t*)buf;
-            memcpy(net->extended_buff, (char*)&(this->frame_received[14]), size);
+            if ((size_t)size > sizeof(net->extended_buff) ||
+                (size_t)size > sizeof(frame) - 14) {
+                ilerr__set("Extended payload exceeds the buffer");
+                return IL_EIO;
+            }
+
+            memcpy(net->extended_buff, (char*)&pBuf[14], size);
         }
     }
     else {
@@ -1569,27 +1720,20 @@ static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint
      int finished = 0;
      size_t pending_sz = sz;
 
-     uint16_t frame[1024];
-     size_t block_sz = 0;
+     uint16_t frame[ECAT_MCB_FRAME_SZ];
      uint16_t crc, hdr_l;
-     uint8_t *pBuf = (uint8_t*)&frame;
      uint8_t extended_bit = 0;
 
-    int r = osal_cond_wait(this->mailbox_check, this->lock_mailbox, this->recv_timeout/1000);
-
-    if (r == -2) {
-        return IL_ETIMEDOUT;
-    }
+     /* Obtain the frame received (payload already stored in place) */
+    int r = mailbox_frame_wait(this, frame, sizeof(frame), NULL);
     if (r < 0) {
-        return IL_EFAIL;
+        return r;
     }
-
-     /* Obtain the frame received */
-     memcpy(frame, (uint8_t*)&(this->frame_received), 1024);
+    size_t payload_len = (size_t)r;
 
      /* process frame: validate CRC, address, ACK */
      crc = *(uint16_t *)&frame[6];
-     uint16_t crc_res = crc_calc_ecat((uint16_t *)frame, 6);
+     uint16_t crc_res = il_crc__ccitt((uint16_t *)frame, 6 * sizeof(uint16_t));
      if (crc_res != crc) {
          ilerr__set("Communications error (CRC mismatch)");
          return IL_EIO;
@@ -1630,15 +1774,15 @@ static int net_recv(il_ecat_net_t *this, uint8_t subnode, uint16_t address, uint
             {
                 size = num_bytes;
             }
-            uint32_t start_addr = net->monitoring_data_size;
-            memcpy((uint16_t*)&net->monitoring_raw_data[start_addr], (uint16_t*)&(this->frame_received[14]), size);
+            if (payload_len < size)
+            {
+                size = (uint16_t)payload_len;
+            }
             net->monitoring_data_size += (uint32_t)size;
          }
          else
         {
              memcpy(buf, &(frame[ECAT_MCB_DATA_POS]), 2);
-             uint16_t size = *(uint16_t*)buf;
-             memcpy(net->extended_buff, (char*)&(this->frame_received[14]), size);
          }
      }
      else
@@ -1708,8 +1852,33 @@ static void LWIP_UdpReceiveData(void* net, struct udp_pcb* ptUdpPcb, struct pbuf
     const ip_addr_t* ptAddr, u16_t u16Port)
 {
     il_ecat_net_t *this = to_ecat_net((il_net_t*)net);
-    memcpy(this->frame_received, ptBuf->payload, ptBuf->len);
+
+    osal_mutex_lock(this->lock_mailbox);
+    if (this->payload_dst && ptBuf->tot_len > ECAT_MCB_FRAME_SZ * sizeof(uint16_t)) {
+        /* scatter: MCB frame to the mailbox, payload to its destination */
+        u16_t hdr_sz = ECAT_MCB_FRAME_SZ * sizeof(uint16_t);
+
+        pbuf_copy_partial(ptBuf, this->frame_received, hdr_sz, 0);
+        this->payload_len = pbuf_copy_partial(
+            ptBuf, this->payload_dst,
+            (u16_t)MIN((size_t)(ptBuf->tot_len - hdr_sz), this->payload_cap),
+            hdr_sz);
+    } else {
+        pbuf_copy_partial(ptBuf, this->frame_received,
+                          (u16_t)MIN(ptBuf->tot_len, sizeof(this->frame_received)), 0);
+        this->payload_len = 0;
+    }
+    this->frame_pending = 1;
+
+    /* acknowledges are counted for pipelined uploads */
+    uint16_t hdr_l;
+    memcpy(&hdr_l, &this->frame_received[ECAT_MCB_HDR_L_POS * sizeof(uint16_t)], sizeof(hdr_l));
+    if (((hdr_l & ECAT_MCB_CMD_MSK) >> ECAT_MCB_CMD_POS) != ECAT_MCB_CMD_ACK)
+        this->frames_nack = 1;
+    this->frames_rcvd++;
     osal_cond_signal(this->mailbox_check);
+    osal_mutex_unlock(this->lock_mailbox);
+
     pbuf_free(ptBuf);
 }
 
@@ -2782,43 +2951,9 @@ static int process_monitoring_data(il_ecat_net_t *this, il_net_t *net)
 {
     log_debug("Process monitoring data: %i", net->monitoring_data_size);
 
-    int num_mapped = net->monitoring_number_mapped_registers;
-    int bytes_per_block = net->monitoring_bytes_per_block;
-
-    int number_blocks = net->monitoring_data_size / bytes_per_block;
-    uint8_t* pData = net->monitoring_raw_data;
-
-    for (int i = 0; i < number_blocks; ++i)
-    {
-        int OffsetIndexIntraBlockInBytes = 0;
-        for (int j = 0; j < num_mapped; ++j)
-        {
-            il_reg_dtype_t type = net->monitoring_data_channels[j].type;
-            switch (type) {
-            case IL_REG_DTYPE_U16:
-                net->monitoring_data_channels[j].value.monitoring_data_u16[i] = *((uint16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(uint16_t);
-                break;
-            case IL_REG_DTYPE_S16:
-                net->monitoring_data_channels[j].value.monitoring_data_s16[i] = *((int16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(int16_t);
-                break;
-            case IL_REG_DTYPE_U32:
-                net->monitoring_data_channels[j].value.monitoring_data_u32[i] = *((uint32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(uint32_t);
-                break;
-            case IL_REG_DTYPE_S32:
-                net->monitoring_data_channels[j].value.monitoring_data_s32[i] = *((int32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(int32_t);
-                break;
-            case IL_REG_DTYPE_FLOAT:
-                net->monitoring_data_channels[j].value.monitoring_data_flt[i] = *((float*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(float);
-                break;
-            }
-        }
-        pData += bytes_per_block;
-    }
+    int r = il_net__monitoring_decode(net);
+    if (r < 0)
+        return r;
 
     log_debug("Data Processed");
     return 0;
@@ -2831,6 +2966,13 @@ int il_ecat_set_reconnection_retries(il_net_t *net, uint8_t retries)
     return 0;
 }
 
+int il_ecat_set_wait_write_timeout(il_net_t *net, uint32_t timeout)
+{
+    il_ecat_net_t *this = to_ecat_net(net);
+    this->wait_write_timeout = timeout;
+    return 0;
+}
+
 int il_ecat_set_recv_timeout(il_net_t *net, uint32_t timeout)
 {
     il_ecat_net_t *this = to_ecat_net(net);
@@ -2850,6 +2992,7 @@ const il_ecat_net_ops_t il_ecat_net_ops = {
     /* internal */
     ._read = il_ecat_net__read,
     ._write = il_ecat_net__write,
+    ._retain = il_ecat_net__retain,
     ._release = il_ecat_net__release,
     ._wait_write = il_ecat_net__wait_write,
     ._sw_subscribe = il_net_base__sw_subscribe,
@@ -2899,7 +3042,8 @@ const il_ecat_net_ops_t il_ecat_net_ops = {
     .net_test = il_ecat_net_test,
     .SDO_read = il_ecat_net_SDO_read,
     .SDO_read_complete_access = il_ecat_net_SDO_read_complete_access,
-    .SDO_write = il_ecat_net_SDO_write
+    .SDO_write = il_ecat_net_SDO_write,
+    .set_wait_write_timeout = il_ecat_set_wait_write_timeout
 };
 
 /** MCB network device monitor operations. */
@@ -10,7 +10,7 @@
 #ifdef _WIN32
 	#include <winsock2.h>
 #endif
-#ifdef linux
+#ifdef __linux__
 	#include <sys/socket.h>
 	#include <netinet/in.h>
 	#include <netinet/ip.h>
@@ -23,6 +23,12 @@
 /** Default read timeout. */
 #define READ_TIMEOUT_DEF	400000
 
+/** Default wait write timeout (ms). */
+#define WAIT_WRITE_TIMEOUT_DEF	2000
+
+/** Extended write frames kept outstanding during uploads. */
+#define EXT_WR_PIPELINE_DEPTH	4
+
 /** Vendor ID register address. */
 #define VENDOR_ID_ADDR		0x06E0
 
@@ -66,11 +72,25 @@ typedef struct il_ecat_net {
 	uint8_t reconnection_retries;
 	/** Recv timeout in ms*/
 	uint32_t recv_timeout;
+	/** Wait write timeout (ms). */
+	uint32_t wait_write_timeout;
 
 	uint8_t use_eoe_comms;
 
 	/** Mailbox vars*/
 	uint8_t frame_received[1024];
+	/** A received frame is pending to be processed. */
+	int frame_pending;
+	/** Extended payload destination (NULL to keep it in frame_received). */
+	uint8_t *payload_dst;
+	/** Extended payload destination size (bytes). */
+	size_t payload_cap;
+	/** Extended payload bytes stored at payload_dst. */
+	size_t payload_len;
+	/** Frames received (pipelined uploads). */
+	uint32_t frames_rcvd;
+	/** A NACK has been received (pipelined uploads). */
+	int frames_nack;
 	osal_cond_t *mailbox_check;
 	osal_mutex_t *lock_mailbox;
 	bool stop_mailbox;
@@ -22,150 +22,6 @@ static int not_supported(void)
 	return IL_ENOTSUP;
 }
 
-/**
- * Obtain the current statusword value.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- *
- * @return
- *	Statusword value.
- */
-static uint16_t sw_get(il_servo_t *servo, uint8_t subnode)
-{
-	// Init internal variables
-	double sw;
-	// Status word register
-	il_reg_t status_word_register = {
-		.subnode = subnode,
-		.address = 0x0011,
-		.dtype = IL_REG_DTYPE_U16,
-		.access = IL_REG_ACCESS_RW,
-		.phy = IL_REG_PHY_NONE,
-		.range = {
-			.min.u16 = 0,
-			.max.u16 = UINT16_MAX
-		},
-		.labels = NULL,
-		.enums = NULL,
-		.enums_count = 0
-	};
-	(void)il_servo_read(servo, &status_word_register, NULL, &sw);
-	if (servo->sw.value != sw) {
-		servo->sw.value = sw;
-		osal_cond_broadcast(servo->sw.changed);
-	}
-
-	return sw;
-}
-
-/**
- * Wait until the statusword changes its value.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- * @param [in, out] sw
- *	Current statusword value, where next value will be stored.
- * @param [in, out] timeout
- *	Timeout (ms), if positive will be updated with remaining ms.
- *
- * @return
- *	0 on success, error code otherwise.
- */
-static int sw_wait_change(il_servo_t *servo, uint16_t *sw, int *timeout, uint8_t subnode)
-{
-	int r = 0;
-	uint16_t buff;
-	osal_timespec_t start = { 0, 0 }, end, diff;
-	// Status word register
-	il_reg_t status_word_register = {
-		.subnode = subnode,
-		.address = 0x0011,
-		.dtype = IL_REG_DTYPE_U16,
-		.access = IL_REG_ACCESS_RW,
-		.phy = IL_REG_PHY_NONE,
-		.range = {
-			.min.u16 = 0,
-			.max.u16 = UINT16_MAX
-		},
-		.labels = NULL,
-		.enums = NULL,
-		.enums_count = 0
-	};
-
-	/* obtain start time */
-	if (*timeout > 0) {
-		if (osal_clock_gettime(&start) < 0) {
-			ilerr__set("Could not obtain system time");
-			return IL_EFAIL;
-		}
-	}
-	double time_s = 0;
-	time_s = (double) *timeout / 1000;
-	(void)il_servo_raw_read_u16(servo, &status_word_register, NULL, &buff);
-	while (buff == *sw) {
-		osal_clock_gettime(&diff);
-		if (diff.s > start.s + time_s) {
-			ilerr__set("Operation timed out");
- 			r = IL_ETIMEDOUT;
- 			goto unlock;
-		}
-		(void)il_servo_raw_read_u16(servo, &status_word_register, NULL, &buff);
-	}
-
-	servo->sw.value = buff;
-	*sw = buff;
-
-out:
-
-unlock:
-
-	return r;
-}
-
-/**
- * Wait until the statusword has the requested value
- *
- * @note
- *	The timeout is not an absolute timeout, but an interval timeout.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- * @param [in] msk
- *	Statusword mask.
- * @param [in] val
- *	Statusword value.
- * @param [in] timeout
- *	Timeout (ms).
- */
-static int sw_wait_value(il_servo_t *servo, uint16_t msk, uint16_t val,
-			 int timeout)
-{
-	int r = 0;
-	uint16_t result;
-
-	/* wait until the flag changes to the requested state */
-
-	do {
-		result = servo->sw.value & msk;
-		if (result != val) {
-			r = osal_cond_wait(servo->sw.changed, servo->sw.lock,
-					   timeout);
-			if (r == OSAL_ETIMEDOUT) {
-				ilerr__set("Operation timed out");
-				r = IL_ETIMEDOUT;
-			} else if (r < 0) {
-				ilerr__set("Statusword wait change failed");
-				r = IL_EFAIL;
-			}
-		}
-	} while ((result != val) && (r == 0));
-
-
-	return r;
-}
-
-
 /**
  * Destroy servo instance.
  *
@@ -378,7 +234,7 @@ static int il_ecat_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout
 	int r;
 	uint16_t sw;
 	il_servo_state_t state;
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -390,7 +246,7 @@ static int il_ecat_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout
 			if (r < 0)
 				return r;
 
-			sw = sw_get(servo, subnode);
+			(void)il_servo_base__sw_read(servo, subnode, &sw);
 		/* check state and command action to reach disabled */
 		} else if (state != IL_SERVO_STATE_DISABLED) {
 			IL_REG_MCB_CTL_WORD.subnode = subnode;
@@ -400,7 +256,8 @@ static int il_ecat_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout
 				return r;
 
 			/* wait until statusword changes */
-			r = sw_wait_change(servo, &sw, &timeout, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout);
 			if (r < 0)
 				return r;
 		}
@@ -416,7 +273,7 @@ static int il_ecat_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subno
 	il_servo_state_t state;
 	int timeout_ = timeout;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -428,7 +285,7 @@ static int il_ecat_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subno
 			if (r < 0)
 				return r;
 
-			sw = sw_get(servo, subnode);
+			(void)il_servo_base__sw_read(servo, subnode, &sw);
 		/* check state and command action to reach switch on */
 		} else if (state != IL_SERVO_STATE_ON) {
 			if (state == IL_SERVO_STATE_FAULT)
@@ -451,7 +308,8 @@ static int il_ecat_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subno
 				return r;
 
 			/* wait for state change */
-			r = sw_wait_change(servo, &sw, &timeout_, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout_);
 			if (r < 0)
 				return r;
 		}
@@ -467,7 +325,7 @@ static int il_ecat_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 	il_servo_state_t state;
 	int timeout_ = timeout;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	servo->ops->_state_decode(sw, &state, NULL);
 
@@ -478,10 +336,10 @@ static int il_ecat_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 		if (r < 0)
 			return r;
 
-		sw = sw_get(servo, subnode);
+		(void)il_servo_base__sw_read(servo, subnode, &sw);
 	}
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
 
@@ -505,7 +363,8 @@ static int il_ecat_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 				return r;
 
 			/* wait for state change */
-			r = sw_wait_change(servo, &sw, &timeout_, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout_);
 			if (r < 0)
 				return r;
 
@@ -522,7 +381,7 @@ static int il_ecat_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int tim
 	il_servo_state_t state;
 	int retries = 0;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -547,7 +406,8 @@ static int il_ecat_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int tim
 				return r;
 
 			/* wait until statusword changes */
-			r = sw_wait_change(servo, &sw, &timeout, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout);
 			if (r < 0)
 				return r;
 
@@ -709,7 +569,8 @@ static int il_ecat_servo_velocity_res_get(il_servo_t *servo, uint32_t *res)
 
 static int il_ecat_servo_wait_reached(il_servo_t *servo, int timeout)
 {
-	return sw_wait_value(servo, IL_MC_SW_TR, IL_MC_SW_TR, timeout);
+	return il_servo_base__sw_wait_value(servo, 1, IL_MC_SW_TR, IL_MC_SW_TR,
+					    timeout);
 }
 
 
@@ -756,6 +617,7 @@ const il_servo_ops_t il_ecat_servo_ops = {
 	.raw_read_s64 = il_servo_base__raw_read_s64,
 	.raw_read_float = il_servo_base__raw_read_float,
 	.read = il_servo_base__read,
+	.read_many = il_servo_base__read_many,
 	.raw_write_u8 = il_servo_base__raw_write_u8,
 	.raw_write_s8 = il_servo_base__raw_write_s8,
 	.raw_write_u16 = il_servo_base__raw_write_u16,
@@ -767,6 +629,7 @@ const il_servo_ops_t il_ecat_servo_ops = {
 	.raw_write_s64 = il_servo_base__raw_write_s64,
 	.raw_write_float = il_servo_base__raw_write_float,
 	.write = il_servo_base__write,
+	.write_many = il_servo_base__write_many,
 	.disable = il_ecat_servo_disable,
 	.switch_on = il_ecat_servo_switch_on,
 	.enable = il_ecat_servo_enable,
@@ -9,6 +9,12 @@
 /** Ethernet MCB frame size (words). */
 #define ETH_MCB_FRAME_SZ	7
 
+/** Ethernet MCB maximum extended payload size (bytes). */
+#define ETH_MCB_EXT_MAX_SZ	2048
+
+/** Ethernet MCB extended write payload size per frame (bytes). */
+#define ETH_MCB_EXT_WR_SZ	1010
+
 /** Ethernet MCB Header */
 /** Ethernet MCB frame header high word position. */
 #define ETH_MCB_HDR_H_POS	0
@@ -40,6 +46,8 @@
 
 /** Ethernet MCB default node */
 #define ETH_MCB_NODE_DFLT   0xA
+/** Ethernet MCB frame header, subnode mask */
+#define ETH_MCB_SUBNODE_MSK	0x000F
 
 
 /** Ethernet MCB frame header, pending bit */
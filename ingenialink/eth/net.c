@@ -2,6 +2,7 @@
     #define _WINSOCKAPI_ 
     #include <windows.h>
 #else
+    #define _GNU_SOURCE
     #include <unistd.h>
     #include <errno.h>
     #include <sys/time.h>
@@ -16,6 +17,7 @@
 #include <stdbool.h>
 #include <fcntl.h>
 
+#include "ingenialink/crc.h"
 #include "ingenialink/err.h"
 #include "ingenialink/base/net.h"
 #include "external/log.c/src/log.h"
@@ -25,6 +27,7 @@
 ******************************************************************************/
 static int il_net_reconnect(il_net_t *net);
 static int process_monitoring_data(il_eth_net_t *this, il_net_t *net);
+static int monitoring_download_locked(il_eth_net_t *this);
 static int il_eth_net_recv_monitoring(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
                                       size_t sz, uint8_t *monitoring_raw_data, il_net_t *net, int num_bytes);
 static int il_eth_net_remove_all_mapped_registers_v1(il_net_t *net);
@@ -39,12 +42,28 @@ static int il_eth_net_disturbance_set_mapped_register_v1(il_net_t *net, int chan
 static int il_eth_net_disturbance_set_mapped_register_v2(il_net_t *net, int channel, uint32_t address,
                                                          uint8_t subnode, il_reg_dtype_t dtype, uint8_t size);
 static int net_recv(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
-                    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net);
+                    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net,
+                    const osal_timespec_t *deadline);
 static int net_send(il_eth_net_t *this, uint8_t subnode, uint16_t address, const void *data,
-                    size_t sz, uint16_t extended, il_net_t *net);
-static int il_eth_net__read_monitoring(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-                                       void *buf, size_t sz);
-static void il_eth_net_close_socket(il_net_t *net);																														
+                    size_t sz);
+static int net_send_ext(il_eth_net_t *this, uint8_t subnode, uint16_t address,
+                        const uint8_t *payload, size_t sz);
+static int disturbance_upload_locked(il_eth_net_t *this, uint8_t subnode,
+                                     uint16_t address);
+static int net_recv_frame(il_eth_net_t *this, uint16_t *frame, size_t sz,
+                          const osal_timespec_t *deadline);
+static void net_drain(il_eth_net_t *this, size_t cnt);
+static int net_recv_scatter(il_eth_net_t *this, uint16_t *frame,
+                            uint8_t *payload, size_t payload_sz);
+static void frame_build(uint16_t *frame, uint8_t subnode, uint16_t address,
+                        uint8_t cmd, uint16_t extended, uint64_t d);
+static int net_send_burst(il_eth_net_t *this,
+                          uint16_t (*frames)[ETH_MCB_FRAME_SZ], size_t cnt);
+static int net_recv_burst(il_eth_net_t *this,
+                          uint16_t (*frames)[ETH_MCB_FRAME_SZ], size_t cnt);
+static int reactor_submit(il_eth_net_t *this, eth_job_t *job);
+static void reactor_disable(il_eth_net_t *this);
+static int il_eth_net_close_socket(il_net_t *net);																														
 
 int il_net_monitoring_mapping_registers[16] = {
     0x0D0,
@@ -96,6 +115,10 @@ static void eth_net_destroy(void *ctx)
 
     il_net_base__deinit(&this->net);
 
+    osal_cond_destroy(this->reactor_drained);
+    osal_cond_destroy(this->reactor_cond);
+    osal_mutex_destroy(this->reactor_lock);
+
     free(this);
 }
 
@@ -104,96 +127,6 @@ static int not_supported(void)
     return ilerr__eth(IL_ENOTSUP);
 }
 
-bool crc_tabccitt_init_eth = false;
-uint16_t crc_tabccitt_eth[256];
-
-/**
-* Compute CRC of the given buffer.
-*
-* @param [in] buf
-*	Buffer.
-* @param [in] sz
-*	Buffer size (bytes).
-*
-* @return
-*	CRC.
-*/
-static void init_crcccitt_tab_eth(void) {
-
-    uint16_t i;
-    uint16_t j;
-    uint16_t crc;
-    uint16_t c;
-
-    for (i = 0; i<256; i++) {
-        crc = 0;
-        c = i << 8;
-        for (j = 0; j<8; j++) {
-            if ((crc ^ c) & 0x8000) crc = (crc << 1) ^ 0x1021;
-            else crc = crc << 1;
-            c = c << 1;
-        }
-        crc_tabccitt_eth[i] = crc;
-    }
-    crc_tabccitt_init_eth = true;
-}
-
-static uint16_t update_crc_ccitt_eth(uint16_t crc, unsigned char c) {
-
-    if (!crc_tabccitt_init_eth) init_crcccitt_tab_eth();
-    return (crc << 8) ^ crc_tabccitt_eth[((crc >> 8) ^ (uint16_t)c) & 0x00FF];
-
-}
-
-static uint16_t crc_calc_eth(const uint16_t *buf, uint16_t u16Sz)
-{
-
-    uint16_t crc = 0x0000;
-    uint8_t* pu8In = (uint8_t*)buf;
-
-    for (uint16_t u16Idx = 0; u16Idx < u16Sz * 2; u16Idx++)
-    {
-        crc = update_crc_ccitt_eth(crc, pu8In[u16Idx]);
-    }
-    return crc;
-}
-
-/**
-* Process asynchronous statusword messages.
-*
-* @param [in] this
-*	ETH Network.
-* @param [in] frame
-*	IngeniaLink frame.
-*/
-static void process_statusword(il_eth_net_t *this, uint8_t subnode, uint16_t *data)
-{
-    il_net_sw_subscriber_lst_t *subs;
-    int i;
-    uint8_t id;
-    uint16_t sw;
-
-    subs = &this->net.sw_subs;
-
-    id = subnode;
-    sw = data;
-
-    osal_mutex_lock(subs->lock);
-
-    for (i = 0; i < subs->sz; i++) {
-        if (subs->subs[i].id == id && subs->subs[i].cb) {
-            void *ctx;
-
-            ctx = subs->subs[i].ctx;
-            subs->subs[i].cb(ctx, sw);
-
-            break;
-        }
-    }
-
-    osal_mutex_unlock(subs->lock);
-}
-
 /**
 * Listener thread.
 *
@@ -212,16 +145,19 @@ restart:
     while (error_count < this->reconnection_retries && this != NULL && this->stop_reconnect == 0 ) {
         uint16_t sw;
 
-        /* try to read the status word register to see if a servo is alive */
+        /* try to read the status word register to see if a servo is alive,
+         * unless regular traffic already proved it recently (the read
+         * notifies statusword subscribers by itself) */
         if (this != NULL && this->status_check_stop == 0) {
-            r = il_net__read(&this->net, 1, 1, STATUSWORD_ADDRESS, &sw, sizeof(sw));
+            r = 0;
+            if (il_net__heartbeat_due(&this->net))
+                r = il_net__read(&this->net, 1, 1, STATUSWORD_ADDRESS, &sw, sizeof(sw));
             if (r < 0) {
                 error_count = error_count + 1;
             }
             else {
                 error_count = 0;
                 this->stop = 0;
-                process_statusword(this, 1, sw);
             }
         }
         Sleep(500);
@@ -237,7 +173,7 @@ err:
         ilerr__set("Device at %s disconnected\n", this->address_ip);
         il_net__state_set(&this->net, IL_NET_STATE_DISCONNECTED);
         il_eth_net_close_socket(&this->net);
-        r = il_net_reconnect(this);
+        r = il_net_reconnect(&this->net);
         if (r == 0) goto restart;
     }
     return 0;
@@ -294,18 +230,43 @@ static il_net_t *il_eth_net_create(const il_net_opts_t *opts)
     this->port_ip = opts->port_ip;
     this->protocol = opts->protocol;
     this->reconnection_retries = RECONNECTION_RETRIES_DEF;
+    this->backoff_base = RECONNECT_BACKOFF_BASE_DEF;
+    this->backoff_max = RECONNECT_BACKOFF_MAX_DEF;
     this->stop_reconnect = 1;
     this->status_check_stop = 1;
     this->recv_timeout = READ_TIMEOUT_DEF;
+    this->pipeline_depth = PIPELINE_DEPTH_DEF;
+    this->wait_write_timeout = WAIT_WRITE_TIMEOUT_DEF;
 
     /* setup refcnt */
     this->refcnt = il_utils__refcnt_create(eth_net_destroy, this);
     if (!this->refcnt)
         goto cleanup_refcnt;
+
+    /* reactor synchronization (kept for the network lifetime, so that
+     * submitters racing with reactor_disable never see it destroyed) */
+    this->reactor_lock = osal_mutex_create();
+    if (!this->reactor_lock) {
+        ilerr__set("Reactor lock allocation failed");
+        goto cleanup_refcnt;
+    }
+
+    this->reactor_cond = osal_cond_create();
+    if (!this->reactor_cond) {
+        ilerr__set("Reactor condition allocation failed");
+        goto cleanup_reactor_lock;
+    }
+
+    this->reactor_drained = osal_cond_create();
+    if (!this->reactor_drained) {
+        ilerr__set("Reactor condition allocation failed");
+        goto cleanup_reactor_cond;
+    }
+
     if (opts->connect_slave != 0) {
         r = il_net_connect(&this->net);
         if (r < 0)
-            goto cleanup_this;
+            goto cleanup_reactor_drained;
     }
 
     this->listener = NULL;
@@ -324,6 +285,15 @@ static il_net_t *il_eth_net_create(const il_net_opts_t *opts)
 
     return &this->net;
 
+cleanup_reactor_drained:
+    osal_cond_destroy(this->reactor_drained);
+
+cleanup_reactor_cond:
+    osal_cond_destroy(this->reactor_cond);
+
+cleanup_reactor_lock:
+    osal_mutex_destroy(this->reactor_lock);
+
 cleanup_refcnt:
     il_utils__refcnt_destroy(this->refcnt);
 
@@ -333,19 +303,24 @@ cleanup_this:
     return NULL;
 }
 
-static void il_eth_net_close_socket(il_net_t *net) {
+static int il_eth_net_close_socket(il_net_t *net) {
     il_eth_net_t *this = to_eth_net(net);
 
     int r = 0;
+    /* close even if the shutdown fails (e.g. the socket never connected) */
     #ifdef _WIN32
-        r = shutdown(this->server, SD_BOTH);
-        if (r == 0) { r = closesocket(this->server); }
+        (void)shutdown(this->server, SD_BOTH);
+        r = closesocket(this->server);
     #else
-        r = shutdown(this->server, SHUT_RDWR);
-        if (r == 0) { r = close(this->server); }
+        if (this->server < 0)
+            return 0;
+
+        (void)shutdown(this->server, SHUT_RDWR);
+        r = close(this->server);
+        this->server = -1;
     #endif
 
-    return r;	
+    return r;
 }
 
 static int il_eth_net_init_socket(void)
@@ -381,6 +356,8 @@ static int il_eth_get_last_socket_error(void)
 static void il_eth_net_destroy(il_net_t *net)
 {
     il_eth_net_t *this = to_eth_net(net);
+
+    reactor_disable(this);
     il_utils__refcnt_release(this->refcnt);
 }
 
@@ -507,106 +484,185 @@ static int il_eth_net_is_slave_connected(il_net_t *net, const char *ip) {
 
 }
 
+/**
+ * Open the socket and connect it to the drive.
+ *
+ * @note
+ *	The connection is made in non-blocking mode, so that an unreachable
+ *	drive does not block for longer than the given timeout (UDP sockets
+ *	connect immediately).
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] timeout
+ *	Connection timeout (ms).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int socket_open(il_eth_net_t *this, int timeout)
+{
+    unsigned long iMode = 1;
+    int r, so_err = 0;
+    #ifdef _WIN32
+        int len = sizeof(so_err);
+    #else
+        socklen_t len = sizeof(so_err);
+    #endif
+
+    if (this->protocol == 1)
+        this->server = socket(AF_INET, SOCK_STREAM, 0);
+    else
+        this->server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    #ifdef _WIN32
+        (void)ioctlsocket(this->server, FIONBIO, &iMode);
+    #else
+        (void)ioctl(this->server, FIONBIO, &iMode);
+    #endif
+
+    r = connect(this->server, (struct sockaddr *)&this->addr, sizeof(this->addr));
+    if (r < 0) {
+        int err = il_eth_get_last_socket_error();
+        fd_set Write, Err;
+        struct timeval Timeout;
+
+        #ifdef _WIN32
+            if (err != WSAEWOULDBLOCK)
+                goto cleanup_socket;
+        #else
+            if (err != EINPROGRESS && err != EWOULDBLOCK)
+                goto cleanup_socket;
+        #endif
+
+        FD_ZERO(&Write);
+        FD_ZERO(&Err);
+        FD_SET(this->server, &Write);
+        FD_SET(this->server, &Err);
+        Timeout.tv_sec = timeout / 1000;
+        Timeout.tv_usec = (timeout % 1000) * 1000;
+
+        r = select((int)this->server + 1, NULL, &Write, &Err, &Timeout);
+        if (r <= 0)
+            goto cleanup_socket;
+
+        r = getsockopt(this->server, SOL_SOCKET, SO_ERROR, (char *)&so_err, &len);
+        if (r < 0 || so_err != 0)
+            goto cleanup_socket;
+    }
+
+    iMode = 0;
+    #ifdef _WIN32
+        (void)ioctlsocket(this->server, FIONBIO, &iMode);
+    #else
+        (void)ioctl(this->server, FIONBIO, &iMode);
+    #endif
+
+    return 0;
+
+cleanup_socket:
+    #ifdef _WIN32
+        closesocket(this->server);
+    #else
+        close(this->server);
+        this->server = -1;
+    #endif
+
+    ilerr__set("Could not connect to %s", this->address_ip);
+
+    return IL_EDISCONN;
+}
+
+/**
+ * Obtain the next jittered reconnection delay.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] delay
+ *	Backoff interval (ms).
+ *
+ * @return
+ *	Delay, between half and the full backoff interval (ms).
+ */
+static uint32_t backoff_jitter(il_eth_net_t *this, uint32_t delay)
+{
+    uint32_t x = this->backoff_seed;
+
+    /* xorshift32 */
+    if (x == 0) {
+        osal_timespec_t now;
+
+        (void)osal_clock_gettime(&now);
+        x = (uint32_t)now.ns ^ (uint32_t)(uintptr_t)this ^ 0x9E3779B9u;
+        if (x == 0)
+            x = 1;
+    }
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    this->backoff_seed = x;
+
+    return delay / 2 + x % (delay / 2 + 1);
+}
+
+/**
+ * Reconnect to the drive.
+ *
+ * @note
+ *	The first attempt is made immediately, subsequent ones after a jittered
+ *	exponential backoff (see il_net_set_reconnection_backoff). A reconnection
+ *	is only considered successful once the drive answers, and the session
+ *	state is then restored before the network is reported as connected.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @return
+ *	0 if reconnected, non-zero if reconnection was stopped.
+ */
 static int il_net_reconnect(il_net_t *net)
 {
     il_eth_net_t *this = to_eth_net(net);
-    this->stop = 1;
-    int r = -1;
+    uint32_t backoff = 0;
     uint16_t sw;
-    while (r < 0 && this->stop_reconnect == 0)
-    {
+    int r;
+
+    this->stop = 1;
+
+    while (this->stop_reconnect == 0) {
+        if (backoff > 0)
+            Sleep(backoff_jitter(this, backoff));
+
         log_debug("Reconnecting...");
-        if (this->protocol == 1)
-        {
-            this->server = socket(AF_INET, SOCK_STREAM, 0);
-        }
-        else {
-            this->server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-        }
 
-        //set the socket in non-blocking
-        unsigned long iMode = 1;
-        #ifdef _WIN32
-            r = ioctlsocket(this->server, FIONBIO, &iMode);		
-            long no_err = NO_ERROR;
-        #else
-            r = ioctl(this->server, FIONBIO, &iMode);	
-            int no_err = 0;
-        #endif
-        if (r != no_err)
-        {
-            log_warn("ioctlsocket failed with error: %ld", r);
-        }
-        r = connect(this->server, (struct sockaddr *)&this->addr, sizeof(this->addr));
-        if (r < 0) {
-            int err = il_eth_get_last_socket_error();
-            // check if error was WSAEWOULDBLOCK, where we'll wait
-            if (
-                #ifdef WINDOWS
-                    err == WSAEWOULDBLOCK
-                #else
-                    err == EWOULDBLOCK
-                #endif
-                ){
-                log_debug("Attempting to connect.\n");
-                fd_set Write, Err;
-                struct timeval Timeout;
-                Timeout.tv_sec = 2;
-                Timeout.tv_usec = 0;
+        osal_mutex_lock(this->net.lock);
+        r = socket_open(this, RECONNECT_CONNECT_TIMEOUT);
+        osal_mutex_unlock(this->net.lock);
 
-                FD_ZERO(&Write);
-                FD_ZERO(&Err);
-                FD_SET(this->server, &Write);
-                FD_SET(this->server, &Err);
-                r = select(0, NULL, &Write, &Err, &Timeout);
-                if (r == 0) {
-                    log_warn("Timeout during connection");
-                }
-                else {
-                    if (FD_ISSET(this->server, &Write)) {
-                        log_info("Reconnected to the Server");
-                        this->stop = 0;
-                    }
-                    if (FD_ISSET(this->server, &Err)) {
-                        log_warn("Error reconnecting");
-                    }
-                }
-            }
-            else {
-                int last_error = il_eth_get_last_socket_error();
-                log_warn("Fail connecting to server");
-            }
-        }
-        else {
-            log_info("Connected to the Server");
+        if (r == 0) {
             r = il_net__read(&this->net, 1, 1, STATUSWORD_ADDRESS, &sw, sizeof(sw));
-            if (r < 0)
-            {
-                log_warn("Fail connecting to server");
-            }
-            else
-            {
-                this->stop = 0;
-                this->stop_reconnect = 0;
-                log_info("DEVICE RECONNECTED!");
-                il_net__state_set(&this->net, IL_NET_STATE_CONNECTED);
-            }
-        }
-        iMode = 0;
-        int r = -1;
-        #ifdef _WIN32
-            r = ioctlsocket(this->server, FIONBIO, &iMode);		
-        #else
-            r = ioctl(this->server, FIONBIO, &iMode);	
-        #endif
-        if (r != no_err)
-        {
-            log_warn("ioctlsocket failed with error: %ld", r);
+            if (r == 0)
+                break;
+
+            il_eth_net_close_socket(&this->net);
         }
-        Sleep(1000);
+
+        backoff = backoff ? MIN(backoff * 2, this->backoff_max) : this->backoff_base;
     }
-    r = this->stop_reconnect;
-    return r;
+
+    if (this->stop_reconnect != 0)
+        return this->stop_reconnect;
+
+    r = il_net__session_restore(&this->net);
+    if (r < 0)
+        log_warn("Session could not be fully restored: %s", ilerr_last());
+
+    this->stop = 0;
+    log_info("DEVICE RECONNECTED!");
+    il_net__state_set(&this->net, IL_NET_STATE_CONNECTED);
+
+    return 0;
 }
 
 static int il_eth_net_connect(il_net_t *net, const char *ip)
@@ -740,6 +796,13 @@ static int il_eth_net_connect(il_net_t *net, const char *ip)
     return 0;
 }
 
+static void il_eth_net__retain(il_net_t *net)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    il_utils__refcnt_retain(this->refcnt);
+}
+
 static void il_eth_net__release(il_net_t *net)
 {
     il_eth_net_t *this = to_eth_net(net);
@@ -818,7 +881,7 @@ static int il_eth_net_remove_all_mapped_registers(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_eth_net_remove_all_mapped_registers_v1(net);
@@ -842,6 +905,8 @@ static int il_eth_net_remove_all_mapped_registers_v1(il_net_t *net)
     }
 
     net->monitoring_number_mapped_registers = 0;
+    il_net__monitoring_release(net);
+
     return r;
 }
 
@@ -857,6 +922,8 @@ static int il_eth_net_remove_all_mapped_registers_v2(il_net_t *net)
     }
 
     net->monitoring_number_mapped_registers = 0;
+    il_net__monitoring_release(net);
+
     return r;
 }
 
@@ -865,7 +932,7 @@ static int il_eth_net_remove_all_mapped_registers_v2(il_net_t *net)
 /**
 * Monitoring set mapped registers
 */
-static int *il_eth_net_set_mapped_register(il_net_t *net, int channel, uint32_t address,
+static int il_eth_net_set_mapped_register(il_net_t *net, int channel, uint32_t address,
                                             uint8_t subnode, il_reg_dtype_t dtype,
                                             uint8_t size)
 {
@@ -874,7 +941,7 @@ static int *il_eth_net_set_mapped_register(il_net_t *net, int channel, uint32_t
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_eth_net_set_mapped_register_v1(net, channel, address, dtype);
@@ -893,7 +960,9 @@ static int il_eth_net_set_mapped_register_v1(il_net_t *net, int channel, uint32_
     int r = 0;
     il_eth_net_t *this = to_eth_net(net);
 
-    net->monitoring_data_channels[channel].type = dtype;
+    r = il_net__monitoring_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     // Map address
     r = il_net__write(&this->net, 1, 0, 0x00E0, &address, 2, 1, 0);
@@ -906,6 +975,8 @@ static int il_eth_net_set_mapped_register_v1(il_net_t *net, int channel, uint32_
     if (r < 0) {
 
     }
+    if (r >= 0)
+        r = il_net__monitoring_layout_update(net);
 
     return r;
 }
@@ -917,7 +988,14 @@ static int il_eth_net_set_mapped_register_v2(il_net_t *net, int channel, uint32_
     int r = 0;
     il_eth_net_t *this = to_eth_net(net);
 
-    net->monitoring_data_channels[channel].type = dtype;
+    if (net->monitoring_number_mapped_registers >= ARRAY_SIZE(il_net_monitoring_mapping_registers)) {
+        ilerr__set("No monitoring mapping registers left");
+        return IL_EINVAL;
+    }
+
+    r = il_net__monitoring_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     uint16_t frame[2];
     uint16_t hdr_h, hdr_l;
@@ -942,6 +1020,8 @@ static int il_eth_net_set_mapped_register_v2(il_net_t *net, int channel, uint32_
     if (r < 0) {
 
     }
+    if (r >= 0)
+        r = il_net__monitoring_layout_update(net);
 
     return r;
 }
@@ -958,7 +1038,7 @@ static int il_eth_net_disturbance_remove_all_mapped_registers(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_eth_net_disturbance_remove_all_mapped_registers_v1(net);
@@ -981,6 +1061,7 @@ static int il_eth_net_disturbance_remove_all_mapped_registers_v1(il_net_t *net)
     }
 
     net->disturbance_number_mapped_registers = 0;
+    il_net__disturbance_release(net);
     return r;
 }
 
@@ -996,6 +1077,7 @@ static int il_eth_net_disturbance_remove_all_mapped_registers_v2(il_net_t *net)
     }
 
     net->disturbance_number_mapped_registers = 0;
+    il_net__disturbance_release(net);
     return r;
 }
 
@@ -1011,7 +1093,7 @@ static int il_eth_net_disturbance_set_mapped_register(il_net_t *net, int channel
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old monitoring implementation
         r = il_eth_net_disturbance_set_mapped_register_v1(net, channel, address, subnode, dtype, size);
@@ -1031,7 +1113,9 @@ static int il_eth_net_disturbance_set_mapped_register_v1(il_net_t *net, int chan
     il_eth_net_t *this = to_eth_net(net);
 
     // Always 0 for the moment
-    net->disturbance_data_channels[channel].type = dtype;
+    r = il_net__disturbance_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     // Map address
     r = il_net__write(&this->net, 1, 0, 0x00E5, &address, 2, 1, 0);
@@ -1049,7 +1133,9 @@ static int il_eth_net_disturbance_set_mapped_register_v2(il_net_t *net, int chan
     int r = 0;
     il_eth_net_t *this = to_eth_net(net);
 
-    net->disturbance_data_channels[channel].type = dtype;
+    r = il_net__disturbance_channel_set(net, channel, dtype);
+    if (r < 0)
+        return r;
 
     uint16_t frame[2];
     uint16_t hdr_h, hdr_l;
@@ -1086,7 +1172,7 @@ static int il_eth_net_enable_disturbance(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old version
         r = il_net__write(&this->net, 1, 0, 0x00C0, &enable_disturbance_val, 2, 1, 0);
@@ -1128,7 +1214,7 @@ static int il_eth_net_disable_disturbance(il_net_t *net)
 
     // Check the Monitoring/Disturbance version
     uint32_t mon_dist_version = 0;
-    r = il_net__read(&this->net, 1, 0, 0x00BA, &mon_dist_version, sizeof(uint32_t));
+    r = il_net__mon_dist_version_get(&this->net, &mon_dist_version);
     if (r < 0) {
         // Old version
         r = il_net__write(&this->net, 1, 0, 0x00C0, &disable_disturbance_val, 2, 1, 0);
@@ -1227,16 +1313,15 @@ static int il_eth_net_read_monitoring_data(il_net_t *net)
 {
     int r = 0;
     il_eth_net_t *this = to_eth_net(net);
+    eth_job_t job = { .type = ETH_JOB_MONITORING };
 
-    uint64_t vid;
-
+    if (reactor_submit(this, &job))
+        return job.r;
 
     osal_mutex_lock(this->net.lock);
-    r = il_eth_net__read_monitoring(&this->net, 1, 0, 0x00B2, &vid, sizeof(vid));
-    if (r < 0) {
-
-    }
+    r = monitoring_download_locked(this);
     osal_mutex_unlock(this->net.lock);
+
     return r;
 }
 
@@ -1293,247 +1378,1256 @@ static void il_eth_net_dev_mon_stop(il_net_dev_mon_t *mon)
 	}
 }
 
+/** Register read (net.lock held). */
+static int read_locked(il_eth_net_t *this, uint8_t subnode, uint16_t address,
+                       void *buf, size_t sz)
+{
+    int r;
+
+    r = net_send(this, subnode, address, NULL, 0);
+    if (r < 0)
+        return r;
+
+    uint16_t *monitoring_raw_data = NULL;
+    return net_recv(this, subnode, address, buf, sz, monitoring_raw_data,
+                    &this->net, NULL);
+}
+
 static int il_eth_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
     void *buf, size_t sz)
 {
     il_eth_net_t *this = to_eth_net(net);
+    eth_job_t job = { .type = ETH_JOB_READ, .subnode = subnode,
+                      .address = (uint16_t)address, .buf = buf, .sz = sz };
     int r;
     (void)id;
 
-    osal_mutex_lock(this->net.lock);
-    r = net_send(this, subnode, (uint16_t)address, NULL, 0, 0, net);
-    if (r < 0) {
-        goto unlock;
-    }
-    uint16_t *monitoring_raw_data = NULL;
-    r = net_recv(this, subnode, (uint16_t)address, buf, sz, monitoring_raw_data, net);
-    if (r < 0)
-        goto unlock;
+    if (reactor_submit(this, &job))
+        return job.r;
 
-unlock:
+    osal_mutex_lock(this->net.lock);
+    r = read_locked(this, subnode, (uint16_t)address, buf, sz);
     osal_mutex_unlock(this->net.lock);
 
     return r;
 }
 
-static int il_eth_net__read_monitoring(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-    void *buf, size_t sz)
+/**
+ * Download the monitoring data (net.lock held).
+ *
+ * @note
+ *	The number of bytes available (0x00B7) is read once, then data blocks
+ *	(0x00B2) are requested back-to-back keeping up to pipeline_depth of
+ *	them outstanding, each block being received straight into the raw
+ *	monitoring buffer. The number of bytes available is only checked again
+ *	once all of them have been received.
+ *
+ * @param [in] this
+ *	ETH network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int monitoring_download_locked(il_eth_net_t *this)
 {
-    il_eth_net_t *this = to_eth_net(net);
+    il_net_t *net = &this->net;
+    osal_timespec_t start;
+    size_t got, block_sz = 0, in_flight, blocks = 0;
+    int32_t num_bytes;
     int r;
-    (void)id;
 
-    int num_bytes;
-    r = il_net__read(&this->net, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
-    if (r < 0)
-    {
+    r = read_locked(this, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+    if (r < 0) {
         // Old monitoring method
         uint64_t vid;
-        r = il_net__read(&this->net, 1, 0, 0x00B2, &vid, sizeof(vid));
-    }
-    else
-    {
-        // Initialize monitoring data size value
-        net->monitoring_data_size = 0;
+        return read_locked(this, 0, 0x00B2, &vid, sizeof(vid));
+    }
+
+    // Initialize monitoring data size value
+    net->monitoring_data_size = 0;
+    (void)osal_clock_gettime(&start);
+
+    while (num_bytes > 0) {
+        got = 0;
+        in_flight = 0;
+
+        while (got < (size_t)num_bytes) {
+            /* request blocks until all remaining bytes are covered, the
+             * first block tells how large blocks are */
+            while (in_flight == 0 ||
+                   (block_sz > 0 && in_flight < this->pipeline_depth &&
+                    got + in_flight * block_sz < (size_t)num_bytes)) {
+                r = net_send(this, 0, 0x00B2, NULL, 0);
+                if (r < 0) {
+                    net_drain(this, in_flight);
+                    return r;
+                }
 
-        while (num_bytes > 0)
-        {
-            // osal_mutex_lock(this->net.lock);
-            r = net_send(this, subnode, (uint16_t)address, NULL, 0, 0, net);
-            if (r < 0) {
-                goto unlock;
+                in_flight++;
             }
-            uint8_t *monitoring_raw_data = NULL;
-            r = il_eth_net_recv_monitoring(this, subnode, (uint16_t)address, buf, sz, monitoring_raw_data, net, num_bytes);
-            if (r < 0)
-                goto unlock;
-            // osal_mutex_unlock(this->net.lock);
 
-            r = il_net__read(&this->net, 1, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+            uint64_t vid;
+            r = il_eth_net_recv_monitoring(this, 0, 0x00B2, (uint8_t *)&vid, sizeof(vid),
+                                           NULL, net, (int)((size_t)num_bytes - got));
             if (r < 0) {
-                goto unlock;
+                /* the failed reply has been consumed */
+                net_drain(this, in_flight - 1);
+                return r;
             }
 
+            in_flight--;
+            if (r == 0)
+                break;
+
+            got += (size_t)r;
+            block_sz = MAX(block_sz, (size_t)r);
+            blocks++;
+
+            il_net__monitoring_progress(net, net->monitoring_data_size,
+                                        net->monitoring_data_size + (size_t)num_bytes - got);
         }
 
-        if (r >= 0)
-        {
-            r = process_monitoring_data(this, net);
+        /* collect replies to the extra requests, keeping any data the
+         * drive captured meanwhile */
+        while (in_flight > 0) {
+            uint64_t vid;
+            r = il_eth_net_recv_monitoring(this, 0, 0x00B2, (uint8_t *)&vid, sizeof(vid),
+                                           NULL, net, ETH_MCB_EXT_MAX_SZ);
+            if (r < 0) {
+                net_drain(this, in_flight - 1);
+                return r;
+            }
+
+            in_flight--;
+            if (r > 0)
+                blocks++;
         }
-    }
 
+        r = read_locked(this, 0, 0x00B7, &num_bytes, sizeof(num_bytes));
+        if (r < 0)
+            return r;
+    }
 
-unlock:
-    osal_mutex_unlock(this->net.lock);
+    il_net__monitoring_download_done(net, &start, blocks);
 
-    return r;
+    return process_monitoring_data(this, net);
 }
 
-static int il_eth_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-    const void *buf, size_t sz, int confirmed, uint16_t extended)
+/** Register write (net.lock held). */
+static int write_locked(il_eth_net_t *this, uint8_t subnode, uint16_t address,
+                        const void *buf, size_t sz, uint16_t extended)
+{
+    int r;
+
+    if (extended == 1)
+        return disturbance_upload_locked(this, subnode, address);
+
+    r = net_send(this, subnode, address, buf, sz);
+    if (r < 0)
+        return r;
+
+    return net_recv(this, subnode, address, NULL, 0, NULL, NULL, NULL);
+}
+
+static int il_eth_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
+    const void *buf, size_t sz, int confirmed, uint16_t extended)
+{
+    il_eth_net_t *this = to_eth_net(net);
+    eth_job_t job = { .type = ETH_JOB_WRITE, .subnode = subnode,
+                      .address = (uint16_t)address, .buf = (void *)buf,
+                      .sz = sz, .extended = extended };
+
+    int r;
+
+    (void)id;
+    (void)confirmed;
+
+    if (reactor_submit(this, &job))
+        return job.r;
+
+    osal_mutex_lock(this->net.lock);
+    r = write_locked(this, subnode, (uint16_t)address, buf, sz, extended);
+    osal_mutex_unlock(this->net.lock);
+
+    return r;
+}
+
+/** Register write waiting for the operation to complete (net.lock held). */
+static int wait_write_locked(il_eth_net_t *this, uint8_t subnode,
+                             uint16_t address, const void *buf, size_t sz,
+                             uint16_t extended)
+{
+    osal_timespec_t deadline;
+    int r;
+
+    if (extended == 1)
+        return disturbance_upload_locked(this, subnode, address);
+
+    r = net_send(this, subnode, address, buf, sz);
+    if (r < 0)
+        return r;
+
+    /* the drive acknowledges once the operation completes */
+    osal_clock_deadline_set(&deadline,
+                            (long long)this->wait_write_timeout * OSAL_CLOCK_NANOSPERMSEC);
+
+    return net_recv(this, subnode, address, NULL, 0, NULL, NULL, &deadline);
+}
+
+static int il_eth_net__wait_write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
+    const void *buf, size_t sz, int confirmed, uint16_t extended)
 {
     il_eth_net_t *this = to_eth_net(net);
+    eth_job_t job = { .type = ETH_JOB_WAIT_WRITE, .subnode = subnode,
+                      .address = (uint16_t)address, .buf = (void *)buf,
+                      .sz = sz, .extended = extended };
+
+    int r;
+
+    (void)id;
+    (void)confirmed;
+
+    if (reactor_submit(this, &job))
+        return job.r;
+
+    osal_mutex_lock(this->net.lock);
+    r = wait_write_locked(this, subnode, (uint16_t)address, buf, sz, extended);
+    osal_mutex_unlock(this->net.lock);
+
+    return r;
+}
+
+/** Pending request marker (pipelined transfers). */
+#define REQ_PENDING	1
+
+/**
+ * Complete the pending request a reply frame belongs to.
+ *
+ * @param [in] reqs
+ *	Requests.
+ * @param [in] tail
+ *	First request that may be pending.
+ * @param [in] head
+ *	Next request to be sent.
+ * @param [in] frame
+ *	Reply frame.
+ *
+ * @return
+ *	1 if a request has been completed, 0 if the frame has been discarded.
+ */
+static int transfer_complete(il_net_req_t *reqs, size_t tail, size_t head,
+                             const uint16_t *frame)
+{
+    il_net_req_t *match = NULL;
+    uint16_t hdr_h, hdr_l;
+    uint8_t subnode;
+    uint16_t address;
+    size_t i;
+    int cmd;
+
+    if (il_crc__ccitt(frame, ETH_MCB_CRC_POS * sizeof(uint16_t)) !=
+        frame[ETH_MCB_CRC_POS]) {
+        log_warn("Discarding frame (CRC mismatch)");
+        return 0;
+    }
+
+    hdr_h = frame[ETH_MCB_HDR_H_POS];
+    hdr_l = frame[ETH_MCB_HDR_L_POS];
+    subnode = hdr_h & ETH_MCB_SUBNODE_MSK;
+    address = (hdr_l & ETH_MCB_ADDR_MSK) >> ETH_MCB_ADDR_POS;
+
+    for (i = tail; i < head; i++) {
+        if (reqs[i].r == REQ_PENDING && reqs[i].subnode == subnode &&
+            reqs[i].address == address) {
+            match = &reqs[i];
+            break;
+        }
+    }
+
+    if (!match) {
+        log_warn("Discarding unexpected frame (subnode %d, address %04x)",
+                 subnode, address);
+        return 0;
+    }
+
+    cmd = (hdr_l & ETH_MCB_CMD_MSK) >> ETH_MCB_CMD_POS;
+    if (cmd != ETH_MCB_CMD_ACK) {
+        uint32_t err;
+
+        err = __swap_be_32(*(uint32_t *)&frame[ETH_MCB_DATA_POS]);
+
+        ilerr__set("Communications error (NACK -> %08x)", err);
+        ilerr__ipb_set(err);
+        match->r = IL_ENACK;
+        return 1;
+    }
+
+    if (!match->write)
+        memcpy(match->buf, &frame[ETH_MCB_DATA_POS], match->sz);
+
+    match->r = 0;
+
+    return 1;
+}
+
+/**
+ * Transfer a set of requests keeping up to pipeline_depth of them
+ * outstanding (net.lock held). New requests are sent in a single burst, and
+ * replies are matched back by subnode and address, the oldest pending
+ * request being used if the same register is requested more than once.
+ * A send or receive failure aborts the transfer: outstanding replies are
+ * drained and all requests not yet completed fail.
+ */
+static int transfer_locked(il_eth_net_t *this, il_net_req_t *reqs, size_t n)
+{
+    uint16_t frames[PIPELINE_DEPTH_MAX][ETH_MCB_FRAME_SZ];
+    size_t burst[PIPELINE_DEPTH_MAX];
+    size_t head = 0, tail = 0, in_flight = 0;
+    size_t i, cnt;
+    int r;
+
+    while (tail < n) {
+        /* fill the pipeline */
+        cnt = 0;
+        while (head < n && in_flight + cnt < this->pipeline_depth) {
+            il_net_req_t *req = &reqs[head];
+            uint64_t d = 0;
+
+            if (req->sz > ETH_MCB_DATA_SZ || (req->write && req->sz == 0)) {
+                ilerr__set("Invalid request size (%zu bytes)", req->sz);
+                req->r = IL_EINVAL;
+                head++;
+                continue;
+            }
+
+            if (req->write)
+                memcpy(&d, req->buf, req->sz);
+
+            frame_build(frames[cnt], req->subnode, req->address,
+                        req->write ? ETH_MCB_CMD_WRITE : ETH_MCB_CMD_READ, 0, d);
+            req->r = REQ_PENDING;
+            burst[cnt++] = head++;
+        }
+
+        if (cnt > 0) {
+            r = net_send_burst(this, frames, cnt);
+            if (r < 0)
+                goto abort;
+
+            for (i = (size_t)r; i < cnt; i++)
+                reqs[burst[i]].r = ilerr__eth(IL_EIO);
+            in_flight += (size_t)r;
+        }
+
+        /* skip completed requests */
+        while (tail < head && reqs[tail].r != REQ_PENDING)
+            tail++;
+
+        if (in_flight == 0)
+            continue;
+
+        r = net_recv_burst(this, frames, in_flight);
+        if (r < 0)
+            goto abort;
+
+        for (i = 0; i < (size_t)r; i++) {
+            if (transfer_complete(reqs, tail, head, frames[i]))
+                in_flight--;
+        }
+    }
+
+    goto result;
+
+abort:
+    /* link is down: drain late replies, fail the rest and stop sending */
+    net_drain(this, in_flight);
+
+    for (i = tail; i < n; i++) {
+        if (i >= head || reqs[i].r == REQ_PENDING)
+            reqs[i].r = r;
+    }
+
+result:
+    r = 0;
+    for (i = 0; i < n; i++) {
+        if (reqs[i].r < 0) {
+            r = reqs[i].r;
+            break;
+        }
+    }
+
+    return r;
+}
+
+/**
+ * Upload the packed disturbance payload (net.lock held).
+ *
+ * @note
+ *	The payload is split in as many extended frames as needed, each one
+ *	carrying whole samples, and up to pipeline_depth frames are kept
+ *	outstanding. Acknowledges are matched like any other transfer. The
+ *	upload stops at the first failure, draining the outstanding replies.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Disturbance data register address.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int disturbance_upload_locked(il_eth_net_t *this, uint8_t subnode,
+                                     uint16_t address)
+{
+    il_net_t *net = &this->net;
+    uint16_t frames[PIPELINE_DEPTH_MAX][ETH_MCB_FRAME_SZ];
+    il_net_req_t *reqs;
+    size_t total, chunk, n, head = 0, tail = 0, in_flight = 0, i;
+    int r;
+
+    total = net->disturbance_data_size;
+    if (total == 0 || total > net->disturbance_packed_sz) {
+        ilerr__set("Disturbance data not set (%zu bytes requested)", total);
+        return IL_EINVAL;
+    }
+
+    chunk = ETH_MCB_EXT_WR_SZ;
+    if (total > chunk && net->disturbance_sample_sz > 0 &&
+        net->disturbance_sample_sz <= chunk)
+        chunk -= chunk % net->disturbance_sample_sz;
+
+    n = (total + chunk - 1) / chunk;
+    reqs = calloc(n, sizeof(*reqs));
+    if (!reqs) {
+        ilerr__set("Disturbance upload allocation failed");
+        return IL_ENOMEM;
+    }
+
+    for (i = 0; i < n; i++) {
+        reqs[i].subnode = subnode;
+        reqs[i].address = address;
+        reqs[i].buf = &net->disturbance_packed[i * chunk];
+        reqs[i].sz = MIN(chunk, total - i * chunk);
+        reqs[i].write = 1;
+    }
+
+    while (tail < n) {
+        /* fill the pipeline */
+        while (head < n && in_flight < this->pipeline_depth) {
+            r = net_send_ext(this, subnode, address, reqs[head].buf,
+                             reqs[head].sz);
+            if (r < 0)
+                goto cleanup_drain;
+
+            reqs[head++].r = REQ_PENDING;
+            in_flight++;
+        }
+
+        r = net_recv_burst(this, frames, in_flight);
+        if (r < 0)
+            goto cleanup_drain;
+
+        for (i = 0; i < (size_t)r; i++) {
+            if (transfer_complete(reqs, tail, head, frames[i]))
+                in_flight--;
+        }
+
+        /* stop at the first rejected frame */
+        for (i = tail; i < head; i++) {
+            if (reqs[i].r < 0) {
+                r = reqs[i].r;
+                goto cleanup_drain;
+            }
+        }
+
+        /* skip completed requests */
+        while (tail < head && reqs[tail].r != REQ_PENDING)
+            tail++;
+    }
+
+    free(reqs);
+
+    return 0;
+
+cleanup_drain:
+    /* do not send any further frame, and flush the outstanding replies */
+    net_drain(this, in_flight);
+    free(reqs);
+
+    return r;
+}
+
+static int il_eth_net__transfer(il_net_t *net, il_net_req_t *reqs, size_t n)
+{
+    il_eth_net_t *this = to_eth_net(net);
+    eth_job_t job = { .type = ETH_JOB_TRANSFER, .reqs = reqs, .n = n };
+    int r;
+
+    if (reactor_submit(this, &job))
+        return job.r;
+
+    osal_mutex_lock(this->net.lock);
+    r = transfer_locked(this, reqs, n);
+    osal_mutex_unlock(this->net.lock);
+
+    return r;
+}
+
+/*
+ * Reactor mode: a dedicated I/O thread owns the socket. Callers push jobs to
+ * a lock-free stack and only block on a completion condition borrowed from a
+ * pool (so that no condition is created per job); the reactor drains the
+ * stack in one go, restores submission order and serves all drained jobs
+ * (register transactions, transfers and monitoring data downloads) within a
+ * single net.lock section. Submitters are counted, and disabling the reactor
+ * waits until the last one leaves before tearing it down.
+ */
+
+#ifdef _WIN32
+#define atomic_load_int(p) InterlockedCompareExchange((volatile LONG *)(p), 0, 0)
+#define atomic_store_int(p, v) InterlockedExchange((volatile LONG *)(p), (v))
+#define atomic_inc_int(p) InterlockedIncrement((volatile LONG *)(p))
+#define atomic_dec_int(p) InterlockedDecrement((volatile LONG *)(p))
+#define atomic_load_ptr(p) \
+    InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define atomic_xchg_ptr(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (v))
+#define atomic_cas_ptr(p, o, n) \
+    (InterlockedCompareExchangePointer((PVOID volatile *)(p), (n), (o)) == (o))
+#else
+#define atomic_load_int(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define atomic_store_int(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define atomic_inc_int(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define atomic_dec_int(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define atomic_load_ptr(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define atomic_xchg_ptr(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define atomic_cas_ptr(p, o, n) \
+    __atomic_compare_exchange_n((p), &(o), (n), 0, __ATOMIC_SEQ_CST, \
+                                __ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * Leave the reactor submission path.
+ *
+ * @param [in] this
+ *	ETH network.
+ */
+static void reactor_leave(il_eth_net_t *this)
+{
+    /* the last submitter wakes up a pending disable */
+    if (atomic_dec_int(&this->reactor_users) == 0 &&
+        atomic_load_int(&this->reactor_draining)) {
+        osal_mutex_lock(this->reactor_lock);
+        osal_cond_signal(this->reactor_drained);
+        osal_mutex_unlock(this->reactor_lock);
+    }
+}
+
+/**
+ * Submit a job to the reactor and wait for its completion.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] job
+ *	Job (result stored in job->r).
+ *
+ * @return
+ *	1 if the job was served by the reactor, 0 if reactor mode is disabled
+ *	(the caller must then serve it directly).
+ */
+static int reactor_submit(il_eth_net_t *this, eth_job_t *job)
+{
+    eth_job_t *head;
+    eth_waiter_t *waiter;
+
+    /* announce ourselves before checking, so that disable waits for us */
+    atomic_inc_int(&this->reactor_users);
+    if (!atomic_load_int(&this->reactor_on)) {
+        reactor_leave(this);
+        return 0;
+    }
+
+    osal_mutex_lock(this->reactor_lock);
+
+    /* borrow a completion condition, the pool only grows when more
+     * threads than ever before wait at the same time */
+    waiter = this->reactor_pool;
+    if (waiter) {
+        this->reactor_pool = waiter->next;
+    } else {
+        waiter = malloc(sizeof(*waiter));
+        if (waiter) {
+            waiter->cond = osal_cond_create();
+            if (!waiter->cond) {
+                free(waiter);
+                waiter = NULL;
+            }
+        }
+
+        if (!waiter) {
+            osal_mutex_unlock(this->reactor_lock);
+            reactor_leave(this);
+            ilerr__set("Reactor completion condition allocation failed");
+            job->r = IL_ENOMEM;
+            return 1;
+        }
+    }
+
+    job->done = 0;
+    job->cond = waiter->cond;
+
+    /* push (lock-free) */
+    do {
+        head = atomic_load_ptr(&this->reactor_sq);
+        job->next = head;
+    } while (!atomic_cas_ptr(&this->reactor_sq, head, job));
+
+    /* wake the reactor up only if it went to sleep */
+    if (atomic_load_int(&this->reactor_idle))
+        osal_cond_signal(this->reactor_cond);
+
+    while (!job->done)
+        (void)osal_cond_wait(job->cond, this->reactor_lock, 0);
+
+    waiter->next = this->reactor_pool;
+    this->reactor_pool = waiter;
+
+    osal_mutex_unlock(this->reactor_lock);
+
+    reactor_leave(this);
+
+    return 1;
+}
+
+/**
+ * Serve a reactor job (net.lock held).
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] job
+ *	Job.
+ */
+static void reactor_serve(il_eth_net_t *this, eth_job_t *job)
+{
+    switch (job->type) {
+    case ETH_JOB_READ:
+        job->r = read_locked(this, job->subnode, job->address, job->buf,
+                             job->sz);
+        break;
+    case ETH_JOB_WRITE:
+        job->r = write_locked(this, job->subnode, job->address, job->buf,
+                              job->sz, job->extended);
+        break;
+    case ETH_JOB_WAIT_WRITE:
+        job->r = wait_write_locked(this, job->subnode, job->address,
+                                   job->buf, job->sz, job->extended);
+        break;
+    case ETH_JOB_TRANSFER:
+        job->r = transfer_locked(this, job->reqs, job->n);
+        break;
+    case ETH_JOB_MONITORING:
+        job->r = monitoring_download_locked(this);
+        break;
+    default:
+        job->r = ilerr__eth(IL_EINVAL);
+        break;
+    }
+}
+
+/**
+ * Reactor thread.
+ *
+ * @param [in] args
+ *	ETH network (il_eth_net_t *).
+ */
+static int reactor_td(void *args)
+{
+    il_eth_net_t *this = args;
+
+    for (;;) {
+        eth_job_t *jobs, *job, *fifo = NULL;
+
+        jobs = atomic_xchg_ptr(&this->reactor_sq, NULL);
+        if (!jobs) {
+            if (atomic_load_int(&this->reactor_stop))
+                break;
+
+            osal_mutex_lock(this->reactor_lock);
+            atomic_store_int(&this->reactor_idle, 1);
+            if (!atomic_load_int(&this->reactor_stop) &&
+                !atomic_load_ptr(&this->reactor_sq))
+                (void)osal_cond_wait(this->reactor_cond, this->reactor_lock, 0);
+            atomic_store_int(&this->reactor_idle, 0);
+            osal_mutex_unlock(this->reactor_lock);
+
+            continue;
+        }
+
+        /* restore submission order */
+        while (jobs) {
+            job = jobs;
+            jobs = jobs->next;
+            job->next = fifo;
+            fifo = job;
+        }
+
+        osal_mutex_lock(this->net.lock);
+        for (job = fifo; job; job = job->next)
+            reactor_serve(this, job);
+        osal_mutex_unlock(this->net.lock);
+
+        /* wake each submitter on its own condition (no thundering herd) */
+        osal_mutex_lock(this->reactor_lock);
+        for (job = fifo; job; job = jobs) {
+            jobs = job->next;
+            job->done = 1;
+            osal_cond_signal(job->cond);
+        }
+        osal_mutex_unlock(this->reactor_lock);
+    }
+
+    return 0;
+}
+
+/**
+ * Stop the reactor thread, if running.
+ *
+ * @note
+ *	New transactions are served directly as soon as this is called, while
+ *	the ones already submitted are completed by the reactor before it is
+ *	torn down.
+ *
+ * @param [in] this
+ *	ETH network.
+ */
+static void reactor_disable(il_eth_net_t *this)
+{
+    eth_waiter_t *waiter;
+
+    if (!this->reactor)
+        return;
+
+    /* new transactions go through the direct path from now on */
+    atomic_store_int(&this->reactor_on, 0);
+    atomic_store_int(&this->reactor_draining, 1);
+
+    /* wait for in-flight submitters, the last one signals */
+    osal_mutex_lock(this->reactor_lock);
+    while (atomic_load_int(&this->reactor_users) > 0)
+        (void)osal_cond_wait(this->reactor_drained, this->reactor_lock, 0);
+
+    atomic_store_int(&this->reactor_stop, 1);
+    osal_cond_signal(this->reactor_cond);
+    osal_mutex_unlock(this->reactor_lock);
+
+    osal_thread_join(this->reactor, NULL);
+    this->reactor = NULL;
+
+    atomic_store_int(&this->reactor_draining, 0);
+
+    /* no submitter left, release the completion pool */
+    while (this->reactor_pool) {
+        waiter = this->reactor_pool;
+        this->reactor_pool = waiter->next;
+        osal_cond_destroy(waiter->cond);
+        free(waiter);
+    }
+}
+
+/**
+ * Start the reactor thread.
+ *
+ * @param [in] this
+ *	ETH network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int reactor_enable(il_eth_net_t *this)
+{
+    if (this->reactor)
+        return 0;
+
+    this->reactor_sq = NULL;
+    this->reactor_idle = 0;
+    this->reactor_stop = 0;
+
+    this->reactor = osal_thread_create_(reactor_td, this);
+    if (!this->reactor) {
+        ilerr__set("Reactor thread creation failed");
+        return IL_EFAIL;
+    }
+
+    /* publish only once fully set up */
+    atomic_store_int(&this->reactor_on, 1);
+
+    return 0;
+}
+
+typedef union
+{
+    uint64_t u64;
+    uint16_t u16[4];
+} UINT_UNION_T;
+
+/**
+ * Build an MCB frame.
+ *
+ * @param [out] frame
+ *	Frame buffer (ETH_MCB_FRAME_SZ words).
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Register address.
+ * @param [in] cmd
+ *	Command (ETH_MCB_CMD_*).
+ * @param [in] extended
+ *	Extended frame flag.
+ * @param [in] d
+ *	Configuration data.
+ */
+static void frame_build(uint16_t *frame, uint8_t subnode, uint16_t address,
+                        uint8_t cmd, uint16_t extended, uint64_t d)
+{
+    UINT_UNION_T u = { .u64 = d };
+
+    /* header */
+    frame[ETH_MCB_HDR_H_POS] = (ETH_MCB_NODE_DFLT << 4) | (subnode);
+    frame[ETH_MCB_HDR_L_POS] = (address << 4) | (cmd << 1) | (extended);
+
+    /* cfg_data */
+    memcpy(&frame[ETH_MCB_DATA_POS], &u.u16[0], 8);
+
+    /* crc */
+    frame[ETH_MCB_CRC_POS] = il_crc__ccitt(frame, ETH_MCB_CRC_POS * sizeof(uint16_t));
+}
+
+static int net_send(il_eth_net_t *this, uint8_t subnode, uint16_t address, const void *data,
+    size_t sz)
+{
+    uint16_t frame[ETH_MCB_FRAME_SZ];
+    uint64_t d = 0;
+    uint8_t cmd;
+    int r;
+
+    cmd = sz ? ETH_MCB_CMD_WRITE : ETH_MCB_CMD_READ;
+
+    /* cfg_data */
+    if (sz > 0)
+        memcpy(&d, data, MIN(sz, sizeof(d)));
+
+    frame_build(frame, subnode, address, cmd, 0, d);
+
+    /* send frame */
+    r = send(this->server, (const char*)&frame[0], sizeof(frame), 0);
+    if (r < 0)
+        return ilerr__eth(r);
+
+    return 0;
+}
+
+/**
+ * Send an extended write frame, gathering header and payload.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Register address.
+ * @param [in] payload
+ *	Payload.
+ * @param [in] sz
+ *	Payload size (bytes).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int net_send_ext(il_eth_net_t *this, uint8_t subnode, uint16_t address,
+                        const uint8_t *payload, size_t sz)
+{
+    uint16_t frame[ETH_MCB_FRAME_SZ];
+
+    frame_build(frame, subnode, address, ETH_MCB_CMD_WRITE, 1, (uint64_t)sz);
+
+#ifdef _WIN32
+    WSABUF bufs[2];
+    DWORD sent = 0;
+
+    bufs[0].buf = (char *)frame;
+    bufs[0].len = sizeof(frame);
+    bufs[1].buf = (char *)payload;
+    bufs[1].len = (ULONG)sz;
+
+    if (WSASend(this->server, bufs, 2, &sent, 0, NULL, NULL) != 0)
+        return ilerr__eth(IL_EIO);
+#else
+    struct iovec iov[2];
+    struct msghdr msg;
+    int r;
+
+    iov[0].iov_base = frame;
+    iov[0].iov_len = sizeof(frame);
+    iov[1].iov_base = (void *)payload;
+    iov[1].iov_len = sz;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    do {
+        r = sendmsg(this->server, &msg, 0);
+    } while (r < 0 && errno == EINTR);
+
+    if (r < 0)
+        return ilerr__eth(IL_EIO);
+#endif
+
+    return 0;
+}
+
+/**
+ * Wait until the socket is readable.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] deadline
+ *	Deadline (NULL to wait for the configured receive timeout).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int net_wait_readable(il_eth_net_t *this,
+                             const osal_timespec_t *deadline)
+{
+    osal_timespec_t deadline_def;
+    fd_set fds;
+    struct timeval tv;
+    long long left;
+    int n;
+
+    if (!deadline) {
+        osal_clock_deadline_set(&deadline_def,
+                                (long long)this->recv_timeout * OSAL_CLOCK_NANOSPERUSEC);
+        deadline = &deadline_def;
+    }
+
+    do {
+        left = osal_clock_deadline_left(deadline);
+        if (left < 0)
+            left = 0;
+
+        FD_ZERO(&fds);
+        FD_SET(this->server, &fds);
+
+        tv.tv_sec = (long)(left / OSAL_CLOCK_NANOSPERSEC);
+        tv.tv_usec = (long)((left % OSAL_CLOCK_NANOSPERSEC) / OSAL_CLOCK_NANOSPERUSEC);
+
+        #ifdef _WIN32
+            n = select(this->server, &fds, NULL, NULL, &tv);
+        #else
+            n = select(this->server + 1, &fds, NULL, NULL, &tv);
+        #endif
+    #ifdef _WIN32
+    } while (0);
+    #else
+    } while (n < 0 && errno == EINTR);
+    #endif
+
+    if (n == 0)
+        return ilerr__eth(IL_ETIMEDOUT);
+    else if (n < 0)
+        return ilerr__eth(IL_EIO);
+
+    return 0;
+}
 
+/**
+ * Receive a single frame.
+ *
+ * @note
+ *	The socket readiness is awaited until the given deadline, so that the
+ *	frame is processed as soon as it arrives.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [out] frame
+ *	Frame buffer.
+ * @param [in] sz
+ *	Frame buffer size (bytes).
+ * @param [in] deadline
+ *	Deadline (NULL to wait for the configured receive timeout).
+ *
+ * @return
+ *	Number of bytes received, error code otherwise.
+ */
+static int net_recv_frame(il_eth_net_t *this, uint16_t *frame, size_t sz,
+                          const osal_timespec_t *deadline)
+{
     int r;
 
-    (void)id;
-    (void)confirmed;
+    r = net_wait_readable(this, deadline);
+    if (r < 0)
+        return r;
 
-    osal_mutex_lock(this->net.lock);
+    r = recv(this->server, (char *)frame, sz, 0);
+    if (r < (int)(ETH_MCB_FRAME_SZ * sizeof(uint16_t)))
+        return ilerr__eth(IL_EIO);
 
-    r = net_send(this, subnode, (uint16_t)address, buf, sz, extended, net);
-    if (r < 0)
-        goto unlock;
+    return r;
+}
 
-    r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL);
-    if (r < 0)
-        goto unlock;
+/**
+ * Drain the replies to outstanding requests.
+ *
+ * @note
+ *	Used after a failed pipelined exchange, so that late replies do not
+ *	desync the next transaction. Each reply is awaited up to the configured
+ *	receive timeout, and draining stops at the first failure (nothing else
+ *	is expected to arrive). The error that caused the drain is kept.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] cnt
+ *	Number of outstanding requests.
+ */
+static void net_drain(il_eth_net_t *this, size_t cnt)
+{
+    uint16_t frame[ETH_MCB_FRAME_SZ + ETH_MCB_EXT_MAX_SZ / sizeof(uint16_t)];
+    char err[256];
 
-unlock:
-    osal_mutex_unlock(this->net.lock);
+    if (cnt == 0)
+        return;
 
-    return r;
+#ifndef _WIN32
+    /* socket already closed, nothing left to drain */
+    if (this->server < 0)
+        return;
+#endif
+
+    snprintf(err, sizeof(err), "%s", ilerr_last());
+
+    while (cnt-- > 0) {
+        if (net_recv_frame(this, frame, sizeof(frame), NULL) < 0)
+            break;
+    }
+
+    ilerr__set("%s", err);
 }
 
-static int il_eth_net__wait_write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address,
-    const void *buf, size_t sz, int confirmed, uint16_t extended)
+/**
+ * Send a burst of MCB frames.
+ *
+ * @note
+ *	On Linux all frames are handed to the kernel with a single sendmmsg
+ *	call, other platforms send them one by one.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [in] frames
+ *	Frames.
+ * @param [in] cnt
+ *	Number of frames.
+ *
+ * @return
+ *	Number of frames sent, error code if none could be sent.
+ */
+static int net_send_burst(il_eth_net_t *this,
+                          uint16_t (*frames)[ETH_MCB_FRAME_SZ], size_t cnt)
 {
-    il_eth_net_t *this = to_eth_net(net);
+    size_t sent = 0;
+    int r;
+
+#ifdef __linux__
+    struct mmsghdr msgs[PIPELINE_DEPTH_MAX];
+    struct iovec iovs[PIPELINE_DEPTH_MAX];
+    size_t i;
+
+    cnt = MIN(cnt, PIPELINE_DEPTH_MAX);
+
+    memset(msgs, 0, sizeof(msgs[0]) * cnt);
+    for (i = 0; i < cnt; i++) {
+        iovs[i].iov_base = frames[i];
+        iovs[i].iov_len = sizeof(frames[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
+    while (sent < cnt) {
+        r = sendmmsg(this->server, &msgs[sent], (unsigned int)(cnt - sent), 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        sent += (size_t)r;
+    }
+#else
+    while (sent < cnt) {
+        r = send(this->server, (const char *)frames[sent],
+                 sizeof(frames[sent]), 0);
+        if (r < 0)
+            break;
+
+        sent++;
+    }
+#endif
+
+    if (sent == 0)
+        return ilerr__eth(IL_EIO);
+
+    return (int)sent;
+}
+
+/**
+ * Receive a burst of MCB frames.
+ *
+ * @note
+ *	Waits for the first frame up to the configured receive timeout, then
+ *	collects whatever else is already queued without blocking (a single
+ *	recvmmsg call on Linux). Frames shorter than an MCB frame are dropped.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [out] frames
+ *	Frame buffers.
+ * @param [in] cnt
+ *	Maximum number of frames.
+ *
+ * @return
+ *	Number of frames received, error code otherwise.
+ */
+static int net_recv_burst(il_eth_net_t *this,
+                          uint16_t (*frames)[ETH_MCB_FRAME_SZ], size_t cnt)
+{
+    size_t rcvd = 0;
     int r;
 
-    (void)id;
-    (void)confirmed;
+    r = net_wait_readable(this, NULL);
+    if (r < 0)
+        return r;
 
-    osal_mutex_lock(this->net.lock);
+#ifdef __linux__
+    struct mmsghdr msgs[PIPELINE_DEPTH_MAX];
+    struct iovec iovs[PIPELINE_DEPTH_MAX];
+    size_t i;
+
+    cnt = MIN(cnt, PIPELINE_DEPTH_MAX);
+
+    memset(msgs, 0, sizeof(msgs[0]) * cnt);
+    for (i = 0; i < cnt; i++) {
+        iovs[i].iov_base = frames[i];
+        iovs[i].iov_len = sizeof(frames[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
+    do {
+        r = recvmmsg(this->server, msgs, (unsigned int)cnt, MSG_DONTWAIT,
+                     NULL);
+    } while (r < 0 && errno == EINTR);
 
-    r = net_send(this, subnode, (uint16_t)address, buf, sz, extended, net);
     if (r < 0)
-        goto unlock;
+        return ilerr__eth(IL_EIO);
+
+    /* compact valid frames */
+    for (i = 0; i < (size_t)r; i++) {
+        if (msgs[i].msg_len < sizeof(frames[i]))
+            continue;
+
+        if (rcvd != i)
+            memcpy(frames[rcvd], frames[i], sizeof(frames[i]));
+        rcvd++;
+    }
+#else
+    uint16_t frame[1024];
 
-    Sleep(1000);
+    (void)cnt;
 
-    r = net_recv(this, subnode, (uint16_t)address, NULL, 0, NULL, NULL);
+    r = recv(this->server, (char *)frame, sizeof(frame), 0);
     if (r < 0)
-        goto unlock;
+        return ilerr__eth(IL_EIO);
 
-unlock:
-    osal_mutex_unlock(this->net.lock);
+    if (r >= (int)sizeof(frames[0])) {
+        memcpy(frames[0], frame, sizeof(frames[0]));
+        rcvd = 1;
+    }
+#endif
 
-    return r;
+    return (int)rcvd;
 }
 
-typedef union
+/**
+ * Receive a single frame, scattering header and payload.
+ *
+ * @note
+ *	The MCB frame (header, data and CRC) is stored in the given frame
+ *	buffer, while any extended payload is received straight into its final
+ *	location, avoiding an intermediate copy.
+ *
+ * @param [in] this
+ *	ETH network.
+ * @param [out] frame
+ *	Frame buffer (ETH_MCB_FRAME_SZ words).
+ * @param [out] payload
+ *	Extended payload buffer.
+ * @param [in] payload_sz
+ *	Extended payload buffer size (bytes).
+ *
+ * @return
+ *	Number of bytes received (frame and payload), error code otherwise.
+ */
+static int net_recv_scatter(il_eth_net_t *this, uint16_t *frame,
+                            uint8_t *payload, size_t payload_sz)
 {
-    uint64_t u64;
-    uint16_t u16[4];
-} UINT_UNION_T;
+    int r;
 
-static int net_send(il_eth_net_t *this, uint8_t subnode, uint16_t address, const void *data,
-    size_t sz, uint16_t extended, il_net_t *net)
-{
-    int finished = 0;
-    uint8_t cmd;
+    r = net_wait_readable(this, NULL);
+    if (r < 0)
+        return r;
 
-    cmd = sz ? ETH_MCB_CMD_WRITE : ETH_MCB_CMD_READ;
+#ifdef _WIN32
+    WSABUF bufs[2];
+    DWORD rcvd = 0, flags = 0;
 
+    bufs[0].buf = (char *)frame;
+    bufs[0].len = ETH_MCB_FRAME_SZ * sizeof(uint16_t);
+    bufs[1].buf = (char *)payload;
+    bufs[1].len = (ULONG)payload_sz;
 
-    while (!finished) {
-        int r;
-        uint16_t frame[ETH_MCB_FRAME_SZ];
-        uint16_t hdr_h, hdr_l, crc;
-        size_t chunk_sz;
+    if (WSARecv(this->server, bufs, 2, &rcvd, &flags, NULL, NULL) != 0)
+        return ilerr__eth(IL_EIO);
 
-        /* header */
-        hdr_h = (ETH_MCB_NODE_DFLT << 4) | (subnode);
-        *(uint16_t *)&frame[ETH_MCB_HDR_H_POS] = hdr_h;
-        hdr_l = (address << 4) | (cmd << 1) | (extended);
-        *(uint16_t *)&frame[ETH_MCB_HDR_L_POS] = hdr_l;
+    r = (int)rcvd;
+#else
+    struct iovec iov[2];
+    struct msghdr msg;
 
-        /* cfg_data */
-        uint64_t d = 0;
-        /* Check if frame is extended */
-        if (extended == 1) {
-            d = net->disturbance_data_size;
-        }
-        else {
-            if (sz > 0) {
-                memcpy(&d, data, sz);
-            }
-        }
-        UINT_UNION_T u = { .u64 = d };
-        memcpy(&frame[ETH_MCB_DATA_POS], &u.u16[0], 8);
-
-        /* crc */
-        crc = crc_calc_eth(frame, ETH_MCB_CRC_POS);
-        frame[ETH_MCB_CRC_POS] = crc;
-
-        /* send frame */
-        if (extended == 1) {
-            uint16_t frame_size = sizeof(uint16_t) * ETH_MCB_FRAME_SZ;
-            uint8_t extended_frame[1024];
-
-            int n_bytes_sum = 0;
-            int sample_position = 0;
-            uint8_t* pData;
-            pData = malloc(net->disturbance_data_size);
-            uint8_t* pDataAux = pData;
-
-            while(n_bytes_sum < net->disturbance_data_size){
-                for (int i = 0; i <= net->last_channel; i++){
-                    il_reg_dtype_t type = net->disturbance_data_channels[i].type;
-                    switch (type) {
-                        case IL_REG_DTYPE_U16:
-                            n_bytes_sum+=2;
-                            memcpy(pData, &net->disturbance_data_channels[i].value.disturbance_data_u16[sample_position], 2);
-                            pData += sizeof(uint16_t);
-                            break;
-                        case IL_REG_DTYPE_S16:
-                            n_bytes_sum+=2;
-                            memcpy(pData, &net->disturbance_data_channels[i].value.disturbance_data_s16[sample_position], 2);
-                            pData += sizeof(int16_t);
-                            break;
-                        case IL_REG_DTYPE_U32:
-                            n_bytes_sum+=4;
-                            memcpy(pData, &net->disturbance_data_channels[i].value.disturbance_data_u32[sample_position], 4);
-                            pData += sizeof(uint32_t);
-                            break;
-                        case IL_REG_DTYPE_S32:
-                            n_bytes_sum+=4;
-                            memcpy(pData, &net->disturbance_data_channels[i].value.disturbance_data_s32[sample_position], 4);
-                            pData += sizeof(int32_t);
-                            break;
-                        case IL_REG_DTYPE_FLOAT:
-                            n_bytes_sum+=4;
-                            memcpy(pData, &net->disturbance_data_channels[i].value.disturbance_data_flt[sample_position], 4);
-                            pData += sizeof(float);
-                            break;
-                    }
-                }
-                sample_position++;
-            }
+    iov[0].iov_base = frame;
+    iov[0].iov_len = ETH_MCB_FRAME_SZ * sizeof(uint16_t);
+    iov[1].iov_base = payload;
+    iov[1].iov_len = payload_sz;
 
-            memcpy(&extended_frame[0], frame, frame_size);
-            memcpy(&extended_frame[frame_size], pDataAux, 1024 - frame_size);
-            free(pDataAux);
-            r = send(this->server, (const char*)&extended_frame[0], net->disturbance_data_size + frame_size, 0);
-            if (r < 0)
-                return ilerr__eth(r);
-        }
-        else {
-            r = send(this->server, (const char*)&frame[0], sizeof(frame), 0);
-            if (r < 0)
-                return ilerr__eth(r);
-        }
-        finished = 1;
-    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
 
-    return 0;
+    do {
+        r = recvmsg(this->server, &msg, 0);
+    } while (r < 0 && errno == EINTR);
+#endif
+
+    if (r < (int)(ETH_MCB_FRAME_SZ * sizeof(uint16_t)))
+        return ilerr__eth(IL_EIO);
+
+    return r;
 }
 
 static int net_recv(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
-    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net)
+    size_t sz, uint16_t *monitoring_raw_data, il_net_t *net,
+    const osal_timespec_t *deadline)
 {
     int finished = 0;
     size_t pending_sz = sz;
@@ -1545,44 +2639,22 @@ static int net_recv(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8
     uint8_t *pBuf = (uint8_t*)&frame;
     uint8_t extended_bit = 0;
 
-    Sleep(5);
-    int r = 0;
-    // GAS
-    fd_set fds;
-    int n;
-    struct timeval tv;
-
-    // Set up the file descriptor set.
-    FD_ZERO(&fds);
-    FD_SET(this->server, &fds);
-
-    // Set up the struct timeval for the timeout.
-    tv.tv_sec = 0;
-    tv.tv_usec = this->recv_timeout;
-
-    // Wait until timeout or data received.
-    #ifdef WINDOWS
-        n = select(this->server, &fds, NULL, NULL, &tv);
-    #else
-        n = select(this->server + 1, &fds, NULL, NULL, &tv);
-    #endif	
-    if (n == 0)
+    /* wait for the next frame */
+    int r = net_recv_frame(this, frame, sizeof(frame), deadline);
+    if (r == IL_ETIMEDOUT)
     {
         log_error("Timeout...");
-        return ilerr__eth(IL_ETIMEDOUT);
+        return r;
     }
-    else if (n == -1)
+    else if (r < 0)
     {
         log_error("Error..");
-        return ilerr__eth(IL_EIO);
+        return r;
     }
 
-    /* read next frame */
-    r = recv(this->server, (char*)&pBuf[0], sizeof(frame), 0);
-
     /* process frame: validate CRC, address, ACK */
     crc = *(uint16_t *)&frame[6];
-    uint16_t crc_res = crc_calc_eth((uint16_t *)frame, 6);
+    uint16_t crc_res = il_crc__ccitt((uint16_t *)frame, 6 * sizeof(uint16_t));
     if (crc_res != crc) {
         return ilerr__eth(IL_EWRONGCRC);
     }
@@ -1623,51 +2695,32 @@ static int net_recv(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8
             /* Read size of data */
             memcpy(buf, &(frame[ETH_MCB_DATA_POS]), 2);
             uint16_t size = *(uint16_t*)buf;
+            if ((size_t)size > (size_t)r - 14) {
+                ilerr__set("Extended payload exceeds the frame");
+                return IL_EIO;
+            }
+
+            r = il_net__monitoring_raw_reserve(net, size);
+            if (r < 0)
+                return r;
+
             memcpy(net->monitoring_raw_data, (uint8_t*)&pBuf[14], size);
             //r = recv(this->server, (uint8_t*)net->monitoring_raw_data, size, 0);
 
             net->monitoring_data_size = size;
-            int num_mapped = net->monitoring_number_mapped_registers;
-            int bytes_per_block = net->monitoring_bytes_per_block;
-
-            int number_blocks = size / bytes_per_block;
-            uint8_t* pData = net->monitoring_raw_data;
-
-            for (int i = 0; i < number_blocks; ++i)
-            {
-                int OffsetIndexIntraBlockInBytes = 0;
-                for (int j = 0; j < num_mapped; ++j)
-                {
-                    il_reg_dtype_t type = net->monitoring_data_channels[j].type;
-                    switch (type) {
-                        case IL_REG_DTYPE_U16:
-                            net->monitoring_data_channels[j].value.monitoring_data_u16[i] = *((uint16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(uint16_t);
-                            break;
-                        case IL_REG_DTYPE_S16:
-                            net->monitoring_data_channels[j].value.monitoring_data_s16[i] = *((int16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(int16_t);
-                            break;
-                        case IL_REG_DTYPE_U32:
-                            net->monitoring_data_channels[j].value.monitoring_data_u32[i] = *((uint32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(uint32_t);
-                            break;
-                        case IL_REG_DTYPE_S32:
-                            net->monitoring_data_channels[j].value.monitoring_data_s32[i] = *((int32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(int32_t);
-                            break;
-                        case IL_REG_DTYPE_FLOAT:
-                            net->monitoring_data_channels[j].value.monitoring_data_flt[i] = *((float*)(pData + OffsetIndexIntraBlockInBytes));
-                            OffsetIndexIntraBlockInBytes += sizeof(float);
-                            break;
-                    }
-                }
-                pData += bytes_per_block;
-            }
+            r = il_net__monitoring_decode(net);
+            if (r < 0)
+                return r;
         }
         else {
             memcpy(buf, &(frame[ETH_MCB_DATA_POS]), 2);
             uint16_t size = *(uint16_t*)buf;
+            if ((size_t)size > sizeof(net->extended_buff) ||
+                (size_t)size > (size_t)r - 14) {
+                ilerr__set("Extended payload exceeds the buffer");
+                return IL_EIO;
+            }
+
             memcpy(net->extended_buff, (char*)&pBuf[14], size);
 
         }
@@ -1682,55 +2735,38 @@ static int net_recv(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8
 static int il_eth_net_recv_monitoring(il_eth_net_t *this, uint8_t subnode, uint16_t address, uint8_t *buf,
     size_t sz, uint8_t *monitoring_raw_data, il_net_t *net, int num_bytes)
 {
-    int finished = 0;
-    size_t pending_sz = sz;
-
-    /*while (!finished) {*/
-    uint16_t frame[1024];
-    size_t block_sz = 0;
+    uint16_t frame[ETH_MCB_FRAME_SZ];
     uint16_t crc, hdr_l;
-    uint8_t *pBuf = (uint8_t*)&frame;
+    uint8_t *payload;
+    size_t payload_sz;
     uint8_t extended_bit = 0;
 
-    Sleep(5);
-    int r = 0;
-    // GAS
-    fd_set fds;
-    int n;
-    struct timeval tv;
-
-    // Set up the file descriptor set.
-    FD_ZERO(&fds);
-    FD_SET(this->server, &fds);
-
-    // Set up the struct timeval for the timeout.
-    tv.tv_sec = 0;
-    tv.tv_usec = this->recv_timeout;
+    /* extended payload is received straight into its final location */
+    if (address == 0x00B2) {
+        int r = il_net__monitoring_raw_reserve(net, net->monitoring_data_size +
+                                               (size_t)num_bytes + ETH_MCB_EXT_MAX_SZ);
+        if (r < 0)
+            return r;
 
-    // Wait until timeout or data received.
-    #ifdef WINDOWS
-        n = select(this->server, &fds, NULL, NULL, &tv);
-    #else
-        n = select(this->server + 1, &fds, NULL, NULL, &tv);
-    #endif	
-    if (n == 0)
-    {
-        log_error("Timeout..");
-        il_eth_net_close_socket(&this->net);
-        return -1;
+        payload = &net->monitoring_raw_data[net->monitoring_data_size];
+        payload_sz = net->monitoring_raw_sz - net->monitoring_data_size;
     }
-    else if (n == -1)
-    {
-        log_error("Error..");
-        return -1;
+    else {
+        payload = (uint8_t *)net->extended_buff;
+        payload_sz = sizeof(net->extended_buff);
     }
 
-    /* read next frame */
-    r = recv(this->server, (char*)&pBuf[0], sizeof(frame), 0);
+    /* wait for the next frame */
+    /* socket teardown is left to the listener/reconnection path */
+    int r = net_recv_scatter(this, frame, payload, payload_sz);
+    if (r < 0) {
+        log_error("Monitoring frame not received: %s", ilerr_last());
+        return r;
+    }
 
     /* process frame: validate CRC, address, ACK */
-    crc = *(uint16_t *)&frame[6];
-    uint16_t crc_res = crc_calc_eth((uint16_t *)frame, 6);
+    crc = frame[ETH_MCB_CRC_POS];
+    uint16_t crc_res = il_crc__ccitt(frame, ETH_MCB_CRC_POS * sizeof(uint16_t));
     if (crc_res != crc) {
         return ilerr__eth(IL_EWRONGCRC);
     }
@@ -1738,7 +2774,7 @@ static int il_eth_net_recv_monitoring(il_eth_net_t *this, uint8_t subnode, uint1
     /* TODO: Check subnode */
 
     /* Check ACK */
-    hdr_l = *(uint16_t *)&frame[ETH_MCB_HDR_L_POS];
+    hdr_l = frame[ETH_MCB_HDR_L_POS];
     int cmd = (hdr_l & ETH_MCB_CMD_MSK) >> ETH_MCB_CMD_POS;
     if (cmd != ETH_MCB_CMD_ACK) {
         uint32_t err;
@@ -1751,27 +2787,25 @@ static int il_eth_net_recv_monitoring(il_eth_net_t *this, uint8_t subnode, uint1
     }
     extended_bit = (hdr_l & ETH_MCB_PENDING_MSK) >> ETH_MCB_PENDING_POS;
     if (extended_bit == 1) {
+        /* Read size of data (payload is already in place) */
+        memcpy(buf, &(frame[ETH_MCB_DATA_POS]), 2);
+        uint16_t size = *(uint16_t*)buf;
+        if ((size_t)r - sizeof(frame) < size)
+        {
+            size = (uint16_t)((size_t)r - sizeof(frame));
+        }
+
         /* Check if we are reading monitoring data */
         if (address == 0x00B2) {
-            /* Monitoring */
-            /* Read size of data */
-            memcpy(buf, &(frame[ETH_MCB_DATA_POS]), 2);
-            uint16_t size = *(uint16_t*)buf;
             if (num_bytes < size)
             {
                 size = num_bytes;
             }
-            uint32_t start_addr = net->monitoring_data_size;
-            memcpy((uint8_t*)&net->monitoring_raw_data[start_addr], (uint8_t*)&pBuf[14], size);
 
             net->monitoring_data_size += size;
         }
-        else {
-            memcpy(buf, &(frame[ETH_MCB_DATA_POS]), 2);
-            uint16_t size = *(uint16_t*)buf;
-            memcpy(net->extended_buff, (char*)&pBuf[14], size);
 
-        }
+        return size;
     }
     else {
         memcpy(buf, &(frame[ETH_MCB_DATA_POS]), sz);
@@ -1784,44 +2818,7 @@ static int process_monitoring_data(il_eth_net_t *this, il_net_t *net)
 {
     log_debug("Process monitoring data: %i", net->monitoring_data_size);
 
-    int num_mapped = net->monitoring_number_mapped_registers;
-    int bytes_per_block = net->monitoring_bytes_per_block;
-
-    int number_blocks = net->monitoring_data_size / bytes_per_block;
-    uint8_t* pData = net->monitoring_raw_data;
-
-    for (int i = 0; i < number_blocks; ++i)
-    {
-        int OffsetIndexIntraBlockInBytes = 0;
-        for (int j = 0; j < num_mapped; ++j)
-        {
-            il_reg_dtype_t type = net->monitoring_data_channels[j].type;
-            switch (type) {
-            case IL_REG_DTYPE_U16:
-                net->monitoring_data_channels[j].value.monitoring_data_u16[i] = *((uint16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(uint16_t);
-                break;
-            case IL_REG_DTYPE_S16:
-                net->monitoring_data_channels[j].value.monitoring_data_s16[i] = *((int16_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(int16_t);
-                break;
-            case IL_REG_DTYPE_U32:
-                net->monitoring_data_channels[j].value.monitoring_data_u32[i] = *((uint32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(uint32_t);
-                break;
-            case IL_REG_DTYPE_S32:
-                net->monitoring_data_channels[j].value.monitoring_data_s32[i] = *((int32_t*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(int32_t);
-                break;
-            case IL_REG_DTYPE_FLOAT:
-                net->monitoring_data_channels[j].value.monitoring_data_flt[i] = *((float*)(pData + OffsetIndexIntraBlockInBytes));
-                OffsetIndexIntraBlockInBytes += sizeof(float);
-                break;
-            }
-        }
-        pData += bytes_per_block;
-    }
-    return 0;
+    return il_net__monitoring_decode(net);
 }
 
 int il_eth_set_reconnection_retries(il_net_t *net, uint8_t retries)
@@ -1843,6 +2840,22 @@ int il_eth_set_reconnection_retries(il_net_t *net, uint8_t retries)
     return 0;
 }
 
+int il_eth_set_reconnection_backoff(il_net_t *net, uint32_t base,
+                                    uint32_t ceiling)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    if (base == 0 || ceiling < base) {
+        ilerr__set("Invalid reconnection backoff (%u-%u ms)", base, ceiling);
+        return IL_EINVAL;
+    }
+
+    this->backoff_base = base;
+    this->backoff_max = ceiling;
+
+    return 0;
+}
+
 int il_eth_set_recv_timeout(il_net_t *net, uint32_t timeout)
 {
     il_eth_net_t *this = to_eth_net(net);
@@ -1857,17 +2870,134 @@ int il_eth_set_status_check_stop(il_net_t *net, int stop)
     return 0;
 }
 
+int il_eth_set_wait_write_timeout(il_net_t *net, uint32_t timeout)
+{
+    il_eth_net_t *this = to_eth_net(net);
+    this->wait_write_timeout = timeout;
+    return 0;
+}
+
+int il_eth_set_pipeline_depth(il_net_t *net, size_t depth)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    if (depth == 0 || depth > PIPELINE_DEPTH_MAX) {
+        ilerr__set("Invalid pipeline depth (1-%d)", PIPELINE_DEPTH_MAX);
+        return IL_EINVAL;
+    }
+
+    osal_mutex_lock(this->net.lock);
+    this->pipeline_depth = depth;
+    osal_mutex_unlock(this->net.lock);
+
+    return 0;
+}
+
+int il_eth_set_reactor(il_net_t *net, int enable)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    if (enable)
+        return reactor_enable(this);
+
+    reactor_disable(this);
+
+    return 0;
+}
+
+static int il_eth_net__mgr_attach(il_net_t *net, int attach)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    if (attach) {
+        /* the manager takes over liveness checks and reconnection */
+        this->stop_reconnect = 1;
+        if (this->listener) {
+            osal_thread_join(this->listener, NULL);
+            this->listener = NULL;
+        }
+    }
+    else if (this->reconnection_retries > 0 && this->listener == NULL) {
+        this->stop = 0;
+        this->stop_reconnect = 0;
+
+        this->listener = osal_thread_create_(listener_eth, this);
+        if (!this->listener) {
+            ilerr__set("Listener thread creation failed");
+            return IL_EFAIL;
+        }
+    }
+
+    return 0;
+}
+
+static int il_eth_net__mgr_fd(il_net_t *net)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    return (int)this->server;
+}
+
+static int il_eth_net__probe_send(il_net_t *net, uint8_t subnode)
+{
+    il_eth_net_t *this = to_eth_net(net);
+
+    return net_send(this, subnode, STATUSWORD_ADDRESS, NULL, 0);
+}
+
+static int il_eth_net__probe_recv(il_net_t *net, uint8_t subnode, uint16_t *sw)
+{
+    il_eth_net_t *this = to_eth_net(net);
+    osal_timespec_t now;
+
+    /* the socket is known to be readable, do not wait */
+    osal_clock_deadline_set(&now, 0);
+
+    return net_recv(this, subnode, STATUSWORD_ADDRESS, (uint8_t *)sw,
+                    sizeof(*sw), NULL, NULL, &now);
+}
+
+/**
+ * Reopen the socket.
+ *
+ * @note
+ *	Unlike il_net_reconnect, a single attempt is made and the link is not
+ *	verified, the caller is expected to probe it afterwards. The connection
+ *	timeout is kept short, as the caller (connection manager) serves other
+ *	networks from the same thread.
+ */
+static int il_eth_net__reopen(il_net_t *net)
+{
+    il_eth_net_t *this = to_eth_net(net);
+    int r;
+
+    (void)il_eth_net_close_socket(net);
+
+    r = socket_open(this, REOPEN_CONNECT_TIMEOUT);
+    if (r < 0)
+        return r;
+
+    return (int)this->server;
+}
+
 /** ETH network operations. */
 const il_eth_net_ops_t il_eth_net_ops = {
     /* internal */
     ._read = il_eth_net__read,
     ._write = il_eth_net__write,
+    ._retain = il_eth_net__retain,
     ._release = il_eth_net__release,
     ._wait_write = il_eth_net__wait_write,
+    ._transfer = il_eth_net__transfer,
     ._sw_subscribe = il_net_base__sw_subscribe,
     ._sw_unsubscribe = il_net_base__sw_unsubscribe,
     ._emcy_subscribe = il_net_base__emcy_subscribe,
     ._emcy_unsubscribe = il_net_base__emcy_unsubscribe,
+    ._mgr_attach = il_eth_net__mgr_attach,
+    ._mgr_fd = il_eth_net__mgr_fd,
+    ._probe_send = il_eth_net__probe_send,
+    ._probe_recv = il_eth_net__probe_recv,
+    ._reopen = il_eth_net__reopen,
     /* public */
     .create = il_eth_net_create,
     .destroy = il_eth_net_destroy,
@@ -1897,7 +3027,11 @@ const il_eth_net_ops_t il_eth_net_ops = {
     .recv_monitoring = il_eth_net_recv_monitoring,
     .set_reconnection_retries = il_eth_set_reconnection_retries,
     .set_recv_timeout = il_eth_set_recv_timeout,
-    .set_status_check_stop = il_eth_set_status_check_stop
+    .set_status_check_stop = il_eth_set_status_check_stop,
+    .set_pipeline_depth = il_eth_set_pipeline_depth,
+    .set_wait_write_timeout = il_eth_set_wait_write_timeout,
+    .set_reactor = il_eth_set_reactor,
+    .set_reconnection_backoff = il_eth_set_reconnection_backoff
 };
 
 /** MCB network device monitor operations. */
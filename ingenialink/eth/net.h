@@ -10,7 +10,7 @@
 #ifdef _WIN32
 	#include <winsock2.h>
 #endif
-#ifdef linux
+#ifdef __linux__
 	#include <sys/socket.h>
 	#include <netinet/in.h>
 	#include <netinet/ip.h>
@@ -23,9 +23,80 @@
 /** Default read timeout. */
 #define READ_TIMEOUT_DEF	400000
 
+/** Default wait write timeout (ms). */
+#define WAIT_WRITE_TIMEOUT_DEF	2000
+
+/** Default number of outstanding requests (pipelined transfers). */
+#define PIPELINE_DEPTH_DEF	8
+
+/** Maximum number of outstanding requests (pipelined transfers). */
+#define PIPELINE_DEPTH_MAX	32
+
 /** Default reconnection retries. */
 #define RECONNECTION_RETRIES_DEF	7
 
+/** Default first reconnection retry interval (ms). */
+#define RECONNECT_BACKOFF_BASE_DEF	20
+
+/** Default maximum reconnection retry interval (ms). */
+#define RECONNECT_BACKOFF_MAX_DEF	2000
+
+/** Reconnection connect timeout (ms). */
+#define RECONNECT_CONNECT_TIMEOUT	2000
+
+/** Socket reopen connect timeout (ms). */
+#define REOPEN_CONNECT_TIMEOUT		100
+
+/** Reactor job types. */
+typedef enum {
+	/** Register read. */
+	ETH_JOB_READ,
+	/** Register write. */
+	ETH_JOB_WRITE,
+	/** Register write (wait for completion). */
+	ETH_JOB_WAIT_WRITE,
+	/** Pipelined transfer. */
+	ETH_JOB_TRANSFER,
+	/** Monitoring data download. */
+	ETH_JOB_MONITORING,
+} eth_job_type_t;
+
+/** Reactor job. */
+typedef struct eth_job {
+	/** Next job (submission queue). */
+	struct eth_job *next;
+	/** Type. */
+	eth_job_type_t type;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Address. */
+	uint16_t address;
+	/** Data buffer. */
+	void *buf;
+	/** Data buffer size. */
+	size_t sz;
+	/** Extended frame. */
+	uint16_t extended;
+	/** Requests (transfers). */
+	il_net_req_t *reqs;
+	/** Number of requests (transfers). */
+	size_t n;
+	/** Result. */
+	int r;
+	/** Completion flag. */
+	int done;
+	/** Completion condition (borrowed from the reactor waiter pool). */
+	osal_cond_t *cond;
+} eth_job_t;
+
+/** Reactor completion waiter (pooled, reused across submissions). */
+typedef struct eth_waiter {
+	/** Completion condition. */
+	osal_cond_t *cond;
+	/** Next free waiter. */
+	struct eth_waiter *next;
+} eth_waiter_t;
+
 /** Vendor ID register address. */
 #define VENDOR_ID_ADDR		0x06E0
 
@@ -67,8 +138,40 @@ typedef struct il_eth_net {
 	int protocol;
 	/** Reconnection retries. */
 	uint8_t reconnection_retries;
+	/** First reconnection retry interval (ms). */
+	uint32_t backoff_base;
+	/** Maximum reconnection retry interval (ms). */
+	uint32_t backoff_max;
+	/** Reconnection jitter generator state. */
+	uint32_t backoff_seed;
 	/** Recv timeout in ms*/
 	uint32_t recv_timeout;
+	/** Maximum number of outstanding requests. */
+	size_t pipeline_depth;
+	/** Wait write timeout (ms). */
+	uint32_t wait_write_timeout;
+	/** Reactor thread (NULL if reactor mode is disabled). */
+	osal_thread_t *reactor;
+	/** Reactor accepting jobs flag. */
+	int reactor_on;
+	/** Number of threads in the reactor submission path. */
+	int reactor_users;
+	/** Reactor submission queue (lock-free stack, drained in FIFO order). */
+	eth_job_t *reactor_sq;
+	/** Reactor idle flag. */
+	int reactor_idle;
+	/** Reactor stop flag. */
+	int reactor_stop;
+	/** Reactor being disabled (waiting for submitters) flag. */
+	int reactor_draining;
+	/** Free completion waiters (reactor_lock held). */
+	eth_waiter_t *reactor_pool;
+	/** Reactor lock (only used to sleep and to signal completions). */
+	osal_mutex_t *reactor_lock;
+	/** Reactor wake-up condition. */
+	osal_cond_t *reactor_cond;
+	/** Last submitter gone condition. */
+	osal_cond_t *reactor_drained;
 
 	uint8_t use_eoe_comms;
 
@@ -21,149 +21,6 @@ static int not_supported(void)
 	return IL_ENOTSUP;
 }
 
-/**
- * Obtain the current statusword value.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- *
- * @return
- *	Statusword value.
- */
-static uint16_t sw_get(il_servo_t *servo, uint8_t subnode)
-{
-	// Init internal variables
-	double sw;
-	// Status word register
-	il_reg_t status_word_register = {
-		.subnode = subnode,
-		.address = 0x0011,
-		.dtype = IL_REG_DTYPE_U16,
-		.access = IL_REG_ACCESS_RW,
-		.phy = IL_REG_PHY_NONE,
-		.range = {
-			.min.u16 = 0,
-			.max.u16 = UINT16_MAX
-		},
-		.labels = NULL,
-		.enums = NULL,
-		.enums_count = 0
-	};
-	(void)il_servo_read(servo, &status_word_register, NULL, &sw);
-	if (servo->sw.value != sw) {
-		servo->sw.value = sw;
-		osal_cond_broadcast(servo->sw.changed);
-	}
-
-	return sw;
-}
-
-/**
- * Wait until the statusword changes its value.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- * @param [in, out] sw
- *	Current statusword value, where next value will be stored.
- * @param [in, out] timeout
- *	Timeout (ms), if positive will be updated with remaining ms.
- *
- * @return
- *	0 on success, error code otherwise.
- */
-static int sw_wait_change(il_servo_t *servo, uint16_t *sw, int *timeout, uint8_t subnode)
-{
-	int r = 0;
-	uint16_t buff;
-	osal_timespec_t start = { 0, 0 }, end, diff;
-	// Status word register
-	il_reg_t status_word_register = {
-		.subnode = subnode,
-		.address = 0x0011,
-		.dtype = IL_REG_DTYPE_U16,
-		.access = IL_REG_ACCESS_RW,
-		.phy = IL_REG_PHY_NONE,
-		.range = {
-			.min.u16 = 0,
-			.max.u16 = UINT16_MAX
-		},
-		.labels = NULL,
-		.enums = NULL,
-		.enums_count = 0
-	};
-
-	/* obtain start time */
-	if (*timeout > 0) {
-		if (osal_clock_gettime(&start) < 0) {
-			ilerr__set("Could not obtain system time");
-			return IL_EFAIL;
-		}
-	}
-	double time_s = 0;
-	time_s = (double) *timeout / 1000;
-	(void)il_servo_raw_read_u16(servo, &status_word_register, NULL, &buff);
-	while (buff == *sw) {
-		osal_clock_gettime(&diff);
-		if (diff.s > start.s + time_s) {
-			ilerr__set("Operation timed out");
- 			r = IL_ETIMEDOUT;
- 			goto unlock;
-		}
-		(void)il_servo_raw_read_u16(servo, &status_word_register, NULL, &buff);
-	}
-
-	servo->sw.value = buff;
-	*sw = buff;
-
-out:
-
-unlock:
-
-	return r;
-}
-
-/**
- * Wait until the statusword has the requested value
- *
- * @note
- *	The timeout is not an absolute timeout, but an interval timeout.
- *
- * @param [in] servo
- *	IngeniaLink servo.
- * @param [in] msk
- *	Statusword mask.
- * @param [in] val
- *	Statusword value.
- * @param [in] timeout
- *	Timeout (ms).
- */
-static int sw_wait_value(il_servo_t *servo, uint16_t msk, uint16_t val,
-			 int timeout)
-{
-	int r = 0;
-	uint16_t result;
-
-	/* wait until the flag changes to the requested state */
-
-	do {
-		result = servo->sw.value & msk;
-		if (result != val) {
-			r = osal_cond_wait(servo->sw.changed, servo->sw.lock,
-					   timeout);
-			if (r == OSAL_ETIMEDOUT) {
-				ilerr__set("Operation timed out");
-				r = IL_ETIMEDOUT;
-			} else if (r < 0) {
-				ilerr__set("Statusword wait change failed");
-				r = IL_EFAIL;
-			}
-		}
-	} while ((result != val) && (r == 0));
-
-
-	return r;
-}
-
 /**
  * Destroy servo instance.
  *
@@ -367,7 +224,7 @@ static int il_eth_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout)
 	int r;
 	uint16_t sw;
 	il_servo_state_t state;
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -379,7 +236,7 @@ static int il_eth_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout)
 			if (r < 0)
 				return r;
 
-			sw = sw_get(servo, subnode);
+			(void)il_servo_base__sw_read(servo, subnode, &sw);
 		/* check state and command action to reach disabled */
 		} else if (state != IL_SERVO_STATE_DISABLED) {
 			IL_REG_MCB_CTL_WORD.subnode = subnode;
@@ -389,7 +246,8 @@ static int il_eth_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout)
 				return r;
 
 			/* wait until statusword changes */
-			r = sw_wait_change(servo, &sw, &timeout, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout);
 			if (r < 0)
 				return r;
 		}
@@ -405,7 +263,7 @@ static int il_eth_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subnod
 	il_servo_state_t state;
 	int timeout_ = timeout;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -417,7 +275,7 @@ static int il_eth_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subnod
 			if (r < 0)
 				return r;
 
-			sw = sw_get(servo, subnode);
+			(void)il_servo_base__sw_read(servo, subnode, &sw);
 		/* check state and command action to reach switch on */
 		} else if (state != IL_SERVO_STATE_ON) {
 			if (state == IL_SERVO_STATE_FAULT)
@@ -440,7 +298,8 @@ static int il_eth_servo_switch_on(il_servo_t *servo, int timeout, uint8_t subnod
 				return r;
 
 			/* wait for state change */
-			r = sw_wait_change(servo, &sw, &timeout_, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout_);
 			if (r < 0)
 				return r;
 		}
@@ -456,7 +315,7 @@ static int il_eth_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 	il_servo_state_t state;
 	int timeout_ = timeout;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	servo->ops->_state_decode(sw, &state, NULL);
 
@@ -467,10 +326,10 @@ static int il_eth_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 		if (r < 0)
 			return r;
 
-		sw = sw_get(servo, subnode);
+		(void)il_servo_base__sw_read(servo, subnode, &sw);
 	}
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
 
@@ -494,7 +353,8 @@ static int il_eth_servo_enable(il_servo_t *servo, uint8_t subnode, int timeout)
 				return r;
 
 			/* wait for state change */
-			r = sw_wait_change(servo, &sw, &timeout_, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout_);
 			if (r < 0)
 				return r;
 
@@ -511,7 +371,7 @@ static int il_eth_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int time
 	il_servo_state_t state;
 	int retries = 0;
 
-	sw = sw_get(servo, subnode);
+	(void)il_servo_base__sw_read(servo, subnode, &sw);
 
 	do {
 		servo->ops->_state_decode(sw, &state, NULL);
@@ -536,7 +396,8 @@ static int il_eth_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int time
 				return r;
 
 			/* wait until statusword changes */
-			r = sw_wait_change(servo, &sw, &timeout, subnode);
+			r = il_servo_base__sw_wait_change(servo, subnode, &sw,
+							  &timeout);
 			if (r < 0)
 				return r;
 
@@ -698,7 +559,8 @@ static int il_eth_servo_velocity_res_get(il_servo_t *servo, uint32_t *res)
 
 static int il_eth_servo_wait_reached(il_servo_t *servo, int timeout)
 {
-	return sw_wait_value(servo, IL_MC_SW_TR, IL_MC_SW_TR, timeout);
+	return il_servo_base__sw_wait_value(servo, 1, IL_MC_SW_TR, IL_MC_SW_TR,
+					    timeout);
 }
 
 int il_eth_servo_state_subs_stop(il_servo_t *servo, int stop)
@@ -750,6 +612,7 @@ const il_servo_ops_t il_eth_servo_ops = {
 	.raw_read_s64 = il_servo_base__raw_read_s64,
 	.raw_read_float = il_servo_base__raw_read_float,
 	.read = il_servo_base__read,
+	.read_many = il_servo_base__read_many,
 	.raw_write_u8 = il_servo_base__raw_write_u8,
 	.raw_write_s8 = il_servo_base__raw_write_s8,
 	.raw_write_u16 = il_servo_base__raw_write_u16,
@@ -761,6 +624,7 @@ const il_servo_ops_t il_eth_servo_ops = {
 	.raw_write_s64 = il_servo_base__raw_write_s64,
 	.raw_write_float = il_servo_base__raw_write_float,
 	.write = il_servo_base__write,
+	.write_many = il_servo_base__write_many,
 	.disable = il_eth_servo_disable,
 	.switch_on = il_eth_servo_switch_on,
 	.enable = il_eth_servo_enable,
@@ -0,0 +1,608 @@
+#include "mirror.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ingenialink/err.h"
+#include "ingenialink/net.h"
+#include "ingenialink/registers.h"
+#include "servo.h"
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/**
+ * Hash a register location.
+ *
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ *
+ * @return
+ *	Hash value.
+ */
+static size_t location_hash(uint8_t subnode, uint16_t address)
+{
+	uint32_t key = ((uint32_t)subnode << 16) | address;
+
+	/* finalizer mix, so that all key bits reach the low (index) bits */
+	key ^= key >> 16;
+	key *= 0x85EBCA6BU;
+	key ^= key >> 13;
+	key *= 0xC2B2AE35U;
+	key ^= key >> 16;
+
+	return (size_t)key;
+}
+
+/**
+ * Find the slot of a register.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ *
+ * @return
+ *	Slot of the register entry, or free slot where it would be stored.
+ */
+static size_t slot_find(il_servo_mirror_t *mirror, uint8_t subnode,
+			uint16_t address)
+{
+	size_t msk = mirror->sz - 1;
+	size_t i = location_hash(subnode, address) & msk;
+
+	while (mirror->entries[i].used &&
+	       (mirror->entries[i].subnode != subnode ||
+		mirror->entries[i].address != address))
+		i = (i + 1) & msk;
+
+	return i;
+}
+
+/**
+ * Obtain the entry of a register.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ *
+ * @return
+ *	Entry (NULL if the register is not mirrored).
+ */
+static mirror_entry_t *entry_get(il_servo_mirror_t *mirror, uint8_t subnode,
+				 uint16_t address)
+{
+	mirror_entry_t *entry;
+
+	if (!mirror->enabled || mirror->cnt == 0)
+		return NULL;
+
+	entry = &mirror->entries[slot_find(mirror, subnode, address)];
+
+	return entry->used ? entry : NULL;
+}
+
+/**
+ * Double the table size.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int table_grow(il_servo_mirror_t *mirror)
+{
+	mirror_entry_t *old = mirror->entries;
+	size_t old_sz = mirror->sz, i;
+
+	mirror->entries = calloc(old_sz * 2, sizeof(*mirror->entries));
+	if (!mirror->entries) {
+		mirror->entries = old;
+		ilerr__set("Mirror table allocation failed");
+		return IL_ENOMEM;
+	}
+
+	mirror->sz = old_sz * 2;
+
+	for (i = 0; i < old_sz; i++) {
+		if (old[i].used)
+			mirror->entries[slot_find(mirror, old[i].subnode,
+						  old[i].address)] = old[i];
+	}
+
+	free(old);
+
+	return 0;
+}
+
+/**
+ * Remove an entry, keeping probe sequences intact.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] i
+ *	Entry slot.
+ */
+static void entry_remove(il_servo_mirror_t *mirror, size_t i)
+{
+	mirror_entry_t *entries = mirror->entries;
+	size_t msk = mirror->sz - 1;
+	size_t j = i, k;
+
+	mirror->cnt--;
+
+	for (;;) {
+		entries[i].used = 0;
+
+		/* move back the next entry that can fill the hole */
+		do {
+			j = (j + 1) & msk;
+			if (!entries[j].used)
+				return;
+
+			k = location_hash(entries[j].subnode,
+					  entries[j].address) & msk;
+		} while ((i <= j) ? ((i < k) && (k <= j)) :
+				    ((i < k) || (k <= j)));
+
+		entries[i] = entries[j];
+		i = j;
+	}
+}
+
+/**
+ * Check if an entry value can be served.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] entry
+ *	Entry.
+ *
+ * @return
+ *	1 if the value can be served, 0 otherwise.
+ */
+static int entry_fresh(il_servo_mirror_t *mirror, const mirror_entry_t *entry)
+{
+	if (!entry->valid)
+		return 0;
+
+	switch (entry->policy) {
+	case IL_SERVO_MIRROR_STATIC:
+		return 1;
+	case IL_SERVO_MIRROR_TTL:
+		return osal_clock_deadline_left(&entry->expires) > 0;
+	case IL_SERVO_MIRROR_LIVE:
+		return mirror->refresh > 0 &&
+		       osal_clock_deadline_left(&entry->expires) > 0;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Store an entry value.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] entry
+ *	Entry.
+ * @param [in] buf
+ *	Value.
+ * @param [in] sz
+ *	Value size.
+ */
+static void entry_store(il_servo_mirror_t *mirror, mirror_entry_t *entry,
+			const void *buf, size_t sz)
+{
+	if (sz > sizeof(entry->value) || (entry->sz && entry->sz != sz)) {
+		entry->valid = 0;
+		return;
+	}
+
+	memcpy(&entry->value, buf, sz);
+	entry->sz = sz;
+	entry->valid = 1;
+
+	if (entry->policy == IL_SERVO_MIRROR_TTL)
+		osal_clock_deadline_set(&entry->expires,
+					(long long)entry->ttl *
+					OSAL_CLOCK_NANOSPERMSEC);
+	else if (entry->policy == IL_SERVO_MIRROR_LIVE)
+		osal_clock_deadline_set(&entry->expires,
+					(long long)mirror->refresh *
+					MIRROR_LIVE_PERIODS *
+					OSAL_CLOCK_NANOSPERMSEC);
+}
+
+/**
+ * Background refresher, reads all live registers in a single transfer.
+ *
+ * @param [in] args
+ *	Arguments (il_servo_t *).
+ */
+static int refresh_td(void *args)
+{
+	il_servo_t *servo = args;
+	il_servo_mirror_t *mirror = &servo->mirror;
+	il_net_req_t *reqs = NULL;
+	il_reg_value_t *vals = NULL;
+	uint64_t *gens = NULL;
+	size_t cap = 0;
+
+	osal_mutex_lock(mirror->lock);
+
+	while (!mirror->stop) {
+		size_t i, cnt = 0;
+
+		/* collect live registers */
+		for (i = 0; i < mirror->sz; i++) {
+			mirror_entry_t *entry = &mirror->entries[i];
+
+			if (!entry->used ||
+			    entry->policy != IL_SERVO_MIRROR_LIVE ||
+			    entry->sz == 0)
+				continue;
+
+			if (cnt == cap) {
+				size_t cap_ = cap ? cap * 2 : MIRROR_SZ_DEF;
+				void *p;
+
+				p = realloc(reqs, cap_ * sizeof(*reqs));
+				if (!p)
+					break;
+				reqs = p;
+
+				p = realloc(vals, cap_ * sizeof(*vals));
+				if (!p)
+					break;
+				vals = p;
+
+				p = realloc(gens, cap_ * sizeof(*gens));
+				if (!p)
+					break;
+				gens = p;
+
+				cap = cap_;
+			}
+
+			reqs[cnt].id = servo->id;
+			reqs[cnt].subnode = entry->subnode;
+			reqs[cnt].address = entry->address;
+			reqs[cnt].sz = entry->sz;
+			reqs[cnt].write = 0;
+			reqs[cnt].r = 0;
+			gens[cnt] = entry->gen;
+			cnt++;
+		}
+
+		osal_mutex_unlock(mirror->lock);
+
+		for (i = 0; i < cnt; i++)
+			reqs[i].buf = &vals[i];
+
+		if (cnt > 0)
+			(void)il_net__transfer(servo->net, reqs, cnt);
+
+		osal_mutex_lock(mirror->lock);
+
+		for (i = 0; i < cnt; i++) {
+			mirror_entry_t *entry;
+
+			if (reqs[i].r < 0)
+				mirror->stats.errors++;
+
+			entry = entry_get(mirror, reqs[i].subnode,
+					  reqs[i].address);
+			if (!entry || entry->gen != gens[i])
+				continue;
+
+			/* a failed refresh must not leave the old value live */
+			if (reqs[i].r < 0)
+				entry->valid = 0;
+			else
+				entry_store(mirror, entry, &vals[i],
+					    reqs[i].sz);
+		}
+
+		mirror->stats.refreshes++;
+
+		if (!mirror->stop)
+			(void)osal_cond_wait(mirror->cond, mirror->lock,
+					     mirror->refresh);
+	}
+
+	osal_mutex_unlock(mirror->lock);
+
+	free(gens);
+	free(vals);
+	free(reqs);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Internal
+ ******************************************************************************/
+
+int il_servo_mirror__init(il_servo_mirror_t *mirror)
+{
+	memset(mirror, 0, sizeof(*mirror));
+
+	mirror->lock = osal_mutex_create();
+	if (!mirror->lock) {
+		ilerr__set("Mirror lock allocation failed");
+		return IL_EFAIL;
+	}
+
+	mirror->cond = osal_cond_create();
+	if (!mirror->cond) {
+		ilerr__set("Mirror condition allocation failed");
+		osal_mutex_destroy(mirror->lock);
+		return IL_EFAIL;
+	}
+
+	return 0;
+}
+
+void il_servo_mirror__deinit(il_servo_mirror_t *mirror)
+{
+	il_servo_mirror_disable(container_of(mirror, il_servo_t, mirror));
+
+	osal_cond_destroy(mirror->cond);
+	osal_mutex_destroy(mirror->lock);
+}
+
+int il_servo_mirror__lookup(il_servo_mirror_t *mirror, uint8_t subnode,
+			    uint16_t address, void *buf, size_t sz,
+			    uint64_t *gen)
+{
+	mirror_entry_t *entry;
+	int hit = 0;
+
+	*gen = 0;
+
+	osal_mutex_lock(mirror->lock);
+
+	entry = entry_get(mirror, subnode, address);
+	if (entry) {
+		if (entry_fresh(mirror, entry) && entry->sz == sz) {
+			memcpy(buf, &entry->value, sz);
+			mirror->stats.hits++;
+			hit = 1;
+		} else {
+			*gen = entry->gen;
+			mirror->stats.misses++;
+		}
+	}
+
+	osal_mutex_unlock(mirror->lock);
+
+	return hit;
+}
+
+void il_servo_mirror__fill(il_servo_mirror_t *mirror, uint8_t subnode,
+			   uint16_t address, const void *buf, size_t sz,
+			   uint64_t gen)
+{
+	mirror_entry_t *entry;
+
+	if (gen == 0)
+		return;
+
+	osal_mutex_lock(mirror->lock);
+
+	entry = entry_get(mirror, subnode, address);
+	if (entry && entry->gen == gen)
+		entry_store(mirror, entry, buf, sz);
+
+	osal_mutex_unlock(mirror->lock);
+}
+
+void il_servo_mirror__written(il_servo_mirror_t *mirror, uint8_t subnode,
+			      uint16_t address, const void *buf, size_t sz,
+			      int r)
+{
+	mirror_entry_t *entry;
+
+	osal_mutex_lock(mirror->lock);
+
+	entry = entry_get(mirror, subnode, address);
+	if (entry) {
+		entry->gen++;
+		if (r == 0)
+			entry_store(mirror, entry, buf, sz);
+		else
+			entry->valid = 0;
+	}
+
+	osal_mutex_unlock(mirror->lock);
+}
+
+/*******************************************************************************
+ * Public
+ ******************************************************************************/
+
+int il_servo_mirror_enable(il_servo_t *servo, int refresh)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	int r = 0;
+
+	if (refresh < 0) {
+		ilerr__set("Invalid refresh period");
+		return IL_EINVAL;
+	}
+
+	osal_mutex_lock(mirror->lock);
+
+	if (mirror->enabled) {
+		ilerr__set("Mirror already enabled");
+		r = IL_EALREADY;
+		goto unlock;
+	}
+
+	mirror->entries = calloc(MIRROR_SZ_DEF, sizeof(*mirror->entries));
+	if (!mirror->entries) {
+		ilerr__set("Mirror table allocation failed");
+		r = IL_ENOMEM;
+		goto unlock;
+	}
+
+	mirror->sz = MIRROR_SZ_DEF;
+	mirror->cnt = 0;
+	mirror->refresh = refresh;
+	mirror->stop = 0;
+	memset(&mirror->stats, 0, sizeof(mirror->stats));
+
+	if (refresh > 0) {
+		mirror->td = osal_thread_create_(refresh_td, servo);
+		if (!mirror->td) {
+			ilerr__set("Mirror refresher could not be created");
+			free(mirror->entries);
+			mirror->entries = NULL;
+			r = IL_EFAIL;
+			goto unlock;
+		}
+	}
+
+	mirror->enabled = 1;
+
+unlock:
+	osal_mutex_unlock(mirror->lock);
+
+	return r;
+}
+
+void il_servo_mirror_disable(il_servo_t *servo)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	osal_thread_t *td;
+
+	osal_mutex_lock(mirror->lock);
+	td = mirror->td;
+	mirror->td = NULL;
+	mirror->stop = 1;
+	osal_cond_signal(mirror->cond);
+	osal_mutex_unlock(mirror->lock);
+
+	if (td)
+		osal_thread_join(td, NULL);
+
+	osal_mutex_lock(mirror->lock);
+	free(mirror->entries);
+	mirror->entries = NULL;
+	mirror->sz = 0;
+	mirror->cnt = 0;
+	mirror->enabled = 0;
+	osal_mutex_unlock(mirror->lock);
+}
+
+int il_servo_mirror_policy_set(il_servo_t *servo, const il_reg_t *reg,
+			       const char *id, uint8_t subnode,
+			       il_servo_mirror_policy_t policy, int ttl)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	mirror_entry_t *entry;
+	size_t i;
+	int r = 0;
+
+	/* obtain register (predefined or from dictionary) */
+	if (!reg) {
+		if (!servo->dict) {
+			ilerr__set("No dictionary loaded");
+			return IL_EFAIL;
+		}
+
+		r = il_dict_reg_get(servo->dict, id, &reg, subnode);
+		if (r < 0)
+			return r;
+	}
+
+	if (policy == IL_SERVO_MIRROR_TTL && ttl <= 0) {
+		ilerr__set("Invalid time to live");
+		return IL_EINVAL;
+	}
+
+	osal_mutex_lock(mirror->lock);
+
+	if (!mirror->enabled) {
+		ilerr__set("Mirror not enabled");
+		r = IL_ESTATE;
+		goto unlock;
+	}
+
+	i = slot_find(mirror, reg->subnode, (uint16_t)reg->address);
+	entry = &mirror->entries[i];
+
+	if (policy == IL_SERVO_MIRROR_NONE) {
+		if (entry->used)
+			entry_remove(mirror, i);
+		goto unlock;
+	}
+
+	if (!entry->used) {
+		/* keep load factor below 1/2 */
+		if ((mirror->cnt + 1) * 2 > mirror->sz) {
+			r = table_grow(mirror);
+			if (r < 0)
+				goto unlock;
+
+			i = slot_find(mirror, reg->subnode,
+				      (uint16_t)reg->address);
+			entry = &mirror->entries[i];
+		}
+
+		memset(entry, 0, sizeof(*entry));
+		entry->used = 1;
+		entry->subnode = reg->subnode;
+		entry->address = (uint16_t)reg->address;
+		mirror->cnt++;
+	}
+
+	entry->policy = policy;
+	entry->ttl = ttl;
+	entry->sz = il_reg__dtype_sz(reg->dtype);
+	entry->valid = 0;
+	entry->gen++;
+
+unlock:
+	osal_mutex_unlock(mirror->lock);
+
+	return r;
+}
+
+void il_servo_mirror_invalidate(il_servo_t *servo)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	size_t i;
+
+	osal_mutex_lock(mirror->lock);
+
+	for (i = 0; i < mirror->sz; i++) {
+		if (mirror->entries[i].used) {
+			mirror->entries[i].gen++;
+			mirror->entries[i].valid = 0;
+		}
+	}
+
+	osal_mutex_unlock(mirror->lock);
+}
+
+void il_servo_mirror_stats_get(il_servo_t *servo,
+			       il_servo_mirror_stats_t *stats)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+
+	osal_mutex_lock(mirror->lock);
+	*stats = mirror->stats;
+	stats->entries = mirror->cnt;
+	osal_mutex_unlock(mirror->lock);
+}
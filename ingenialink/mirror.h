@@ -0,0 +1,149 @@
+#ifndef MIRROR_H_
+#define MIRROR_H_
+
+#include "public/ingenialink/servo.h"
+
+#include "osal/osal.h"
+
+/** Initial mirror table size (entries, power of 2). */
+#define MIRROR_SZ_DEF		32
+
+/** Refresh periods a live value is served for after being read. */
+#define MIRROR_LIVE_PERIODS	2
+
+/** Mirror entry. */
+typedef struct {
+	/** Used flag. */
+	int used;
+	/** Subnode. */
+	uint8_t subnode;
+	/** Address. */
+	uint16_t address;
+	/** Policy. */
+	il_servo_mirror_policy_t policy;
+	/** Time to live (ms). */
+	int ttl;
+	/** Value (as transferred). */
+	il_reg_value_t value;
+	/** Value size (0 until known). */
+	size_t sz;
+	/** Value valid flag. */
+	int valid;
+	/** Value expiration (TTL policy). */
+	osal_timespec_t expires;
+	/** Generation (bumped on every write). */
+	uint64_t gen;
+} mirror_entry_t;
+
+/** Register mirror. */
+typedef struct {
+	/** Lock (everything below). */
+	osal_mutex_t *lock;
+	/** Enabled flag. */
+	int enabled;
+	/** Entries (open addressing table). */
+	mirror_entry_t *entries;
+	/** Table size (power of 2). */
+	size_t sz;
+	/** Used entries. */
+	size_t cnt;
+	/** Refresh period (ms, 0 if not refreshed). */
+	int refresh;
+	/** Statistics. */
+	il_servo_mirror_stats_t stats;
+	/** Refresher stop condition. */
+	osal_cond_t *cond;
+	/** Refresher thread. */
+	osal_thread_t *td;
+	/** Refresher stop flag. */
+	int stop;
+} il_servo_mirror_t;
+
+/**
+ * Initialize the register mirror (disabled).
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+int il_servo_mirror__init(il_servo_mirror_t *mirror);
+
+/**
+ * Deinitialize the register mirror.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ */
+void il_servo_mirror__deinit(il_servo_mirror_t *mirror);
+
+/**
+ * Look up a register value.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ * @param [out] buf
+ *	Where value will be stored (on hit).
+ * @param [in] sz
+ *	Value size.
+ * @param [out] gen
+ *	Entry generation, to be given to il_servo_mirror__fill (0 if the
+ *	register is not mirrored).
+ *
+ * @return
+ *	1 if the value was served from the mirror, 0 otherwise.
+ */
+int il_servo_mirror__lookup(il_servo_mirror_t *mirror, uint8_t subnode,
+			    uint16_t address, void *buf, size_t sz,
+			    uint64_t *gen);
+
+/**
+ * Store a value read from the drive.
+ *
+ * @note
+ *	The value is discarded if the register was written meanwhile (the
+ *	generation changed), so a slow read can not override a newer write.
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ * @param [in] buf
+ *	Value.
+ * @param [in] sz
+ *	Value size.
+ * @param [in] gen
+ *	Generation obtained by il_servo_mirror__lookup.
+ */
+void il_servo_mirror__fill(il_servo_mirror_t *mirror, uint8_t subnode,
+			   uint16_t address, const void *buf, size_t sz,
+			   uint64_t gen);
+
+/**
+ * Account a register write (write-through).
+ *
+ * @param [in] mirror
+ *	Register mirror.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ * @param [in] buf
+ *	Value written.
+ * @param [in] sz
+ *	Value size.
+ * @param [in] r
+ *	Write result (the value is invalidated on failure).
+ */
+void il_servo_mirror__written(il_servo_mirror_t *mirror, uint8_t subnode,
+			      uint16_t address, const void *buf, size_t sz,
+			      int r);
+
+#endif
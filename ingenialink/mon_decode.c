@@ -0,0 +1,631 @@
+#include "ingenialink/mon_decode.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ingenialink/err.h"
+#include "ingenialink/registers.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define HAS_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define HAS_NEON
+#include <arm_neon.h>
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define HAS_NEON_64
+#endif
+#endif
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/** Number of supported element sizes (1, 2, 4 and 8 bytes). */
+#define SZ_CNT		4
+
+/** Vector kernels, indexed by element size and number of channels. */
+typedef il_mon_decode_kernel_t kernels_t[SZ_CNT][5];
+
+/**
+ * Obtain the kernel table index of an element size.
+ *
+ * @param [in] sz
+ *	Element size (bytes).
+ *
+ * @return
+ *	Index.
+ */
+static int sz_idx(size_t sz)
+{
+	switch (sz) {
+	case 1:
+		return 0;
+	case 2:
+		return 1;
+	case 4:
+		return 2;
+	default:
+		return 3;
+	}
+}
+
+#ifdef HAS_SSE2
+/*
+ * SSE2 kernels.
+ *
+ * All of them are built on a 2-way de-interleave (even/odd elements of two
+ * vectors); 4 channels are obtained by applying it twice.
+ */
+
+#define SSE2_LD(p) _mm_loadu_si128((const __m128i *)(p))
+#define SSE2_ST(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+
+static void sse2_deint8(__m128i x, __m128i y, __m128i *e, __m128i *o)
+{
+	const __m128i m = _mm_set1_epi16(0x00ff);
+
+	*e = _mm_packus_epi16(_mm_and_si128(x, m), _mm_and_si128(y, m));
+	*o = _mm_packus_epi16(_mm_srli_epi16(x, 8), _mm_srli_epi16(y, 8));
+}
+
+static void sse2_deint16(__m128i x, __m128i y, __m128i *e, __m128i *o)
+{
+	x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+	x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+	x = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 1, 2, 0));
+
+	y = _mm_shufflelo_epi16(y, _MM_SHUFFLE(3, 1, 2, 0));
+	y = _mm_shufflehi_epi16(y, _MM_SHUFFLE(3, 1, 2, 0));
+	y = _mm_shuffle_epi32(y, _MM_SHUFFLE(3, 1, 2, 0));
+
+	*e = _mm_unpacklo_epi64(x, y);
+	*o = _mm_unpackhi_epi64(x, y);
+}
+
+static void sse2_deint32(__m128i x, __m128i y, __m128i *e, __m128i *o)
+{
+	__m128 xf = _mm_castsi128_ps(x);
+	__m128 yf = _mm_castsi128_ps(y);
+
+	*e = _mm_castps_si128(_mm_shuffle_ps(xf, yf, _MM_SHUFFLE(2, 0, 2, 0)));
+	*o = _mm_castps_si128(_mm_shuffle_ps(xf, yf, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+static void sse2_deint64(__m128i x, __m128i y, __m128i *e, __m128i *o)
+{
+	*e = _mm_unpacklo_epi64(x, y);
+	*o = _mm_unpackhi_epi64(x, y);
+}
+
+#define SSE2_KERNELS(bits, es)						\
+static size_t sse2_x2_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	uint8_t *d0 = dst[0], *d1 = dst[1];				\
+	size_t i;							\
+									\
+	for (i = 0; i + 16 / (es) <= n; i += 16 / (es)) {		\
+		const uint8_t *p = &src[i * 2 * (es)];			\
+		__m128i e, o;						\
+									\
+		sse2_deint##bits(SSE2_LD(p), SSE2_LD(p + 16), &e, &o);	\
+		SSE2_ST(&d0[i * (es)], e);				\
+		SSE2_ST(&d1[i * (es)], o);				\
+	}								\
+									\
+	return i;							\
+}									\
+									\
+static size_t sse2_x4_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	uint8_t *d0 = dst[0], *d1 = dst[1], *d2 = dst[2], *d3 = dst[3];	\
+	size_t i;							\
+									\
+	for (i = 0; i + 16 / (es) <= n; i += 16 / (es)) {		\
+		const uint8_t *p = &src[i * 4 * (es)];			\
+		__m128i e0, o0, e1, o1, a, b, c, d;			\
+									\
+		sse2_deint##bits(SSE2_LD(p), SSE2_LD(p + 16), &e0, &o0);	\
+		sse2_deint##bits(SSE2_LD(p + 32), SSE2_LD(p + 48),	\
+				 &e1, &o1);				\
+		sse2_deint##bits(e0, e1, &a, &c);			\
+		sse2_deint##bits(o0, o1, &b, &d);			\
+									\
+		SSE2_ST(&d0[i * (es)], a);				\
+		SSE2_ST(&d1[i * (es)], b);				\
+		SSE2_ST(&d2[i * (es)], c);				\
+		SSE2_ST(&d3[i * (es)], d);				\
+	}								\
+									\
+	return i;							\
+}
+
+SSE2_KERNELS(8, 1)
+SSE2_KERNELS(16, 2)
+SSE2_KERNELS(32, 4)
+SSE2_KERNELS(64, 8)
+
+static const kernels_t sse2_kernels = {
+	{ NULL, NULL, sse2_x2_8, NULL, sse2_x4_8 },
+	{ NULL, NULL, sse2_x2_16, NULL, sse2_x4_16 },
+	{ NULL, NULL, sse2_x2_32, NULL, sse2_x4_32 },
+	{ NULL, NULL, sse2_x2_64, NULL, sse2_x4_64 },
+};
+#endif
+
+#ifdef HAS_AVX2
+/*
+ * AVX2 kernels.
+ *
+ * Same scheme as SSE2 on 256-bit vectors: the in-lane de-interleave leaves
+ * 64-bit chunks in (0, 2, 1, 3) order, which a cross-lane permute fixes.
+ */
+
+#ifdef __GNUC__
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+#define AVX2_LD(p) _mm256_loadu_si256((const __m256i *)(p))
+#define AVX2_ST(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define AVX2_FIX(v) _mm256_permute4x64_epi64((v), _MM_SHUFFLE(3, 1, 2, 0))
+
+AVX2_TARGET
+static void avx2_deint8(__m256i x, __m256i y, __m256i *e, __m256i *o)
+{
+	const __m256i m = _mm256_set1_epi16(0x00ff);
+
+	*e = AVX2_FIX(_mm256_packus_epi16(_mm256_and_si256(x, m),
+					  _mm256_and_si256(y, m)));
+	*o = AVX2_FIX(_mm256_packus_epi16(_mm256_srli_epi16(x, 8),
+					  _mm256_srli_epi16(y, 8)));
+}
+
+AVX2_TARGET
+static void avx2_deint16(__m256i x, __m256i y, __m256i *e, __m256i *o)
+{
+	x = _mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+	x = _mm256_shufflehi_epi16(x, _MM_SHUFFLE(3, 1, 2, 0));
+	x = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 1, 2, 0));
+
+	y = _mm256_shufflelo_epi16(y, _MM_SHUFFLE(3, 1, 2, 0));
+	y = _mm256_shufflehi_epi16(y, _MM_SHUFFLE(3, 1, 2, 0));
+	y = _mm256_shuffle_epi32(y, _MM_SHUFFLE(3, 1, 2, 0));
+
+	*e = AVX2_FIX(_mm256_unpacklo_epi64(x, y));
+	*o = AVX2_FIX(_mm256_unpackhi_epi64(x, y));
+}
+
+AVX2_TARGET
+static void avx2_deint32(__m256i x, __m256i y, __m256i *e, __m256i *o)
+{
+	__m256 xf = _mm256_castsi256_ps(x);
+	__m256 yf = _mm256_castsi256_ps(y);
+
+	*e = AVX2_FIX(_mm256_castps_si256(
+		_mm256_shuffle_ps(xf, yf, _MM_SHUFFLE(2, 0, 2, 0))));
+	*o = AVX2_FIX(_mm256_castps_si256(
+		_mm256_shuffle_ps(xf, yf, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+AVX2_TARGET
+static void avx2_deint64(__m256i x, __m256i y, __m256i *e, __m256i *o)
+{
+	*e = AVX2_FIX(_mm256_unpacklo_epi64(x, y));
+	*o = AVX2_FIX(_mm256_unpackhi_epi64(x, y));
+}
+
+#define AVX2_KERNELS(bits, es)						\
+AVX2_TARGET								\
+static size_t avx2_x2_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	uint8_t *d0 = dst[0], *d1 = dst[1];				\
+	size_t i;							\
+									\
+	for (i = 0; i + 32 / (es) <= n; i += 32 / (es)) {		\
+		const uint8_t *p = &src[i * 2 * (es)];			\
+		__m256i e, o;						\
+									\
+		avx2_deint##bits(AVX2_LD(p), AVX2_LD(p + 32), &e, &o);	\
+		AVX2_ST(&d0[i * (es)], e);				\
+		AVX2_ST(&d1[i * (es)], o);				\
+	}								\
+									\
+	return i;							\
+}									\
+									\
+AVX2_TARGET								\
+static size_t avx2_x4_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	uint8_t *d0 = dst[0], *d1 = dst[1], *d2 = dst[2], *d3 = dst[3];	\
+	size_t i;							\
+									\
+	for (i = 0; i + 32 / (es) <= n; i += 32 / (es)) {		\
+		const uint8_t *p = &src[i * 4 * (es)];			\
+		__m256i e0, o0, e1, o1, a, b, c, d;			\
+									\
+		avx2_deint##bits(AVX2_LD(p), AVX2_LD(p + 32), &e0, &o0);	\
+		avx2_deint##bits(AVX2_LD(p + 64), AVX2_LD(p + 96),	\
+				 &e1, &o1);				\
+		avx2_deint##bits(e0, e1, &a, &c);			\
+		avx2_deint##bits(o0, o1, &b, &d);			\
+									\
+		AVX2_ST(&d0[i * (es)], a);				\
+		AVX2_ST(&d1[i * (es)], b);				\
+		AVX2_ST(&d2[i * (es)], c);				\
+		AVX2_ST(&d3[i * (es)], d);				\
+	}								\
+									\
+	return i;							\
+}
+
+AVX2_KERNELS(8, 1)
+AVX2_KERNELS(16, 2)
+AVX2_KERNELS(32, 4)
+AVX2_KERNELS(64, 8)
+
+static const kernels_t avx2_kernels = {
+	{ NULL, NULL, avx2_x2_8, NULL, avx2_x4_8 },
+	{ NULL, NULL, avx2_x2_16, NULL, avx2_x4_16 },
+	{ NULL, NULL, avx2_x2_32, NULL, avx2_x4_32 },
+	{ NULL, NULL, avx2_x2_64, NULL, avx2_x4_64 },
+};
+
+/**
+ * Check if the running CPU (and OS) support AVX2.
+ *
+ * @return
+ *	Non-zero if supported.
+ */
+static int avx2_supported(void)
+{
+#ifdef _MSC_VER
+	int regs[4];
+
+	__cpuid(regs, 1);
+	/* OSXSAVE and AVX */
+	if ((regs[2] & (3 << 27)) != (3 << 27))
+		return 0;
+
+	/* XMM and YMM state enabled by the OS */
+	if ((_xgetbv(0) & 6) != 6)
+		return 0;
+
+	__cpuidex(regs, 7, 0);
+
+	return (regs[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#ifdef HAS_NEON
+/*
+ * NEON kernels.
+ *
+ * Structured loads de-interleave 2, 3 or 4 channels natively.
+ */
+
+#define NEON_KERNELS(bits, lanes)					\
+static size_t neon_x2_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	const uint##bits##_t *s = (const uint##bits##_t *)src;		\
+	uint##bits##_t *d0 = dst[0], *d1 = dst[1];			\
+	size_t i;							\
+									\
+	for (i = 0; i + (lanes) <= n; i += (lanes)) {			\
+		uint##bits##x##lanes##x2_t v = vld2q_u##bits(&s[i * 2]);	\
+									\
+		vst1q_u##bits(&d0[i], v.val[0]);			\
+		vst1q_u##bits(&d1[i], v.val[1]);			\
+	}								\
+									\
+	return i;							\
+}									\
+									\
+static size_t neon_x3_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	const uint##bits##_t *s = (const uint##bits##_t *)src;		\
+	uint##bits##_t *d0 = dst[0], *d1 = dst[1], *d2 = dst[2];	\
+	size_t i;							\
+									\
+	for (i = 0; i + (lanes) <= n; i += (lanes)) {			\
+		uint##bits##x##lanes##x3_t v = vld3q_u##bits(&s[i * 3]);	\
+									\
+		vst1q_u##bits(&d0[i], v.val[0]);			\
+		vst1q_u##bits(&d1[i], v.val[1]);			\
+		vst1q_u##bits(&d2[i], v.val[2]);			\
+	}								\
+									\
+	return i;							\
+}									\
+									\
+static size_t neon_x4_##bits(const uint8_t *src, size_t n,		\
+			     void *const *dst)				\
+{									\
+	const uint##bits##_t *s = (const uint##bits##_t *)src;		\
+	uint##bits##_t *d0 = dst[0], *d1 = dst[1];			\
+	uint##bits##_t *d2 = dst[2], *d3 = dst[3];			\
+	size_t i;							\
+									\
+	for (i = 0; i + (lanes) <= n; i += (lanes)) {			\
+		uint##bits##x##lanes##x4_t v = vld4q_u##bits(&s[i * 4]);	\
+									\
+		vst1q_u##bits(&d0[i], v.val[0]);			\
+		vst1q_u##bits(&d1[i], v.val[1]);			\
+		vst1q_u##bits(&d2[i], v.val[2]);			\
+		vst1q_u##bits(&d3[i], v.val[3]);			\
+	}								\
+									\
+	return i;							\
+}
+
+NEON_KERNELS(8, 16)
+NEON_KERNELS(16, 8)
+NEON_KERNELS(32, 4)
+#ifdef HAS_NEON_64
+NEON_KERNELS(64, 2)
+#endif
+
+static const kernels_t neon_kernels = {
+	{ NULL, NULL, neon_x2_8, neon_x3_8, neon_x4_8 },
+	{ NULL, NULL, neon_x2_16, neon_x3_16, neon_x4_16 },
+	{ NULL, NULL, neon_x2_32, neon_x3_32, neon_x4_32 },
+#ifdef HAS_NEON_64
+	{ NULL, NULL, neon_x2_64, neon_x3_64, neon_x4_64 },
+#else
+	{ NULL, NULL, NULL, NULL, NULL },
+#endif
+};
+#endif
+
+/**
+ * Obtain the best instruction set supported by the running CPU.
+ *
+ * @return
+ *	Instruction set.
+ */
+static il_mon_decode_isa_t isa_best(void)
+{
+	static int detected;
+	static il_mon_decode_isa_t best = IL_MON_DECODE_ISA_SCALAR;
+
+	if (detected)
+		return best;
+
+#if defined(HAS_AVX2)
+	best = avx2_supported() ? IL_MON_DECODE_ISA_AVX2 :
+				  IL_MON_DECODE_ISA_SSE2;
+#elif defined(HAS_SSE2)
+	best = IL_MON_DECODE_ISA_SSE2;
+#elif defined(HAS_NEON)
+	best = IL_MON_DECODE_ISA_NEON;
+#endif
+	detected = 1;
+
+	return best;
+}
+
+/**
+ * Obtain the kernels of an instruction set.
+ *
+ * @param [in] isa
+ *	Instruction set.
+ *
+ * @return
+ *	Kernels (NULL if not available in this build).
+ */
+static const kernels_t *isa_kernels(il_mon_decode_isa_t isa)
+{
+	switch (isa) {
+#ifdef HAS_SSE2
+	case IL_MON_DECODE_ISA_SSE2:
+		return &sse2_kernels;
+#endif
+#ifdef HAS_AVX2
+	case IL_MON_DECODE_ISA_AVX2:
+		return &avx2_kernels;
+#endif
+#ifdef HAS_NEON
+	case IL_MON_DECODE_ISA_NEON:
+		return &neon_kernels;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * Decode blocks with per-channel strided copies.
+ *
+ * @param [in] layout
+ *	Layout.
+ * @param [in] src
+ *	Interleaved blocks.
+ * @param [in] first
+ *	First block to be decoded.
+ * @param [in] n
+ *	Number of blocks.
+ * @param [in] dst
+ *	Channel destination arrays.
+ */
+static void scalar_run(const il_mon_layout_t *layout, const uint8_t *src,
+		       size_t first, size_t n, void *const *dst)
+{
+	size_t stride = layout->block_sz;
+	size_t ch, i;
+
+	for (ch = 0; ch < layout->n_ch; ch++) {
+		const uint8_t *s = &src[first * stride + layout->ch[ch].off];
+		uint8_t *d = (uint8_t *)dst[ch] + first * layout->ch[ch].sz;
+		size_t cnt = n - first;
+
+		switch (layout->ch[ch].sz) {
+		case 1:
+			for (i = 0; i < cnt; i++)
+				d[i] = s[i * stride];
+			break;
+		case 2:
+			for (i = 0; i < cnt; i++)
+				memcpy(&d[i * 2], &s[i * stride], 2);
+			break;
+		case 4:
+			for (i = 0; i < cnt; i++)
+				memcpy(&d[i * 4], &s[i * stride], 4);
+			break;
+		case 8:
+			for (i = 0; i < cnt; i++)
+				memcpy(&d[i * 8], &s[i * stride], 8);
+			break;
+		}
+	}
+}
+
+/*******************************************************************************
+ * Internal
+ ******************************************************************************/
+
+size_t il_mon_decode__dtype_sz(il_reg_dtype_t type)
+{
+	/* strings are not sampled */
+	if (type == IL_REG_DTYPE_STR)
+		return 0;
+
+	return il_reg__dtype_sz(type);
+}
+
+int il_mon_decode__compile(il_mon_layout_t *layout,
+			   const il_reg_dtype_t *types, size_t n_ch,
+			   size_t block_sz, il_mon_decode_isa_t isa)
+{
+	const kernels_t *kernels;
+	size_t ch, off = 0;
+	int uniform = 1;
+
+	memset(layout, 0, sizeof(*layout));
+	layout->isa = IL_MON_DECODE_ISA_SCALAR;
+
+	if (n_ch == 0)
+		return 0;
+
+	layout->ch = malloc(n_ch * sizeof(*layout->ch));
+	if (!layout->ch) {
+		ilerr__set("Monitoring layout allocation failed");
+		return IL_ENOMEM;
+	}
+
+	for (ch = 0; ch < n_ch; ch++) {
+		size_t sz = il_mon_decode__dtype_sz(types[ch]);
+
+		if (sz == 0) {
+			ilerr__set("Unsupported monitoring channel type");
+			goto cleanup_ch;
+		}
+
+		layout->ch[ch].off = (uint32_t)off;
+		layout->ch[ch].sz = (uint8_t)sz;
+
+		if (sz != layout->ch[0].sz)
+			uniform = 0;
+
+		off += sz;
+	}
+
+	if (block_sz == 0)
+		block_sz = off;
+
+	if (block_sz < off) {
+		ilerr__set("Monitoring block size smaller than mapping");
+		goto cleanup_ch;
+	}
+
+	layout->n_ch = n_ch;
+	layout->block_sz = block_sz;
+
+	/* vector kernels only apply to tightly packed uniform blocks */
+	if (n_ch < 2 || n_ch > 4 || !uniform || block_sz != off)
+		return 0;
+
+	if (isa == IL_MON_DECODE_ISA_AUTO ||
+	    (isa == IL_MON_DECODE_ISA_AVX2 &&
+	     isa_best() != IL_MON_DECODE_ISA_AVX2))
+		isa = isa_best();
+
+	kernels = isa_kernels(isa);
+	if (!kernels)
+		return 0;
+
+	layout->kernel = (*kernels)[sz_idx(layout->ch[0].sz)][n_ch];
+	if (layout->kernel)
+		layout->isa = isa;
+
+	return 0;
+
+cleanup_ch:
+	free(layout->ch);
+	layout->ch = NULL;
+
+	return IL_EINVAL;
+}
+
+void il_mon_decode__release(il_mon_layout_t *layout)
+{
+	free(layout->ch);
+	memset(layout, 0, sizeof(*layout));
+}
+
+void il_mon_decode__run(const il_mon_layout_t *layout, const uint8_t *src,
+			size_t n, void *const *dst)
+{
+	size_t done = 0;
+
+	if (layout->n_ch == 0 || n == 0)
+		return;
+
+	if (layout->n_ch == 1 && layout->block_sz == layout->ch[0].sz) {
+		memcpy(dst[0], src, n * layout->ch[0].sz);
+		return;
+	}
+
+	if (layout->kernel)
+		done = layout->kernel(src, n, dst);
+
+	if (done < n)
+		scalar_run(layout, src, done, n, dst);
+}
+
+const char *il_mon_decode__isa_name(il_mon_decode_isa_t isa)
+{
+	switch (isa) {
+	case IL_MON_DECODE_ISA_AUTO:
+		return "auto";
+	case IL_MON_DECODE_ISA_SSE2:
+		return "sse2";
+	case IL_MON_DECODE_ISA_AVX2:
+		return "avx2";
+	case IL_MON_DECODE_ISA_NEON:
+		return "neon";
+	default:
+		return "scalar";
+	}
+}
@@ -0,0 +1,490 @@
+#include "mon_stream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ingenialink/err.h"
+#include "ingenialink/mon_decode.h"
+#include "ingenialink/net.h"
+#include "net.h"
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/** Widen a decoded channel array of type T into interleaved samples. */
+#define CHANNEL_WIDEN(T, src, n, dst, stride) \
+	do { \
+		const T *src_ = (const T *)(src); \
+		size_t i_; \
+		for (i_ = 0; i_ < (n); i_++) \
+			(dst)[i_ * (stride)] = (double)src_[i_]; \
+	} while (0)
+
+/**
+ * Widen a decoded monitoring channel into interleaved samples.
+ *
+ * @param [in] type
+ *	Channel type.
+ * @param [in] src
+ *	Decoded channel values (native channel type).
+ * @param [in] n
+ *	Number of values.
+ * @param [out] dst
+ *	First destination sample.
+ * @param [in] stride
+ *	Distance between destination samples (values).
+ */
+static void channel_widen(il_reg_dtype_t type, const void *src, size_t n,
+			  double *dst, size_t stride)
+{
+	switch (type) {
+	case IL_REG_DTYPE_U8:
+		CHANNEL_WIDEN(uint8_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_S8:
+		CHANNEL_WIDEN(int8_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_U16:
+		CHANNEL_WIDEN(uint16_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_S16:
+		CHANNEL_WIDEN(int16_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_U32:
+		CHANNEL_WIDEN(uint32_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_S32:
+		CHANNEL_WIDEN(int32_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_U64:
+		CHANNEL_WIDEN(uint64_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_S64:
+		CHANNEL_WIDEN(int64_t, src, n, dst, stride);
+		break;
+	case IL_REG_DTYPE_FLOAT:
+		CHANNEL_WIDEN(float, src, n, dst, stride);
+		break;
+	default:
+		CHANNEL_WIDEN(double, src, n, dst, stride);
+		break;
+	}
+}
+
+/**
+ * Collect the monitoring data last read from the drive.
+ *
+ * @note
+ *	Raw blocks have already been split into per-channel arrays by the
+ *	compiled decoding layout of the network, so only the conversion to
+ *	interleaved doubles is left, one channel at a time.
+ *
+ * @param [in] stream
+ *	Monitoring stream.
+ *
+ * @return
+ *	Number of samples decoded into the scratch buffer, error code otherwise.
+ */
+static int samples_decode(il_mon_stream_t *stream)
+{
+	il_net_t *net = stream->net;
+	const il_mon_layout_t *layout = &net->monitoring_layout;
+	size_t n, ch;
+
+	if (layout->block_sz == 0)
+		return 0;
+
+	n = net->monitoring_data_size / layout->block_sz;
+	if (n == 0)
+		return 0;
+
+	if (layout->n_ch < stream->n_ch) {
+		ilerr__set("Monitoring mapping changed");
+		return IL_ESTATE;
+	}
+
+	for (ch = 0; ch < stream->n_ch; ch++) {
+		if (net->monitoring_data_channels[ch].type != stream->types[ch]) {
+			ilerr__set("Monitoring mapping changed");
+			return IL_ESTATE;
+		}
+	}
+
+	if (n > stream->scratch_sz) {
+		double *scratch;
+
+		scratch = realloc(stream->scratch,
+				  n * stream->n_ch * sizeof(*scratch));
+		if (!scratch) {
+			ilerr__set("Samples buffer allocation failed");
+			return IL_ENOMEM;
+		}
+
+		stream->scratch = scratch;
+		stream->scratch_sz = n;
+	}
+
+	for (ch = 0; ch < stream->n_ch; ch++)
+		channel_widen(stream->types[ch],
+			      net->monitoring_data_channels[ch].value.monitoring_data_u8,
+			      n, &stream->scratch[ch], stream->n_ch);
+
+	return (int)n;
+}
+
+/**
+ * Capture the current monitoring mapping.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [out] types
+ *	Channel types (to be freed by the caller).
+ * @param [out] n_ch
+ *	Number of channels.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int mapping_capture(il_net_t *net, il_reg_dtype_t **types,
+			   size_t *n_ch)
+{
+	size_t ch, bytes = 0;
+	int r;
+
+	*n_ch = MIN(net->monitoring_number_mapped_registers,
+		    net->monitoring_channels_cnt);
+	if (*n_ch == 0) {
+		ilerr__set("No monitoring channels mapped");
+		return IL_ESTATE;
+	}
+
+	*types = malloc(*n_ch * sizeof(**types));
+	if (!*types) {
+		ilerr__set("Channel types allocation failed");
+		return IL_ENOMEM;
+	}
+
+	for (ch = 0; ch < *n_ch; ch++) {
+		(*types)[ch] = net->monitoring_data_channels[ch].type;
+		if (il_mon_decode__dtype_sz((*types)[ch]) == 0) {
+			ilerr__set("Unsupported monitoring channel type");
+			r = IL_EINVAL;
+			goto cleanup_types;
+		}
+
+		bytes += il_mon_decode__dtype_sz((*types)[ch]);
+	}
+
+	if (bytes > net->monitoring_bytes_per_block) {
+		ilerr__set("Monitoring mapping does not match block size");
+		r = IL_ESTATE;
+		goto cleanup_types;
+	}
+
+	return 0;
+
+cleanup_types:
+	free(*types);
+
+	return r;
+}
+
+/**
+ * Monitoring stream thread.
+ *
+ * @note
+ *	Drive buffer contents are drained as soon as they are available. Once a
+ *	capture has been fully drained (data followed by an empty read) the
+ *	drive is re-armed, so that captures follow each other back-to-back.
+ *
+ * @param [in] args
+ *	Monitoring stream.
+ */
+static int stream_td(void *args)
+{
+	il_mon_stream_t *stream = args;
+	int drained = 0;
+
+	osal_mutex_lock(stream->lock);
+
+	while (!stream->stop) {
+		int r, n = 0;
+
+		osal_mutex_unlock(stream->lock);
+
+		r = il_net_read_monitoring_data(stream->net);
+		if (r >= 0)
+			n = samples_decode(stream);
+
+		if (n > 0) {
+			if (stream->cb)
+				stream->cb(stream->ctx, stream->scratch,
+					   (size_t)n, stream->n_ch);
+			else
+				(void)il_utils__ring_push(stream->ring,
+							  stream->scratch,
+							  (size_t)n);
+		} else if (r >= 0 && n == 0 && drained) {
+			r = il_net_disable_monitoring(stream->net);
+			if (r >= 0)
+				r = il_net_enable_monitoring(stream->net);
+		}
+
+		osal_mutex_lock(stream->lock);
+
+		if (r < 0 || n < 0) {
+			stream->stats.errors++;
+		} else if (n > 0) {
+			stream->stats.samples += (uint64_t)n;
+			stream->stats.bursts++;
+			drained = 1;
+		} else if (drained) {
+			stream->stats.rearms++;
+			drained = 0;
+		}
+
+		if (n <= 0 && !stream->stop)
+			(void)osal_cond_wait(stream->cond, stream->lock,
+					     stream->period);
+	}
+
+	osal_mutex_unlock(stream->lock);
+
+	(void)il_net_disable_monitoring(stream->net);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Public
+ ******************************************************************************/
+
+il_mon_stream_t *il_mon_stream_create(il_net_t *net, size_t cap)
+{
+	il_mon_stream_t *stream;
+
+	if (cap == 0) {
+		ilerr__set("Invalid ring capacity");
+		return NULL;
+	}
+
+	stream = calloc(1, sizeof(*stream));
+	if (!stream) {
+		ilerr__set("Monitoring stream allocation failed");
+		return NULL;
+	}
+
+	stream->net = net;
+	il_net__retain(stream->net);
+
+	stream->cap = cap;
+
+	stream->lock = osal_mutex_create();
+	if (!stream->lock) {
+		ilerr__set("Monitoring stream lock allocation failed");
+		goto cleanup_stream;
+	}
+
+	stream->cond = osal_cond_create();
+	if (!stream->cond) {
+		ilerr__set("Monitoring stream condition allocation failed");
+		goto cleanup_lock;
+	}
+
+	return stream;
+
+cleanup_lock:
+	osal_mutex_destroy(stream->lock);
+
+cleanup_stream:
+	il_net__release(stream->net);
+	free(stream);
+
+	return NULL;
+}
+
+void il_mon_stream_destroy(il_mon_stream_t *stream)
+{
+	il_mon_stream_stop(stream);
+
+	if (stream->ring)
+		il_utils__ring_destroy(stream->ring);
+
+	free(stream->scratch);
+	free(stream->types);
+
+	osal_cond_destroy(stream->cond);
+	osal_mutex_destroy(stream->lock);
+
+	il_net__release(stream->net);
+
+	free(stream);
+}
+
+int il_mon_stream_cb_set(il_mon_stream_t *stream, il_mon_stream_cb_t cb,
+			 void *ctx)
+{
+	if (stream->running) {
+		ilerr__set("Monitoring stream is running");
+		return IL_ESTATE;
+	}
+
+	stream->cb = cb;
+	stream->ctx = ctx;
+
+	return 0;
+}
+
+int il_mon_stream_configure(il_mon_stream_t *stream)
+{
+	il_utils_ring_t *ring;
+	il_reg_dtype_t *types;
+	size_t n_ch;
+	int r;
+
+	if (stream->running) {
+		ilerr__set("Monitoring stream is running");
+		return IL_ESTATE;
+	}
+
+	r = mapping_capture(stream->net, &types, &n_ch);
+	if (r < 0)
+		return r;
+
+	ring = il_utils__ring_create(n_ch * sizeof(double), stream->cap);
+	if (!ring) {
+		free(types);
+		return IL_ENOMEM;
+	}
+
+	osal_mutex_lock(stream->lock);
+
+	if (stream->ring)
+		il_utils__ring_destroy(stream->ring);
+	stream->ring = ring;
+	stream->dropped_base = 0;
+
+	free(stream->types);
+	stream->types = types;
+	stream->n_ch = n_ch;
+
+	free(stream->scratch);
+	stream->scratch = NULL;
+	stream->scratch_sz = 0;
+
+	osal_mutex_unlock(stream->lock);
+
+	return 0;
+}
+
+int il_mon_stream_start(il_mon_stream_t *stream, int period)
+{
+	il_net_t *net = stream->net;
+	il_reg_dtype_t *types;
+	size_t n_ch;
+	int r;
+
+	if (stream->running) {
+		ilerr__set("Monitoring stream already running");
+		return IL_EALREADY;
+	}
+
+	if (period <= 0) {
+		ilerr__set("Invalid polling period");
+		return IL_EINVAL;
+	}
+
+	/* the ring is kept across starts, so that readers never see it
+	 * replaced: it is only created on the first start */
+	if (!stream->ring) {
+		r = il_mon_stream_configure(stream);
+		if (r < 0)
+			return r;
+	} else {
+		r = mapping_capture(net, &types, &n_ch);
+		if (r < 0)
+			return r;
+
+		if (n_ch != stream->n_ch ||
+		    memcmp(types, stream->types, n_ch * sizeof(*types)) != 0)
+			r = IL_ESTATE;
+
+		free(types);
+
+		if (r < 0) {
+			ilerr__set("Monitoring mapping changed, reconfigure "
+				   "the stream");
+			return r;
+		}
+	}
+
+	/* arm monitoring */
+	r = il_net_enable_monitoring(net);
+	if (r < 0)
+		return r;
+
+	/* statistics start from zero */
+	stream->dropped_base = il_utils__ring_dropped(stream->ring);
+	memset(&stream->stats, 0, sizeof(stream->stats));
+	stream->period = period;
+	stream->stop = 0;
+
+	stream->td = osal_thread_create_(stream_td, stream);
+	if (!stream->td) {
+		ilerr__set("Monitoring stream thread creation failed");
+		(void)il_net_disable_monitoring(net);
+		return IL_EFAIL;
+	}
+
+	stream->running = 1;
+
+	return 0;
+}
+
+void il_mon_stream_stop(il_mon_stream_t *stream)
+{
+	if (!stream->running)
+		return;
+
+	osal_mutex_lock(stream->lock);
+	stream->stop = 1;
+	osal_cond_signal(stream->cond);
+	osal_mutex_unlock(stream->lock);
+
+	osal_thread_join(stream->td, NULL);
+
+	stream->running = 0;
+}
+
+size_t il_mon_stream_channels_get(il_mon_stream_t *stream)
+{
+	return stream->n_ch;
+}
+
+size_t il_mon_stream_read(il_mon_stream_t *stream, double *samples, size_t n)
+{
+	if (!stream->ring)
+		return 0;
+
+	return il_utils__ring_pop(stream->ring, samples, n);
+}
+
+size_t il_mon_stream_available(il_mon_stream_t *stream)
+{
+	if (!stream->ring)
+		return 0;
+
+	return il_utils__ring_cnt(stream->ring);
+}
+
+void il_mon_stream_stats_get(il_mon_stream_t *stream,
+			     il_mon_stream_stats_t *stats)
+{
+	osal_mutex_lock(stream->lock);
+	*stats = stream->stats;
+	osal_mutex_unlock(stream->lock);
+
+	stats->dropped = stream->ring ? il_utils__ring_dropped(stream->ring) -
+					stream->dropped_base : 0;
+}
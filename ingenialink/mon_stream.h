@@ -0,0 +1,48 @@
+#ifndef MON_STREAM_H_
+#define MON_STREAM_H_
+
+#include "public/ingenialink/mon_stream.h"
+
+#include "ingenialink/utils.h"
+
+#include "osal/osal.h"
+
+/** IngeniaLink monitoring stream. */
+struct il_mon_stream {
+	/** Associated network. */
+	il_net_t *net;
+	/** Ring capacity (samples). */
+	size_t cap;
+	/** Ring (samples of n_ch doubles, kept across starts). */
+	il_utils_ring_t *ring;
+	/** Ring drops before the last start. */
+	uint64_t dropped_base;
+	/** Number of channels. */
+	size_t n_ch;
+	/** Channel types. */
+	il_reg_dtype_t *types;
+	/** Decoded samples scratch buffer. */
+	double *scratch;
+	/** Scratch buffer size (samples). */
+	size_t scratch_sz;
+	/** Samples callback. */
+	il_mon_stream_cb_t cb;
+	/** Callback context. */
+	void *ctx;
+	/** Idle polling period (ms). */
+	int period;
+	/** Statistics (except dropped, kept by the ring). */
+	il_mon_stream_stats_t stats;
+	/** Lock (statistics, stop flag and configuration). */
+	osal_mutex_t *lock;
+	/** Stop condition. */
+	osal_cond_t *cond;
+	/** Thread. */
+	osal_thread_t *td;
+	/** Running flag. */
+	int running;
+	/** Stop flag. */
+	int stop;
+};
+
+#endif
@@ -1,13 +1,412 @@
 #include "net.h"
 
-
+#include <stdlib.h>
 #include <string.h>
 
 #include "ingenialink/err.h"
+#include "ingenialink/registers.h"
+
+int il_net_monitoring_mapping_register[16];
+int il_net_disturbance_mapping_register[16];
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/**
+ * Grow a channel table.
+ *
+ * @param [in, out] channels
+ *	Channel table.
+ * @param [in, out] cnt
+ *	Number of channels in the table.
+ * @param [in] elem_sz
+ *	Channel entry size.
+ * @param [in] channel
+ *	Channel that must fit in the table.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int channels_grow(void **channels, size_t *cnt, size_t elem_sz,
+			 int channel)
+{
+	uint8_t *table;
+	size_t n;
+
+	if (channel < 0) {
+		ilerr__set("Invalid channel (%d)", channel);
+		return IL_EINVAL;
+	}
+
+	n = (size_t)channel + 1;
+	if (n <= *cnt)
+		return 0;
+
+	table = realloc(*channels, n * elem_sz);
+	if (!table) {
+		ilerr__set("Channel table allocation failed");
+		return IL_ENOMEM;
+	}
+
+	memset(&table[*cnt * elem_sz], 0, (n - *cnt) * elem_sz);
+
+	*channels = table;
+	*cnt = n;
+
+	return 0;
+}
+
+/**
+ * Make room for a number of bytes in a channel buffer.
+ *
+ * @param [in, out] buf
+ *	Channel buffer.
+ * @param [in, out] buf_sz
+ *	Channel buffer size (bytes).
+ * @param [in] sz
+ *	Required size (bytes).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int buf_reserve(void **buf, size_t *buf_sz, size_t sz)
+{
+	void *buf_;
+
+	if (sz <= *buf_sz)
+		return 0;
+
+	buf_ = realloc(*buf, sz);
+	if (!buf_) {
+		ilerr__set("Channel data allocation failed");
+		return IL_ENOMEM;
+	}
+
+	*buf = buf_;
+	*buf_sz = sz;
+
+	return 0;
+}
+
+/**
+ * Obtain the size of a disturbance channel type.
+ *
+ * @param [in] type
+ *	Channel type.
+ *
+ * @return
+ *	Size (bytes), 0 if the type can not be used for disturbance.
+ */
+static size_t disturbance_dtype_sz(il_reg_dtype_t type)
+{
+	size_t sz = il_reg__dtype_sz(type);
+
+	/* only 16 and 32-bit numeric channels can be injected */
+	if (type == IL_REG_DTYPE_STR || (sz != 2 && sz != 4))
+		return 0;
+
+	return sz;
+}
+
+/**
+ * Pack (interleave) the disturbance channels into the upload payload.
+ *
+ * @note
+ *	Channels with fewer samples are padded with zeros.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int disturbance_pack(il_net_t *net)
+{
+	size_t ch, i, n = 0, sample_sz = 0, off = 0;
+	int r;
+
+	for (ch = 0; ch < net->disturbance_channels_cnt; ch++) {
+		struct disturbance_data_t *data = &net->disturbance_data_channels[ch];
+		size_t sz = disturbance_dtype_sz(data->type);
+
+		if (sz == 0)
+			continue;
+
+		sample_sz += sz;
+		n = MAX(n, data->len / sz);
+	}
+
+	r = buf_reserve((void **)&net->disturbance_packed,
+			&net->disturbance_packed_cap, n * sample_sz);
+	if (r < 0)
+		return r;
+
+	for (ch = 0; ch < net->disturbance_channels_cnt; ch++) {
+		struct disturbance_data_t *data = &net->disturbance_data_channels[ch];
+		size_t sz = disturbance_dtype_sz(data->type);
+		size_t cnt;
+		uint8_t *dst;
+
+		if (sz == 0)
+			continue;
+
+		cnt = data->len / sz;
+		dst = &net->disturbance_packed[off];
+		for (i = 0; i < n; i++) {
+			if (i < cnt)
+				memcpy(dst, &data->value.disturbance_data_u8[i * sz],
+				       sz);
+			else
+				memset(dst, 0, sz);
+
+			dst += sample_sz;
+		}
+
+		off += sz;
+	}
+
+	net->disturbance_packed_sz = n * sample_sz;
+	net->disturbance_sample_sz = sample_sz;
+
+	return 0;
+}
+
+/**
+ * Store disturbance channel data and update the upload payload.
+ *
+ * @note
+ *	Data can be staged before the channel is mapped (as with the former
+ *	fixed channel table): it is kept, and packed once the channel type is
+ *	known.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] channel
+ *	Channel.
+ * @param [in] data
+ *	Data.
+ * @param [in] sz
+ *	Data size (bytes).
+ *
+ * @return
+ *	0 on success, error code otherwise.
+ */
+static int disturbance_channel_store(il_net_t *net, int channel,
+				     const void *data, size_t sz)
+{
+	struct disturbance_data_t *ch;
+	int r;
+
+	if (channel < 0 || channel >= IL_NET_MAPPING_MAX) {
+		ilerr__set("Invalid disturbance channel (%d)", channel);
+		return IL_EINVAL;
+	}
+
+	/* unmapped channels are zeroed (type not disturbable) until mapped */
+	r = channels_grow((void **)&net->disturbance_data_channels,
+			  &net->disturbance_channels_cnt,
+			  sizeof(*net->disturbance_data_channels), channel);
+	if (r < 0)
+		return r;
+
+	ch = &net->disturbance_data_channels[channel];
+	r = buf_reserve((void **)&ch->value.disturbance_data_u8, &ch->sz, sz);
+	if (r < 0)
+		return r;
+
+	memcpy(ch->value.disturbance_data_u8, data, sz);
+	ch->len = sz;
+
+	return disturbance_pack(net);
+}
+
+/**
+ * Write the mapping entries that differ from the ones applied.
+ *
+ * @note
+ *	Entries, number of mapped registers and (optionally) the resulting
+ *	block size are transferred at once, so that the requests are pipelined
+ *	on networks supporting it.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] channels
+ *	Channels.
+ * @param [in] n
+ *	Number of channels.
+ * @param [in] applied
+ *	Channels currently applied.
+ * @param [in] applied_cnt
+ *	Number of channels currently applied.
+ * @param [in] mapped_cnt
+ *	Number of mapped registers reported to the drive.
+ * @param [in] mapping_addr
+ *	First mapping register address.
+ * @param [in] cnt_addr
+ *	Number of mapped registers address.
+ * @param [out] block_sz
+ *	Block size (NULL if not to be read).
+ *
+ * @return
+ *	1 if the mapping has been written, 0 if it was already applied, error
+ *	code otherwise.
+ */
+static int mapping_apply(il_net_t *net, const il_net_mon_channel_t *channels,
+			 size_t n, const il_net_mon_channel_t *applied,
+			 size_t applied_cnt, uint16_t mapped_cnt,
+			 uint16_t mapping_addr, uint16_t cnt_addr,
+			 uint16_t *block_sz)
+{
+	/* network registers, addressed on node 1 as everywhere else */
+	il_net_req_t reqs[IL_NET_MAPPING_MAX + 2];
+	uint16_t entries[IL_NET_MAPPING_MAX][2];
+	uint16_t cnt = (uint16_t)n;
+	size_t ch, n_reqs = 0;
+	int r;
+
+	for (ch = 0; ch < n; ch++) {
+		const il_net_mon_channel_t *c = &channels[ch];
+
+		if (ch < applied_cnt && applied[ch].address == c->address &&
+		    applied[ch].subnode == c->subnode &&
+		    applied[ch].dtype == c->dtype &&
+		    applied[ch].size == c->size)
+			continue;
+
+		/* type | size, subnode | address */
+		entries[ch][0] = (uint16_t)(((uint32_t)c->dtype << 8) | c->size);
+		entries[ch][1] = (uint16_t)(((uint32_t)c->subnode << 12) |
+					    c->address);
+
+		reqs[n_reqs++] = (il_net_req_t){ .id = 1,
+						 .address = mapping_addr + ch,
+						 .buf = entries[ch],
+						 .sz = sizeof(entries[ch]),
+						 .write = 1 };
+	}
+
+	if (n_reqs == 0 && n == mapped_cnt)
+		return 0;
+
+	reqs[n_reqs++] = (il_net_req_t){ .id = 1, .address = cnt_addr,
+					 .buf = &cnt, .sz = sizeof(cnt),
+					 .write = 1 };
+
+	if (block_sz)
+		reqs[n_reqs++] = (il_net_req_t){ .id = 1,
+						 .address = IL_NET_MON_BLOCK_SZ_ADDR,
+						 .buf = block_sz,
+						 .sz = sizeof(*block_sz) };
+
+	r = il_net__transfer(net, reqs, n_reqs);
+	if (r < 0)
+		return r;
+
+	return 1;
+}
+
+/**
+ * Record a channel mapping in the session state.
+ *
+ * @param [in, out] session
+ *	Session channels.
+ * @param [in, out] cnt
+ *	Number of session channels.
+ * @param [in] channel
+ *	Channel.
+ * @param [in] c
+ *	Channel configuration.
+ */
+static void session_channel_set(il_net_mon_channel_t *session, size_t *cnt,
+				int channel, const il_net_mon_channel_t *c)
+{
+	if (channel < 0 || channel >= IL_NET_MAPPING_MAX)
+		return;
+
+	session[channel] = *c;
+	*cnt = MAX(*cnt, (size_t)channel + 1);
+}
+
+/**
+ * Obtain the monotonic time.
+ *
+ * @returns
+ *	Time (ns), 0 if not available.
+ */
+static uint64_t clock_ns(void)
+{
+	osal_timespec_t ts;
+
+	if (osal_clock_gettime(&ts) < 0)
+		return 0;
+
+	return (uint64_t)ts.s * OSAL_CLOCK_NANOSPERSEC + (uint64_t)ts.ns;
+}
+
+/**
+ * Account a successful transaction (counts as a heartbeat).
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ */
+static void traffic_seen(il_net_t *net)
+{
+	uint64_t now = clock_ns();
+
+	osal_mutex_lock(net->state_lock);
+	net->traffic_last = now;
+	osal_mutex_unlock(net->state_lock);
+}
+
+/**
+ * Record a disturbance data upload in the session state.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Disturbance data register address.
+ */
+static void dist_upload_seen(il_net_t *net, uint8_t subnode, uint32_t address)
+{
+	net->session.dist_uploaded = 1;
+	net->session.dist_subnode = subnode;
+	net->session.dist_address = address;
+}
+
+/**
+ * Account a successful read, picking up statusword values on the way.
+ *
+ * @param [in] net
+ *	IngeniaLink network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] address
+ *	Address.
+ * @param [in] buf
+ *	Data read.
+ * @param [in] sz
+ *	Data size.
+ */
+static void read_seen(il_net_t *net, uint8_t subnode, uint32_t address,
+		      const void *buf, size_t sz)
+{
+	uint16_t sw;
+
+	if (address == IL_NET_STATUSWORD_ADDR && sz >= sizeof(sw)) {
+		memcpy(&sw, buf, sizeof(sw));
+		il_net__sw_seen(net, subnode, sw);
+	} else {
+		traffic_seen(net);
+	}
+}
 
 /*******************************************************************************
  * Internal
  ******************************************************************************/
+
 void il_net__retain(il_net_t *net)
 {
 	net->ops->_retain(net);
@@ -20,25 +419,463 @@ void il_net__release(il_net_t *net)
 
 void il_net__state_set(il_net_t *net, il_net_state_t state)
 {
+	/* drive side configuration is no longer known */
+	if (state != IL_NET_STATE_CONNECTED) {
+		net->mon_dist_state = IL_NET_MON_DIST_UNKNOWN;
+		net->monitoring_applied_cnt = 0;
+		net->disturbance_applied_cnt = 0;
+	}
+
 	net->ops->_state_set(net, state);
 }
 
+int il_net__mon_dist_version_get(il_net_t *net, uint32_t *version)
+{
+	int r;
+
+	switch (net->mon_dist_state) {
+	case IL_NET_MON_DIST_V1:
+		return IL_ENOTSUP;
+	case IL_NET_MON_DIST_V2:
+		*version = net->mon_dist_version;
+		return 0;
+	default:
+		break;
+	}
+
+	r = il_net__read(net, 1, 0, IL_NET_MON_DIST_VERSION_ADDR,
+			 &net->mon_dist_version, sizeof(net->mon_dist_version));
+	if (r < 0) {
+		/* only a rejected read proves the register does not exist */
+		if (r == IL_ENACK)
+			net->mon_dist_state = IL_NET_MON_DIST_V1;
+		return r;
+	}
+
+	net->mon_dist_state = IL_NET_MON_DIST_V2;
+	*version = net->mon_dist_version;
+
+	return 0;
+}
+
+void il_net__monitoring_progress(il_net_t *net, size_t done, size_t total)
+{
+	if (net->monitoring_progress_cb)
+		net->monitoring_progress_cb(net->monitoring_progress_ctx, done,
+					    total);
+}
+
+void il_net__monitoring_download_done(il_net_t *net,
+				      const osal_timespec_t *start,
+				      size_t blocks)
+{
+	il_net_mon_download_stats_t *stats = &net->monitoring_download_stats;
+	osal_timespec_t now;
+	long long elapsed;
+
+	(void)osal_clock_gettime(&now);
+	elapsed = (long long)(now.s - start->s) * OSAL_CLOCK_NANOSPERSEC +
+		  (now.ns - start->ns);
+
+	stats->bytes = net->monitoring_data_size;
+	stats->blocks = blocks;
+	stats->elapsed_ns = elapsed > 0 ? (uint64_t)elapsed : 0;
+	stats->throughput = elapsed > 0 ?
+		(double)stats->bytes * OSAL_CLOCK_NANOSPERSEC / elapsed : 0.;
+}
+
+int il_net__monitoring_channel_set(il_net_t *net, int channel,
+				   il_reg_dtype_t dtype)
+{
+	int r;
+
+	r = channels_grow((void **)&net->monitoring_data_channels,
+			  &net->monitoring_channels_cnt,
+			  sizeof(*net->monitoring_data_channels), channel);
+	if (r < 0)
+		return r;
+
+	net->monitoring_data_channels[channel].type = dtype;
+
+	return 0;
+}
+
+int il_net__monitoring_raw_reserve(il_net_t *net, size_t sz)
+{
+	return buf_reserve((void **)&net->monitoring_raw_data,
+			   &net->monitoring_raw_sz, sz);
+}
+
+void il_net__monitoring_release(il_net_t *net)
+{
+	size_t ch;
+
+	for (ch = 0; ch < net->monitoring_channels_cnt; ch++)
+		free(net->monitoring_data_channels[ch].value.monitoring_data_u8);
+
+	free(net->monitoring_data_channels);
+	net->monitoring_data_channels = NULL;
+	net->monitoring_channels_cnt = 0;
+
+	free(net->monitoring_raw_data);
+	net->monitoring_raw_data = NULL;
+	net->monitoring_raw_sz = 0;
+	net->monitoring_data_size = 0;
+
+	net->monitoring_applied_cnt = 0;
+
+	il_mon_decode__release(&net->monitoring_layout);
+}
+
+int il_net__disturbance_channel_set(il_net_t *net, int channel,
+				    il_reg_dtype_t dtype)
+{
+	int r;
+
+	r = channels_grow((void **)&net->disturbance_data_channels,
+			  &net->disturbance_channels_cnt,
+			  sizeof(*net->disturbance_data_channels), channel);
+	if (r < 0)
+		return r;
+
+	net->disturbance_data_channels[channel].type = dtype;
+
+	return disturbance_pack(net);
+}
+
+void il_net__disturbance_release(il_net_t *net)
+{
+	size_t ch;
+
+	for (ch = 0; ch < net->disturbance_channels_cnt; ch++)
+		free(net->disturbance_data_channels[ch].value.disturbance_data_u8);
+
+	free(net->disturbance_data_channels);
+	net->disturbance_data_channels = NULL;
+	net->disturbance_channels_cnt = 0;
+
+	free(net->disturbance_data);
+	net->disturbance_data = NULL;
+
+	free(net->disturbance_packed);
+	net->disturbance_packed = NULL;
+	net->disturbance_packed_cap = 0;
+	net->disturbance_packed_sz = 0;
+	net->disturbance_sample_sz = 0;
+
+	net->disturbance_applied_cnt = 0;
+}
+
+int il_net__monitoring_layout_update(il_net_t *net)
+{
+	il_reg_dtype_t *types = NULL;
+	size_t n_ch, ch;
+	int r;
+
+	il_mon_decode__release(&net->monitoring_layout);
+
+	n_ch = MIN(net->monitoring_number_mapped_registers,
+		   net->monitoring_channels_cnt);
+	if (n_ch > 0) {
+		types = malloc(n_ch * sizeof(*types));
+		if (!types) {
+			ilerr__set("Channel types allocation failed");
+			return IL_ENOMEM;
+		}
+
+		for (ch = 0; ch < n_ch; ch++)
+			types[ch] = net->monitoring_data_channels[ch].type;
+	}
+
+	r = il_mon_decode__compile(&net->monitoring_layout, types, n_ch,
+				   net->monitoring_bytes_per_block,
+				   IL_MON_DECODE_ISA_AUTO);
+
+	free(types);
+
+	return r;
+}
+
+int il_net__monitoring_decode(il_net_t *net)
+{
+	const il_mon_layout_t *layout = &net->monitoring_layout;
+	void *dst_[16], **dst = dst_;
+	size_t n, ch;
+	int r = 0;
+
+	if (layout->n_ch == 0 || layout->block_sz == 0)
+		return 0;
+
+	if (layout->n_ch > net->monitoring_channels_cnt) {
+		ilerr__set("Monitoring layout out of date");
+		return IL_ESTATE;
+	}
+
+	if (layout->n_ch > ARRAY_SIZE(dst_)) {
+		dst = malloc(layout->n_ch * sizeof(*dst));
+		if (!dst) {
+			ilerr__set("Channel pointers allocation failed");
+			return IL_ENOMEM;
+		}
+	}
+
+	n = net->monitoring_data_size / layout->block_sz;
+	for (ch = 0; ch < layout->n_ch; ch++) {
+		struct monitoring_data_t *data = &net->monitoring_data_channels[ch];
+
+		r = buf_reserve((void **)&data->value.monitoring_data_u8,
+				&data->sz, (n ? n : 1) * layout->ch[ch].sz);
+		if (r < 0)
+			goto cleanup_dst;
+
+		dst[ch] = data->value.monitoring_data_u8;
+	}
+
+	if (n > 0)
+		il_mon_decode__run(layout, net->monitoring_raw_data, n, dst);
+
+cleanup_dst:
+	if (dst != dst_)
+		free(dst);
+
+	return r;
+}
+
 int il_net__write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, const void *buf,
 		  size_t sz, int confirmed, uint16_t extended)
 {
-	return net->ops->_write(net, id, subnode, address, buf, sz, confirmed, extended);
+	int r;
+
+	r = net->ops->_write(net, id, subnode, address, buf, sz, confirmed, extended);
+	if (r >= 0) {
+		traffic_seen(net);
+		if (extended == 1)
+			dist_upload_seen(net, subnode, address);
+	}
+
+	return r;
 }
 
 int il_net__wait_write(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, const void *buf,
 		  size_t sz, int confirmed, uint16_t extended)
 {
-	return net->ops->_wait_write(net, id, subnode, address, buf, sz, confirmed, extended);
+	int r;
+
+	r = net->ops->_wait_write(net, id, subnode, address, buf, sz, confirmed, extended);
+	if (r >= 0) {
+		traffic_seen(net);
+		if (extended == 1)
+			dist_upload_seen(net, subnode, address);
+	}
+
+	return r;
 }
 
 int il_net__read(il_net_t *net, uint16_t id, uint8_t subnode, uint32_t address, void *buf,
 		 size_t sz)
 {
-	return net->ops->_read(net, id, subnode, address, buf, sz);
+	int r;
+
+	r = net->ops->_read(net, id, subnode, address, buf, sz);
+	if (r >= 0)
+		read_seen(net, subnode, address, buf, sz);
+
+	return r;
+}
+
+int il_net__transfer(il_net_t *net, il_net_req_t *reqs, size_t n)
+{
+	int r = 0;
+	size_t i;
+
+	if (net->ops->_transfer) {
+		r = net->ops->_transfer(net, reqs, n);
+
+		for (i = 0; i < n; i++) {
+			il_net_req_t *req = &reqs[i];
+
+			if (req->r < 0)
+				continue;
+
+			if (req->write)
+				traffic_seen(net);
+			else
+				read_seen(net, req->subnode, req->address,
+					  req->buf, req->sz);
+		}
+
+		return r;
+	}
+
+	/* fallback: one request after the other */
+	for (i = 0; i < n; i++) {
+		il_net_req_t *req = &reqs[i];
+
+		if (req->write)
+			req->r = il_net__write(net, req->id, req->subnode,
+					       req->address, req->buf, req->sz,
+					       1, 0);
+		else
+			req->r = il_net__read(net, req->id, req->subnode,
+					      req->address, req->buf, req->sz);
+
+		if (req->r < 0 && r == 0)
+			r = req->r;
+	}
+
+	return r;
+}
+
+int il_net__mgr_attach(il_net_t *net, int attach)
+{
+	if (!net->ops->_mgr_attach) {
+		ilerr__set("Network can not be managed");
+		return IL_ENOTSUP;
+	}
+
+	return net->ops->_mgr_attach(net, attach);
+}
+
+int il_net__mgr_fd(il_net_t *net)
+{
+	if (!net->ops->_mgr_fd) {
+		ilerr__set("Network can not be managed");
+		return IL_ENOTSUP;
+	}
+
+	return net->ops->_mgr_fd(net);
+}
+
+int il_net__probe_send(il_net_t *net, uint8_t subnode)
+{
+	return net->ops->_probe_send(net, subnode);
+}
+
+int il_net__probe_recv(il_net_t *net, uint8_t subnode, uint16_t *sw)
+{
+	return net->ops->_probe_recv(net, subnode, sw);
+}
+
+int il_net__reopen(il_net_t *net)
+{
+	return net->ops->_reopen(net);
+}
+
+int il_net__session_restore(il_net_t *net)
+{
+	il_net_session_t session = net->session;
+	int r = 0, r_;
+
+	/* the drive may have been power cycled, cached state is stale */
+	net->mon_dist_state = IL_NET_MON_DIST_UNKNOWN;
+	net->monitoring_applied_cnt = 0;
+	net->disturbance_applied_cnt = 0;
+
+	if (session.mon_cnt > 0) {
+		r_ = il_net_monitoring_configure(net, session.mon,
+						 session.mon_cnt);
+		if (r_ < 0 && r == 0)
+			r = r_;
+	}
+
+	if (session.dist_cnt > 0) {
+		r_ = il_net_disturbance_configure(net, session.dist,
+						  session.dist_cnt);
+		if (r_ < 0 && r == 0)
+			r = r_;
+	}
+
+	if (session.dist_uploaded) {
+		r_ = il_net__write(net, 1, session.dist_subnode,
+				   session.dist_address, NULL, 0, 1, 1);
+		if (r_ < 0 && r == 0)
+			r = r_;
+	}
+
+	if (session.mon_enabled) {
+		r_ = il_net_enable_monitoring(net);
+		if (r_ < 0 && r == 0)
+			r = r_;
+	}
+
+	if (session.dist_enabled) {
+		r_ = il_net_enable_disturbance(net);
+		if (r_ < 0 && r == 0)
+			r = r_;
+	}
+
+	/* keep the session even if the drive rejected part of it */
+	net->session = session;
+
+	return r;
+}
+
+void il_net__sw_notify(il_net_t *net, uint16_t id, uint16_t sw)
+{
+	il_net_sw_subscriber_lst_t *subs = &net->sw_subs;
+	int i;
+
+	osal_mutex_lock(subs->lock);
+
+	for (i = 0; i < subs->sz; i++) {
+		if (subs->subs[i].id == id && subs->subs[i].cb) {
+			subs->subs[i].cb(subs->subs[i].ctx, sw);
+			break;
+		}
+	}
+
+	osal_mutex_unlock(subs->lock);
+}
+
+void il_net__sw_seen(il_net_t *net, uint8_t subnode, uint16_t sw)
+{
+	uint64_t now = clock_ns();
+
+	osal_mutex_lock(net->state_lock);
+
+	net->traffic_last = now;
+	if (subnode == 1) {
+		net->sw_last = now;
+		net->sw_value = sw;
+	}
+
+	osal_mutex_unlock(net->state_lock);
+
+	if (subnode == 1)
+		il_net__sw_notify(net, 1, sw);
+}
+
+int il_net__heartbeat_due(il_net_t *net)
+{
+	uint64_t now = clock_ns();
+	int due;
+
+	osal_mutex_lock(net->state_lock);
+
+	due = net->traffic_last == 0 || net->heartbeat_idle <= 0 ||
+	      now - net->traffic_last >=
+	      (uint64_t)net->heartbeat_idle * OSAL_CLOCK_NANOSPERMSEC;
+
+	osal_mutex_unlock(net->state_lock);
+
+	return due;
+}
+
+int il_net__sw_fresh(il_net_t *net, int age, uint16_t *sw)
+{
+	uint64_t now = clock_ns();
+	int fresh;
+
+	osal_mutex_lock(net->state_lock);
+
+	fresh = net->sw_last != 0 &&
+		now - net->sw_last < (uint64_t)age * OSAL_CLOCK_NANOSPERMSEC;
+	if (fresh)
+		*sw = net->sw_value;
+
+	osal_mutex_unlock(net->state_lock);
+
+	return fresh;
 }
 
 int il_net__sw_subscribe(il_net_t *net, uint16_t id,
@@ -115,6 +952,13 @@ int il_net_mon_stop(il_net_t *net)
 	return net->ops->mon_stop(net);
 }
 
+void il_net_heartbeat_idle_set(il_net_t *net, int idle)
+{
+	osal_mutex_lock(net->state_lock);
+	net->heartbeat_idle = idle;
+	osal_mutex_unlock(net->state_lock);
+}
+
 il_net_state_t il_net_state_get(il_net_t *net)
 {
 	return net->ops->state_get(net);
@@ -157,7 +1001,17 @@ uint32_t il_net_disturbance_data_size_get(il_net_t *net)
 
 void il_net_disturbance_data_set(il_net_t *net, uint16_t disturbance_data[2048])
 {
-	for (int i = 0; i < 2048; net->disturbance_data[i] = disturbance_data[i], i++);
+	if (!net->disturbance_data) {
+		net->disturbance_data = malloc(IL_NET_DISTURBANCE_DATA_SZ *
+					       sizeof(*net->disturbance_data));
+		if (!net->disturbance_data) {
+			ilerr__set("Disturbance data allocation failed");
+			return;
+		}
+	}
+
+	memcpy(net->disturbance_data, disturbance_data,
+	       IL_NET_DISTURBANCE_DATA_SZ * sizeof(*net->disturbance_data));
 }
 
 void il_net_disturbance_data_size_set(il_net_t *net, uint16_t disturbance_data_size)
@@ -167,12 +1021,97 @@ void il_net_disturbance_data_size_set(il_net_t *net, uint16_t disturbance_data_s
 
 int il_net_remove_all_mapped_registers(il_net_t *net)
 {
-	return net->ops->remove_all_mapped_registers(net);
+	int r;
+
+	r = net->ops->remove_all_mapped_registers(net);
+	if (r >= 0)
+		net->session.mon_cnt = 0;
+
+	return r;
 }
 
 int il_net_set_mapped_register(il_net_t *net, int channel, uint32_t address, uint8_t subnode, il_reg_dtype_t dtype, uint8_t size)
 {
-	return net->ops->set_mapped_register(net, channel, address, subnode, dtype, size);
+	il_net_mon_channel_t c = { .address = address, .subnode = subnode,
+				   .dtype = dtype, .size = size };
+	int r;
+
+	r = net->ops->set_mapped_register(net, channel, address, subnode, dtype, size);
+	if (r >= 0)
+		session_channel_set(net->session.mon, &net->session.mon_cnt,
+				    channel, &c);
+
+	return r;
+}
+
+void il_net_monitoring_progress_cb_set(il_net_t *net,
+				       il_net_mon_progress_cb_t cb, void *ctx)
+{
+	net->monitoring_progress_cb = cb;
+	net->monitoring_progress_ctx = ctx;
+}
+
+void il_net_monitoring_download_stats_get(il_net_t *net,
+					  il_net_mon_download_stats_t *stats)
+{
+	*stats = net->monitoring_download_stats;
+}
+
+int il_net_monitoring_configure(il_net_t *net,
+				const il_net_mon_channel_t *channels, size_t n)
+{
+	uint16_t block_sz = 0;
+	uint32_t version;
+	size_t ch;
+	int r;
+
+	if (n > IL_NET_MAPPING_MAX) {
+		ilerr__set("Too many monitoring channels (%zu)", n);
+		return IL_EINVAL;
+	}
+
+	/* original interface: channels can only be appended */
+	if (il_net__mon_dist_version_get(net, &version) < 0) {
+		r = il_net_remove_all_mapped_registers(net);
+		for (ch = 0; ch < n && r >= 0; ch++)
+			r = il_net_set_mapped_register(net, (int)ch,
+						       channels[ch].address,
+						       channels[ch].subnode,
+						       channels[ch].dtype,
+						       channels[ch].size);
+		return r;
+	}
+
+	r = mapping_apply(net, channels, n, net->monitoring_applied,
+			  net->monitoring_applied_cnt,
+			  net->monitoring_number_mapped_registers,
+			  IL_NET_MON_MAPPING_ADDR, IL_NET_MON_MAPPED_CNT_ADDR,
+			  &block_sz);
+	if (r < 0) {
+		/* drive state unknown, rewrite everything next time */
+		net->monitoring_applied_cnt = 0;
+		return r;
+	}
+
+	memcpy(net->session.mon, channels, n * sizeof(*channels));
+	net->session.mon_cnt = n;
+
+	if (r == 0)
+		return 0;
+
+	for (ch = 0; ch < n; ch++) {
+		r = il_net__monitoring_channel_set(net, (int)ch,
+						   channels[ch].dtype);
+		if (r < 0)
+			return r;
+	}
+
+	memcpy(net->monitoring_applied, channels, n * sizeof(*channels));
+	net->monitoring_applied_cnt = n;
+	net->monitoring_number_mapped_registers = (uint16_t)n;
+	net->monitoring_bytes_per_block = block_sz;
+
+	return il_net__monitoring_layout_update(net);
 }
 
 uint16_t il_net_num_mapped_registers_get(il_net_t *net)
@@ -182,22 +1121,46 @@ uint16_t il_net_num_mapped_registers_get(il_net_t *net)
 
 int il_net_enable_monitoring(il_net_t *net)
 {
-	return net->ops->enable_monitoring(net);
+	int r;
+
+	r = net->ops->enable_monitoring(net);
+	if (r >= 0)
+		net->session.mon_enabled = 1;
+
+	return r;
 }
 
 int il_net_disable_monitoring(il_net_t *net)
 {
-	return net->ops->disable_monitoring(net);
+	int r;
+
+	r = net->ops->disable_monitoring(net);
+	if (r >= 0)
+		net->session.mon_enabled = 0;
+
+	return r;
 }
 
 int il_net_enable_disturbance(il_net_t *net)
 {
-	return net->ops->enable_disturbance(net);
+	int r;
+
+	r = net->ops->enable_disturbance(net);
+	if (r >= 0)
+		net->session.dist_enabled = 1;
+
+	return r;
 }
 
 int il_net_disable_disturbance(il_net_t *net)
 {
-	return net->ops->disable_disturbance(net);
+	int r;
+
+	r = net->ops->disable_disturbance(net);
+	if (r >= 0)
+		net->session.dist_enabled = 0;
+
+	return r;
 }
 
 int il_net_monitoring_remove_data(il_net_t *net)
@@ -217,32 +1180,95 @@ int il_net_read_monitoring_data(il_net_t *net)
 
 uint16_t *il_net_monitoring_channel_u16(il_net_t *net, int channel)
 {
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
 	return net->monitoring_data_channels[channel].value.monitoring_data_u16;
 }
 
 int16_t *il_net_monitoring_channel_s16(il_net_t *net, int channel)
 {
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
 	return net->monitoring_data_channels[channel].value.monitoring_data_s16;
 }
 
 uint32_t *il_net_monitoring_channel_u32(il_net_t *net, int channel)
 {
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
 	return net->monitoring_data_channels[channel].value.monitoring_data_u32;
 }
 
 int32_t *il_net_monitoring_channel_s32(il_net_t *net, int channel)
 {
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
 	return net->monitoring_data_channels[channel].value.monitoring_data_s32;
 }
 
 float *il_net_monitoring_channel_flt(il_net_t *net, int channel)
 {
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
 	return net->monitoring_data_channels[channel].value.monitoring_data_flt;
 }
 
+uint8_t *il_net_monitoring_channel_u8(il_net_t *net, int channel)
+{
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
+	return net->monitoring_data_channels[channel].value.monitoring_data_u8;
+}
+
+int8_t *il_net_monitoring_channel_s8(il_net_t *net, int channel)
+{
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
+	return net->monitoring_data_channels[channel].value.monitoring_data_s8;
+}
+
+uint64_t *il_net_monitoring_channel_u64(il_net_t *net, int channel)
+{
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
+	return net->monitoring_data_channels[channel].value.monitoring_data_u64;
+}
+
+int64_t *il_net_monitoring_channel_s64(il_net_t *net, int channel)
+{
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
+	return net->monitoring_data_channels[channel].value.monitoring_data_s64;
+}
+
+double *il_net_monitoring_channel_dbl(il_net_t *net, int channel)
+{
+	if (channel < 0 || (size_t)channel >= net->monitoring_channels_cnt)
+		return NULL;
+
+	return net->monitoring_data_channels[channel].value.monitoring_data_dbl;
+}
+
 int il_net_disturbance_remove_all_mapped_registers(il_net_t *net)
 {
-	return net->ops->disturbance_remove_all_mapped_registers(net);
+	int r;
+
+	r = net->ops->disturbance_remove_all_mapped_registers(net);
+	if (r >= 0) {
+		net->session.dist_cnt = 0;
+		net->session.dist_uploaded = 0;
+	}
+
+	return r;
 }
 
 
@@ -251,33 +1277,133 @@ int il_net_disturbance_set_mapped_register(il_net_t *net,
 	int channel, uint32_t address,
 	uint8_t subnode, il_reg_dtype_t dtype, uint8_t size)
 {
+	il_net_mon_channel_t c = { .address = address, .subnode = subnode,
+				   .dtype = dtype, .size = size };
+	int r;
+
 	net->last_channel = net->last_channel > channel ? net->last_channel : channel;
-	return net->ops->disturbance_set_mapped_register(net, channel, address, subnode, dtype, size);
+	r = net->ops->disturbance_set_mapped_register(net, channel, address, subnode, dtype, size);
+	if (r >= 0)
+		session_channel_set(net->session.dist, &net->session.dist_cnt,
+				    channel, &c);
+
+	return r;
+}
+
+int il_net_disturbance_configure(il_net_t *net,
+				 const il_net_mon_channel_t *channels, size_t n)
+{
+	uint32_t version;
+	size_t ch;
+	int r;
+
+	if (n > IL_NET_MAPPING_MAX) {
+		ilerr__set("Too many disturbance channels (%zu)", n);
+		return IL_EINVAL;
+	}
+
+	/* original interface: channels can only be appended */
+	if (il_net__mon_dist_version_get(net, &version) < 0) {
+		r = il_net_disturbance_remove_all_mapped_registers(net);
+		for (ch = 0; ch < n && r >= 0; ch++)
+			r = il_net_disturbance_set_mapped_register(
+				net, (int)ch, channels[ch].address,
+				channels[ch].subnode, channels[ch].dtype,
+				channels[ch].size);
+		return r;
+	}
+
+	r = mapping_apply(net, channels, n, net->disturbance_applied,
+			  net->disturbance_applied_cnt,
+			  net->disturbance_number_mapped_registers,
+			  IL_NET_DIST_MAPPING_ADDR, IL_NET_DIST_MAPPED_CNT_ADDR,
+			  NULL);
+	if (r < 0) {
+		/* drive state unknown, rewrite everything next time */
+		net->disturbance_applied_cnt = 0;
+		return r;
+	}
+
+	memcpy(net->session.dist, channels, n * sizeof(*channels));
+	net->session.dist_cnt = n;
+
+	if (r == 0)
+		return 0;
+
+	for (ch = 0; ch < n; ch++) {
+		r = il_net__disturbance_channel_set(net, (int)ch,
+						    channels[ch].dtype);
+		if (r < 0)
+			return r;
+	}
+
+	memcpy(net->disturbance_applied, channels, n * sizeof(*channels));
+	net->disturbance_applied_cnt = n;
+	net->disturbance_number_mapped_registers = (uint16_t)n;
+	net->last_channel = n ? (uint8_t)(n - 1) : 0;
+
+	return 0;
 }
 
 void il_net_disturbance_data_u16_set(il_net_t *net, int channel, uint16_t disturbance_data[2048])
 {
-	for (size_t i = 0; i < (1010/sizeof(uint16_t)); net->disturbance_data_channels[channel].value.disturbance_data_u16[i] = disturbance_data[i], i++);
+	(void)disturbance_channel_store(net, channel, disturbance_data,
+					IL_NET_DISTURBANCE_CH_SZ / sizeof(uint16_t) *
+					sizeof(uint16_t));
 }
 
 void il_net_disturbance_data_s16_set(il_net_t *net, int channel, int16_t disturbance_data[2048])
 {
-	for (size_t i = 0; i < (1010/sizeof(int16_t)); net->disturbance_data_channels[channel].value.disturbance_data_s16[i] = disturbance_data[i], i++);
+	(void)disturbance_channel_store(net, channel, disturbance_data,
+					IL_NET_DISTURBANCE_CH_SZ / sizeof(int16_t) *
+					sizeof(int16_t));
 }
 
 void il_net_disturbance_data_u32_set(il_net_t *net, int channel, uint32_t disturbance_data[2048])
 {
-	for (size_t i = 0; i < (1010/sizeof(uint32_t)); net->disturbance_data_channels[channel].value.disturbance_data_u32[i] = disturbance_data[i], i++);
+	(void)disturbance_channel_store(net, channel, disturbance_data,
+					IL_NET_DISTURBANCE_CH_SZ / sizeof(uint32_t) *
+					sizeof(uint32_t));
 }
 
 void il_net_disturbance_data_s32_set(il_net_t *net, int channel, int32_t disturbance_data[2048])
 {
-	for (size_t i = 0; i < (1010/sizeof(int32_t)); net->disturbance_data_channels[channel].value.disturbance_data_s32[i] = disturbance_data[i], i++);
+	(void)disturbance_channel_store(net, channel, disturbance_data,
+					IL_NET_DISTURBANCE_CH_SZ / sizeof(int32_t) *
+					sizeof(int32_t));
 }
 
 void il_net_disturbance_data_flt_set(il_net_t *net, int channel, float disturbance_data[2048])
 {
-	for (size_t i = 0; i < (1010/sizeof(float)); net->disturbance_data_channels[channel].value.disturbance_data_flt[i] = disturbance_data[i], i++);
+	(void)disturbance_channel_store(net, channel, disturbance_data,
+					IL_NET_DISTURBANCE_CH_SZ / sizeof(float) *
+					sizeof(float));
+}
+
+int il_net_disturbance_channel_data_set(il_net_t *net, int channel,
+					const void *data, size_t n)
+{
+	size_t sz;
+	int r;
+
+	if (channel < 0 || (size_t)channel >= net->disturbance_channels_cnt) {
+		ilerr__set("Disturbance channel not mapped (%d)", channel);
+		return IL_ESTATE;
+	}
+
+	sz = disturbance_dtype_sz(net->disturbance_data_channels[channel].type);
+	if (sz == 0) {
+		ilerr__set("Unsupported disturbance channel type");
+		return IL_EINVAL;
+	}
+
+	r = disturbance_channel_store(net, channel, data, n * sz);
+	if (r < 0)
+		return r;
+
+	net->disturbance_data_size = (uint32_t)net->disturbance_packed_sz;
+
+	return 0;
 }
 
 int il_net_close_socket(il_net_t *net)
@@ -351,6 +1477,57 @@ int il_net_set_recv_timeout(il_net_t *net, uint32_t timeout)
 	}
 }
 
+int il_net_set_wait_write_timeout(il_net_t *net, uint32_t timeout)
+{
+	switch(net->prot)
+	{
+		case IL_NET_PROT_ETH:
+			return il_eth_net_ops.set_wait_write_timeout(net, timeout);
+		case IL_NET_PROT_ECAT:
+			return il_ecat_net_ops.set_wait_write_timeout(net, timeout);
+		default:
+			ilerr__set("Functionality not supported");
+			return IL_ENOTSUP;
+	}
+}
+
+int il_net_set_pipeline_depth(il_net_t *net, size_t depth)
+{
+	switch(net->prot)
+	{
+		case IL_NET_PROT_ETH:
+			return il_eth_net_ops.set_pipeline_depth(net, depth);
+		default:
+			ilerr__set("Functionality not supported");
+			return IL_ENOTSUP;
+	}
+}
+
+int il_net_set_reactor(il_net_t *net, int enable)
+{
+	switch(net->prot)
+	{
+		case IL_NET_PROT_ETH:
+			return il_eth_net_ops.set_reactor(net, enable);
+		default:
+			ilerr__set("Functionality not supported");
+			return IL_ENOTSUP;
+	}
+}
+
+int il_net_set_reconnection_backoff(il_net_t *net, uint32_t base,
+				    uint32_t ceiling)
+{
+	switch(net->prot)
+	{
+		case IL_NET_PROT_ETH:
+			return il_eth_net_ops.set_reconnection_backoff(net, base, ceiling);
+		default:
+			ilerr__set("Functionality not supported");
+			return IL_ENOTSUP;
+	}
+}
+
 int il_net_set_status_check_stop(il_net_t *net, int stop)
 {
 	switch(net->prot)
@@ -2,6 +2,7 @@
 #define NET_H_
 
 #include "ingenialink/net.h"
+#include "ingenialink/mon_decode.h"
 #include "ingenialink/utils.h"
 #include "ingenialink/servo.h"
 
@@ -13,6 +14,43 @@
 /** Emergency subscribers default array size. */
 #define EMCY_SUBS_SZ_DEF	10
 
+/** Disturbance channel data size (bytes). */
+#define IL_NET_DISTURBANCE_CH_SZ	1010
+
+/** Disturbance raw data size (elements). */
+#define IL_NET_DISTURBANCE_DATA_SZ	2048
+
+/** Monitoring/disturbance mapping registers. */
+#define IL_NET_MAPPING_MAX		16
+
+/** Statusword register address. */
+#define IL_NET_STATUSWORD_ADDR		0x0011
+
+/** Monitoring/disturbance version register address. */
+#define IL_NET_MON_DIST_VERSION_ADDR	0x00BA
+
+/** Monitoring first mapping register address. */
+#define IL_NET_MON_MAPPING_ADDR		0x00D0
+/** Monitoring number of mapped registers address. */
+#define IL_NET_MON_MAPPED_CNT_ADDR	0x00E3
+/** Monitoring bytes per block register address. */
+#define IL_NET_MON_BLOCK_SZ_ADDR	0x00E4
+
+/** Disturbance first mapping register address. */
+#define IL_NET_DIST_MAPPING_ADDR	0x0090
+/** Disturbance number of mapped registers address. */
+#define IL_NET_DIST_MAPPED_CNT_ADDR	0x00E8
+
+/** Monitoring/disturbance version states. */
+typedef enum {
+	/** Not known yet. */
+	IL_NET_MON_DIST_UNKNOWN,
+	/** Original interface (no version register). */
+	IL_NET_MON_DIST_V1,
+	/** Versioned interface. */
+	IL_NET_MON_DIST_V2,
+} il_net_mon_dist_state_t;
+
 /** Statusword update subscriber. */
 struct il_net_sw_subscriber {
 	/** Node ID. */
@@ -65,34 +103,65 @@ typedef struct {
 	osal_mutex_t *lock;
 } il_net_emcy_subscriber_lst_t;
 
+/** Monitoring channel (samples are allocated on demand). */
 struct monitoring_data_t {
 	il_reg_dtype_t type;
 	union {
-		uint8_t monitoring_data_u8[1024];
-		int8_t monitoring_data_s8[1024];
-		uint16_t monitoring_data_u16[1024];
-		int16_t monitoring_data_s16[1024];
-		uint32_t monitoring_data_u32[1024];
-		int32_t monitoring_data_s32[1024];
-		uint64_t monitoring_data_u64[1024];
-		int64_t monitoring_data_s64[1024];
-		float monitoring_data_flt[102400];
+		uint8_t *monitoring_data_u8;
+		int8_t *monitoring_data_s8;
+		uint16_t *monitoring_data_u16;
+		int16_t *monitoring_data_s16;
+		uint32_t *monitoring_data_u32;
+		int32_t *monitoring_data_s32;
+		uint64_t *monitoring_data_u64;
+		int64_t *monitoring_data_s64;
+		float *monitoring_data_flt;
+		double *monitoring_data_dbl;
 	} value;
+	/** Allocated size (bytes). */
+	size_t sz;
 };
 
+/** Disturbance channel (samples are allocated on demand). */
 struct disturbance_data_t {
 	il_reg_dtype_t type;
 	union {
-		uint8_t disturbance_data_u8[1024];
-		int8_t disturbance_data_s8[1024];
-		uint16_t disturbance_data_u16[1024];
-		int16_t disturbance_data_s16[1024];
-		uint32_t disturbance_data_u32[1024];
-		int32_t disturbance_data_s32[1024];
-		float disturbance_data_flt[1024];
+		uint8_t *disturbance_data_u8;
+		int8_t *disturbance_data_s8;
+		uint16_t *disturbance_data_u16;
+		int16_t *disturbance_data_s16;
+		uint32_t *disturbance_data_u32;
+		int32_t *disturbance_data_s32;
+		float *disturbance_data_flt;
 	} value;
+	/** Allocated size (bytes). */
+	size_t sz;
+	/** Data set (bytes). */
+	size_t len;
 };
 
+/** Session state known to the library (restored on reconnection). */
+typedef struct {
+	/** Monitoring channels. */
+	il_net_mon_channel_t mon[IL_NET_MAPPING_MAX];
+	/** Number of monitoring channels. */
+	size_t mon_cnt;
+	/** Disturbance channels. */
+	il_net_mon_channel_t dist[IL_NET_MAPPING_MAX];
+	/** Number of disturbance channels. */
+	size_t dist_cnt;
+	/** Disturbance data uploaded flag. */
+	int dist_uploaded;
+	/** Disturbance data register subnode. */
+	uint8_t dist_subnode;
+	/** Disturbance data register address. */
+	uint32_t dist_address;
+	/** Monitoring enabled flag. */
+	int mon_enabled;
+	/** Disturbance enabled flag. */
+	int dist_enabled;
+} il_net_session_t;
+
 /** Network. */
 struct il_net {
 	/** Protocol */
@@ -117,22 +186,66 @@ struct il_net {
 	il_net_sw_subscriber_lst_t sw_subs;
 	/** Emergency subcribers. */
 	il_net_emcy_subscriber_lst_t emcy_subs;
-	/** Monitoring Raw Data. */
-	uint8_t monitoring_raw_data[409600];
+	/** Monitoring Raw Data (allocated on demand). */
+	uint8_t *monitoring_raw_data;
+	/** Monitoring Raw Data allocated size. */
+	size_t monitoring_raw_sz;
 	/** Extended buffer **/
 	char extended_buff[128];
 	/** Monitoring Data. */
-	struct monitoring_data_t monitoring_data_channels[15];
+	struct monitoring_data_t *monitoring_data_channels;
+	/** Monitoring channels allocated. */
+	size_t monitoring_channels_cnt;
 	/** Monitoring number of mapped registers */
 	uint16_t monitoring_number_mapped_registers;
 	/** Monitoring bytes per block */
 	uint16_t monitoring_bytes_per_block;
 	/** Monitoring Data size. */
 	uint32_t monitoring_data_size;
-	/** Disturbance Raw Data. */
-	uint16_t disturbance_data[2048];
+	/** Monitoring channel layout (compiled from mapping). */
+	il_mon_layout_t monitoring_layout;
+	/** Disturbance Raw Data (allocated on demand). */
+	uint16_t *disturbance_data;
 	/** Distburbance Data. */
-	struct disturbance_data_t disturbance_data_channels[16];
+	struct disturbance_data_t *disturbance_data_channels;
+	/** Disturbance channels allocated. */
+	size_t disturbance_channels_cnt;
+	/** Disturbance payload (channels interleaved, packed when set). */
+	uint8_t *disturbance_packed;
+	/** Disturbance payload allocated size (bytes). */
+	size_t disturbance_packed_cap;
+	/** Disturbance payload size (bytes). */
+	size_t disturbance_packed_sz;
+	/** Disturbance sample size, all channels (bytes). */
+	size_t disturbance_sample_sz;
+	/** Monitoring download progress callback. */
+	il_net_mon_progress_cb_t monitoring_progress_cb;
+	/** Monitoring download progress callback context. */
+	void *monitoring_progress_ctx;
+	/** Last monitoring download statistics. */
+	il_net_mon_download_stats_t monitoring_download_stats;
+	/** Last successful transaction (monotonic, ns, 0 if none). */
+	uint64_t traffic_last;
+	/** Last subnode 1 statusword seen (monotonic, ns, 0 if none). */
+	uint64_t sw_last;
+	/** Last subnode 1 statusword value seen. */
+	uint16_t sw_value;
+	/** Heartbeat idle interval (ms). */
+	int heartbeat_idle;
+	/** Monitoring/disturbance version state (cached per connection). */
+	il_net_mon_dist_state_t mon_dist_state;
+	/** Monitoring/disturbance version. */
+	uint32_t mon_dist_version;
+	/** Monitoring channels applied to the drive. */
+	il_net_mon_channel_t monitoring_applied[IL_NET_MAPPING_MAX];
+	/** Number of monitoring channels applied. */
+	size_t monitoring_applied_cnt;
+	/** Disturbance channels applied to the drive. */
+	il_net_mon_channel_t disturbance_applied[IL_NET_MAPPING_MAX];
+	/** Number of disturbance channels applied. */
+	size_t disturbance_applied_cnt;
+	/** Session state (restored on reconnection). */
+	il_net_session_t session;
 	/** Disturbance Data size. */
 	uint32_t disturbance_data_size;
 	/** Last disturbance channel */
@@ -0,0 +1,1215 @@
+#include "net_mgr.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+	#include <unistd.h>
+#elif defined(_WIN32)
+	#include <winsock2.h>
+#else
+	#include <sys/select.h>
+#endif
+
+#include "ingenialink/base/servo.h"
+#include "ingenialink/err.h"
+#include "ingenialink/net.h"
+#include "ingenialink/servo.h"
+#include "net.h"
+#include "servo.h"
+
+#include "external/log.c/src/log.h"
+
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/**
+ * Obtain the time elapsed since the manager was created.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ *
+ * @return
+ *	Elapsed time (ms).
+ */
+static uint64_t now_ms(il_net_mgr_t *mgr)
+{
+	osal_timespec_t now;
+	long long ms;
+
+	(void)osal_clock_gettime(&now);
+
+	ms = (long long)(now.s - mgr->epoch.s) * 1000 +
+	     (now.ns - mgr->epoch.ns) / OSAL_CLOCK_NANOSPERMSEC;
+
+	return ms > 0 ? (uint64_t)ms : 0;
+}
+
+/**
+ * Link a timer at the head of a list.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] t
+ *	Timer.
+ * @param [in] head
+ *	List head.
+ */
+static void timer_link(il_net_mgr_t *mgr, net_mgr_timer_t *t,
+		       net_mgr_timer_t **head)
+{
+	t->next = *head;
+	if (t->next)
+		t->next->pprev = &t->next;
+
+	t->pprev = head;
+	*head = t;
+
+	mgr->armed++;
+}
+
+/**
+ * Cancel a timer (no-op if not armed).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] t
+ *	Timer.
+ */
+static void timer_cancel(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	if (!t->pprev)
+		return;
+
+	*t->pprev = t->next;
+	if (t->next)
+		t->next->pprev = t->pprev;
+
+	t->next = NULL;
+	t->pprev = NULL;
+
+	mgr->armed--;
+}
+
+/**
+ * (Re)arm a timer.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] t
+ *	Timer.
+ * @param [in] ms
+ *	Expiration (ms from now, rounded up to the wheel resolution).
+ */
+static void timer_arm(il_net_mgr_t *mgr, net_mgr_timer_t *t, int ms)
+{
+	uint64_t ticks;
+
+	ticks = (uint64_t)(MAX(ms, 0) + NET_MGR_TICK_MS - 1) / NET_MGR_TICK_MS;
+
+	timer_cancel(mgr, t);
+
+	t->expires = mgr->tick + MAX(ticks, 1);
+	timer_link(mgr, t,
+		   &mgr->wheel[t->expires & (NET_MGR_WHEEL_SZ - 1)]);
+}
+
+/**
+ * Advance the timer wheel, firing the expired timers.
+ *
+ * @note
+ *	Expired timers are first moved to a private list, so that callbacks
+ *	can freely arm or cancel any timer (including the ones still pending
+ *	to fire).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ */
+static void wheel_advance(il_net_mgr_t *mgr)
+{
+	net_mgr_timer_t *expired = NULL;
+	uint64_t target, i, n;
+
+	target = now_ms(mgr) / NET_MGR_TICK_MS;
+	if (target <= mgr->tick)
+		return;
+
+	/* after a long sleep, a single turn visits every slot */
+	n = MIN(target - mgr->tick, NET_MGR_WHEEL_SZ);
+	for (i = 1; i <= n; i++) {
+		net_mgr_timer_t **slot, *t, *next;
+
+		slot = &mgr->wheel[(mgr->tick + i) & (NET_MGR_WHEEL_SZ - 1)];
+		for (t = *slot; t; t = next) {
+			next = t->next;
+			if (t->expires > target)
+				continue;
+
+			timer_cancel(mgr, t);
+			timer_link(mgr, t, &expired);
+		}
+	}
+
+	mgr->tick = target;
+
+	while (expired) {
+		net_mgr_timer_t *t = expired;
+
+		timer_cancel(mgr, t);
+		t->fire(mgr, t);
+	}
+}
+
+/**
+ * Obtain the time left until the next timer expiration.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ *
+ * @return
+ *	Time left (ms), -1 if no timer is armed.
+ */
+static int wheel_timeout(il_net_mgr_t *mgr)
+{
+	uint64_t d, expires, now;
+
+	if (mgr->armed == 0)
+		return -1;
+
+	for (d = 1; d <= NET_MGR_WHEEL_SZ; d++) {
+		net_mgr_timer_t *t;
+
+		t = mgr->wheel[(mgr->tick + d) & (NET_MGR_WHEEL_SZ - 1)];
+		for (; t; t = t->next) {
+			if (t->expires <= mgr->tick + d)
+				goto found;
+		}
+	}
+
+found:
+	expires = (mgr->tick + d) * NET_MGR_TICK_MS;
+	now = now_ms(mgr);
+
+	return expires > now ? (int)(expires - now) : 0;
+}
+
+/**
+ * Wake the event loop up (lock held).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ */
+static void loop_wake(il_net_mgr_t *mgr)
+{
+#ifdef __linux__
+	uint64_t one = 1;
+
+	(void)write(mgr->evfd, &one, sizeof(one));
+#endif
+	osal_cond_broadcast(mgr->cond);
+}
+
+/**
+ * Start watching a network socket (disarmed until a probe is sent).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void fd_add(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+#ifdef __linux__
+	struct epoll_event ev;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLONESHOT;
+	ev.data.ptr = n;
+
+	(void)epoll_ctl(mgr->epfd, EPOLL_CTL_ADD, n->fd, &ev);
+#else
+	(void)mgr;
+	(void)n;
+#endif
+}
+
+/**
+ * Stop watching a network socket.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void fd_del(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+#ifdef __linux__
+	struct epoll_event ev;
+
+	(void)epoll_ctl(mgr->epfd, EPOLL_CTL_DEL, n->fd, &ev);
+#else
+	(void)mgr;
+	(void)n;
+#endif
+}
+
+/**
+ * Arm a network socket for the next reply.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void fd_arm(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+#ifdef __linux__
+	struct epoll_event ev;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLONESHOT;
+	ev.data.ptr = n;
+
+	(void)epoll_ctl(mgr->epfd, EPOLL_CTL_MOD, n->fd, &ev);
+#else
+	(void)mgr;
+	(void)n;
+#endif
+}
+
+/**
+ * Wait for replies or for the next timer expiration (lock held).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] timeout
+ *	Timeout (ms, -1 for infinite).
+ * @param [out] ready
+ *	Networks with a reply available.
+ *
+ * @return
+ *	Number of networks with a reply available.
+ */
+static size_t events_wait(il_net_mgr_t *mgr, int timeout,
+			  net_mgr_net_t **ready)
+{
+	size_t cnt = 0;
+#ifdef __linux__
+	struct epoll_event evs[NET_MGR_EVENTS_MAX];
+	int i, r;
+
+	osal_mutex_unlock(mgr->lock);
+	r = epoll_wait(mgr->epfd, evs, NET_MGR_EVENTS_MAX, timeout);
+	osal_mutex_lock(mgr->lock);
+
+	for (i = 0; i < r; i++) {
+		if (evs[i].data.ptr) {
+			ready[cnt++] = evs[i].data.ptr;
+		} else {
+			uint64_t val;
+
+			(void)read(mgr->evfd, &val, sizeof(val));
+		}
+	}
+#else
+	net_mgr_net_t *n;
+	fd_set fds;
+	struct timeval tv;
+	int max_fd = -1, r;
+
+	/* no wake-up descriptor, wait for a bounded time */
+	if (timeout < 0 || timeout > NET_MGR_POLL_MAX)
+		timeout = NET_MGR_POLL_MAX;
+
+	FD_ZERO(&fds);
+	for (n = mgr->nets; n; n = n->next) {
+		if (n->probing) {
+			FD_SET(n->fd, &fds);
+			max_fd = MAX(max_fd, n->fd);
+		}
+	}
+
+	if (max_fd < 0) {
+		(void)osal_cond_wait(mgr->cond, mgr->lock, MAX(timeout, 1));
+		return 0;
+	}
+
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+
+	osal_mutex_unlock(mgr->lock);
+	r = select(max_fd + 1, &fds, NULL, NULL, &tv);
+	osal_mutex_lock(mgr->lock);
+
+	if (r <= 0)
+		return 0;
+
+	for (n = mgr->nets; n && cnt < NET_MGR_EVENTS_MAX; n = n->next) {
+		if (n->probing && FD_ISSET(n->fd, &fds))
+			ready[cnt++] = n;
+	}
+#endif
+
+	return cnt;
+}
+
+/**
+ * Queue a notification, to be delivered once the lock is released.
+ *
+ * @note
+ *	The notification is dropped if it can not be queued, the next state
+ *	poll or emergency dispatch will deliver it.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] type
+ *	Type.
+ * @param [in] servo
+ *	Servo.
+ * @param [in] subnode
+ *	Subnode (statusword).
+ * @param [in] sw
+ *	Statusword.
+ */
+static void event_queue(il_net_mgr_t *mgr, net_mgr_event_type_t type,
+			il_servo_t *servo, uint8_t subnode, uint16_t sw)
+{
+	net_mgr_event_t *ev;
+
+	if (mgr->events_cnt == mgr->events_cap) {
+		size_t cap = mgr->events_cap ? mgr->events_cap * 2 :
+					       NET_MGR_EVENTS_MAX;
+		void *p;
+
+		p = realloc(mgr->events, cap * sizeof(*mgr->events));
+		if (!p)
+			return;
+
+		mgr->events = p;
+		mgr->events_cap = cap;
+	}
+
+	ev = &mgr->events[mgr->events_cnt++];
+	ev->type = type;
+	ev->servo = servo;
+	ev->subnode = subnode;
+	ev->sw = sw;
+
+	il_servo__retain(servo);
+}
+
+/**
+ * Deliver the queued notifications (lock held, released meanwhile).
+ *
+ * @note
+ *	Subscribers are notified without the manager lock, so that they can
+ *	call into the manager.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ */
+static void events_dispatch(il_net_mgr_t *mgr)
+{
+	size_t i;
+
+	if (mgr->events_cnt == 0)
+		return;
+
+	osal_mutex_unlock(mgr->lock);
+
+	for (i = 0; i < mgr->events_cnt; i++) {
+		net_mgr_event_t *ev = &mgr->events[i];
+
+		if (ev->type == NET_MGR_EVENT_SW)
+			il_servo_base__sw_process(ev->servo, ev->subnode,
+						  ev->sw);
+		else
+			il_servo_base__emcy_dispatch(ev->servo);
+
+		il_servo__release(ev->servo);
+	}
+
+	mgr->events_cnt = 0;
+
+	osal_mutex_lock(mgr->lock);
+}
+
+/**
+ * Handle a failed probe.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void probe_failed(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+	mgr->stats.errors++;
+
+	if (!n->connected) {
+		timer_arm(mgr, &n->reconnect, IL_NET_MGR_RECONNECT_DEF);
+		return;
+	}
+
+	if (++n->errors < NET_MGR_ERRORS_MAX)
+		return;
+
+	ilerr__set("Network connection lost");
+
+	n->connected = 0;
+	n->pending = 0;
+	mgr->stats.disconnects++;
+
+	il_net__state_set(n->net, IL_NET_STATE_DISCONNECTED);
+
+	timer_arm(mgr, &n->reconnect, IL_NET_MGR_RECONNECT_DEF);
+}
+
+/**
+ * Handle a statusword probe reply.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ * @param [in] subnode
+ *	Subnode.
+ * @param [in] sw
+ *	Statusword.
+ */
+static void probe_ok(il_net_mgr_t *mgr, net_mgr_net_t *n, uint8_t subnode,
+		     uint16_t sw)
+{
+	net_mgr_servo_t *s;
+
+	n->errors = 0;
+
+	if (!n->connected) {
+		n->connected = 1;
+		mgr->stats.reconnects++;
+
+		il_net__state_set(n->net, IL_NET_STATE_CONNECTED);
+	}
+
+	il_net__sw_seen(n->net, subnode, sw);
+
+	for (s = mgr->servos; s; s = s->next) {
+		if (s->owner == n && !s->removing)
+			event_queue(mgr, NET_MGR_EVENT_SW, s->servo, subnode,
+				    sw);
+	}
+}
+
+/**
+ * Finish the ongoing probe, releasing the network.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void probe_end(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+	timer_cancel(mgr, &n->timeout);
+
+	n->probing = 0;
+	osal_mutex_unlock(n->net->lock);
+}
+
+/**
+ * Send the next pending probe, if any.
+ *
+ * @note
+ *	The network stays locked until the reply arrives or the probe times
+ *	out, so that the reply is not consumed by anyone else. If the network
+ *	is in use the probe is retried on the next tick.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void probe_start(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+	uint8_t subnode;
+	int r;
+
+	if (n->probing || !n->pending || n->removing)
+		return;
+
+	if (osal_mutex_trylock(n->net->lock) < 0) {
+		mgr->stats.busy++;
+		timer_arm(mgr, &n->retry, NET_MGR_TICK_MS);
+		return;
+	}
+
+	for (subnode = 1; !(n->pending & (1u << (subnode - 1))); subnode++)
+		;
+
+	n->pending &= ~(1u << (subnode - 1));
+
+	r = il_net__probe_send(n->net, subnode);
+	if (r < 0) {
+		osal_mutex_unlock(n->net->lock);
+		probe_failed(mgr, n);
+		return;
+	}
+
+	n->probing = subnode;
+	mgr->stats.probes++;
+
+	fd_arm(mgr, n);
+	timer_arm(mgr, &n->timeout, NET_MGR_PROBE_TIMEOUT);
+}
+
+/**
+ * Complete the ongoing probe (reply available).
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] n
+ *	Managed network.
+ */
+static void probe_complete(il_net_mgr_t *mgr, net_mgr_net_t *n)
+{
+	uint8_t subnode = n->probing;
+	uint16_t sw;
+	int r;
+
+	/* late reply to a probe given up */
+	if (!subnode)
+		return;
+
+	r = il_net__probe_recv(n->net, subnode, &sw);
+	if (r == IL_ETIMEDOUT) {
+		fd_arm(mgr, n);
+		return;
+	}
+
+	probe_end(mgr, n);
+
+	if (r < 0)
+		probe_failed(mgr, n);
+	else
+		probe_ok(mgr, n, subnode, sw);
+
+	probe_start(mgr, n);
+}
+
+/** Probe timeout expiration. */
+static void timeout_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	net_mgr_net_t *n = container_of(t, net_mgr_net_t, timeout);
+
+	if (!n->probing)
+		return;
+
+	probe_end(mgr, n);
+	probe_failed(mgr, n);
+	probe_start(mgr, n);
+}
+
+/** Probe retry expiration. */
+static void retry_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	probe_start(mgr, container_of(t, net_mgr_net_t, retry));
+}
+
+/** Heartbeat expiration. */
+static void heartbeat_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	net_mgr_net_t *n = container_of(t, net_mgr_net_t, heartbeat);
+
+	if (mgr->heartbeat <= 0)
+		return;
+
+	if (n->connected) {
+		if (il_net__heartbeat_due(n->net)) {
+			n->pending |= 1;
+			probe_start(mgr, n);
+		} else {
+			n->errors = 0;
+			mgr->stats.skipped++;
+		}
+	}
+
+	timer_arm(mgr, t, mgr->heartbeat);
+}
+
+/** Reconnection expiration. */
+static void reconnect_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	net_mgr_net_t *n = container_of(t, net_mgr_net_t, reconnect);
+	int fd;
+
+	if (n->connected || n->probing)
+		return;
+
+	if (osal_mutex_trylock(n->net->lock) < 0) {
+		timer_arm(mgr, t, NET_MGR_TICK_MS);
+		return;
+	}
+
+	fd_del(mgr, n);
+
+	/* do not block the API callers while connecting (n is only detached
+	 * by this thread) */
+	osal_mutex_unlock(mgr->lock);
+	fd = il_net__reopen(n->net);
+	osal_mutex_lock(mgr->lock);
+
+	osal_mutex_unlock(n->net->lock);
+
+	if (fd < 0) {
+		timer_arm(mgr, t, IL_NET_MGR_RECONNECT_DEF);
+		return;
+	}
+
+	n->fd = fd;
+	fd_add(mgr, n);
+
+	/* connected again once the drive answers */
+	n->pending |= 1;
+	probe_start(mgr, n);
+}
+
+/** State polling expiration. */
+static void poll_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	net_mgr_servo_t *s = container_of(t, net_mgr_servo_t, poll);
+	il_servo_t *servo = s->servo;
+
+	if (s->owner->connected && servo->state_subs.stop != 1) {
+		unsigned int cnt;
+		uint32_t mask;
+		uint16_t sw;
+
+		cnt = MIN(servo->subnodes, STATE_SUBS_SUBNODES_MAX);
+		mask = (1u << cnt) - 1;
+
+		/* subnode 1 statusword carried by regular traffic */
+		if (il_net__sw_fresh(s->owner->net,
+				     IL_NET_MGR_STATE_PERIOD_DEF, &sw)) {
+			event_queue(mgr, NET_MGR_EVENT_SW, servo, 1, sw);
+			mask &= ~1u;
+			mgr->stats.skipped++;
+		}
+
+		if (mask) {
+			s->owner->pending |= mask;
+			probe_start(mgr, s->owner);
+		}
+	}
+
+	timer_arm(mgr, t, IL_NET_MGR_STATE_PERIOD_DEF);
+}
+
+/** Emergencies dispatch expiration. */
+static void emcy_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	net_mgr_servo_t *s = container_of(t, net_mgr_servo_t, emcy);
+
+	event_queue(mgr, NET_MGR_EVENT_EMCY, s->servo, 0, 0);
+
+	timer_arm(mgr, t, EMCY_SUBS_TIMEOUT);
+}
+
+/**
+ * Find a managed network.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] net
+ *	Network.
+ *
+ * @return
+ *	Managed network (NULL if not found).
+ */
+static net_mgr_net_t *net_find(il_net_mgr_t *mgr, il_net_t *net)
+{
+	net_mgr_net_t *n;
+
+	for (n = mgr->nets; n; n = n->next) {
+		if (n->net == net)
+			return n;
+	}
+
+	return NULL;
+}
+
+/**
+ * Find a managed servo.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] servo
+ *	Servo.
+ *
+ * @return
+ *	Managed servo (NULL if not found).
+ */
+static net_mgr_servo_t *servo_find(il_net_mgr_t *mgr, il_servo_t *servo)
+{
+	net_mgr_servo_t *s;
+
+	for (s = mgr->servos; s; s = s->next) {
+		if (s->servo == servo)
+			return s;
+	}
+
+	return NULL;
+}
+
+/**
+ * Detach the networks and servos whose removal was requested.
+ *
+ * @note
+ *	This runs on the event loop thread, which is the one holding the
+ *	network lock of ongoing probes.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ */
+static void detach_pending(il_net_mgr_t *mgr)
+{
+	net_mgr_servo_t **ps, *s;
+	net_mgr_net_t **pn, *n;
+	int detached = 0;
+
+	for (ps = &mgr->servos; (s = *ps);) {
+		if (!s->removing && !s->owner->removing) {
+			ps = &s->next;
+			continue;
+		}
+
+		*ps = s->next;
+
+		timer_cancel(mgr, &s->poll);
+		timer_cancel(mgr, &s->emcy);
+
+		/* the servo gets its own monitors back */
+		if (il_servo_base__monitors_start(s->servo) < 0)
+			log_warn("Servo monitors could not be restarted: %s",
+				 ilerr_last());
+
+		il_servo__release(s->servo);
+		free(s);
+
+		detached = 1;
+	}
+
+	for (pn = &mgr->nets; (n = *pn);) {
+		if (!n->removing) {
+			pn = &n->next;
+			continue;
+		}
+
+		*pn = n->next;
+
+		if (n->probing)
+			probe_end(mgr, n);
+
+		timer_cancel(mgr, &n->heartbeat);
+		timer_cancel(mgr, &n->timeout);
+		timer_cancel(mgr, &n->retry);
+		timer_cancel(mgr, &n->reconnect);
+		fd_del(mgr, n);
+
+		(void)il_net__mgr_attach(n->net, 0);
+		il_net__release(n->net);
+		free(n);
+
+		detached = 1;
+	}
+
+	if (detached)
+		osal_cond_broadcast(mgr->cond);
+}
+
+/**
+ * Event loop thread.
+ *
+ * @param [in] args
+ *	Connection manager.
+ */
+static int loop_td(void *args)
+{
+	il_net_mgr_t *mgr = args;
+
+	osal_mutex_lock(mgr->lock);
+
+	while (!mgr->stop) {
+		net_mgr_net_t *ready[NET_MGR_EVENTS_MAX];
+		size_t cnt, i;
+
+		cnt = events_wait(mgr, wheel_timeout(mgr), ready);
+		mgr->stats.wakeups++;
+
+		for (i = 0; i < cnt; i++)
+			probe_complete(mgr, ready[i]);
+
+		detach_pending(mgr);
+		wheel_advance(mgr);
+		events_dispatch(mgr);
+	}
+
+	events_dispatch(mgr);
+	detach_pending(mgr);
+
+	osal_mutex_unlock(mgr->lock);
+
+	return 0;
+}
+
+/**
+ * Close the event loop descriptors.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ */
+static void fds_close(il_net_mgr_t *mgr)
+{
+#ifdef __linux__
+	if (mgr->evfd >= 0)
+		(void)close(mgr->evfd);
+
+	if (mgr->epfd >= 0)
+		(void)close(mgr->epfd);
+#else
+	(void)mgr;
+#endif
+}
+
+/*******************************************************************************
+ * Public
+ ******************************************************************************/
+
+il_net_mgr_t *il_net_mgr_create(void)
+{
+	il_net_mgr_t *mgr;
+
+	mgr = calloc(1, sizeof(*mgr));
+	if (!mgr) {
+		ilerr__set("Connection manager allocation failed");
+		return NULL;
+	}
+
+	mgr->epfd = -1;
+	mgr->evfd = -1;
+	mgr->heartbeat = IL_NET_MGR_HEARTBEAT_DEF;
+
+	(void)osal_clock_gettime(&mgr->epoch);
+
+	mgr->lock = osal_mutex_create();
+	if (!mgr->lock) {
+		ilerr__set("Connection manager lock allocation failed");
+		goto cleanup_mgr;
+	}
+
+	mgr->cond = osal_cond_create();
+	if (!mgr->cond) {
+		ilerr__set("Connection manager condition allocation failed");
+		goto cleanup_lock;
+	}
+
+#ifdef __linux__
+	{
+		struct epoll_event ev;
+
+		mgr->epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (mgr->epfd < 0) {
+			ilerr__set("Event poll creation failed");
+			goto cleanup_fds;
+		}
+
+		mgr->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (mgr->evfd < 0) {
+			ilerr__set("Wake-up descriptor creation failed");
+			goto cleanup_fds;
+		}
+
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = NULL;
+
+		if (epoll_ctl(mgr->epfd, EPOLL_CTL_ADD, mgr->evfd, &ev) < 0) {
+			ilerr__set("Wake-up descriptor registration failed");
+			goto cleanup_fds;
+		}
+	}
+#endif
+
+	mgr->td = osal_thread_create_(loop_td, mgr);
+	if (!mgr->td) {
+		ilerr__set("Connection manager thread creation failed");
+		goto cleanup_fds;
+	}
+
+	return mgr;
+
+cleanup_fds:
+	fds_close(mgr);
+	osal_cond_destroy(mgr->cond);
+
+cleanup_lock:
+	osal_mutex_destroy(mgr->lock);
+
+cleanup_mgr:
+	free(mgr);
+
+	return NULL;
+}
+
+void il_net_mgr_destroy(il_net_mgr_t *mgr)
+{
+	net_mgr_servo_t *s;
+	net_mgr_net_t *n;
+
+	osal_mutex_lock(mgr->lock);
+
+	for (s = mgr->servos; s; s = s->next)
+		s->removing = 1;
+
+	for (n = mgr->nets; n; n = n->next)
+		n->removing = 1;
+
+	mgr->stop = 1;
+	loop_wake(mgr);
+
+	osal_mutex_unlock(mgr->lock);
+
+	(void)osal_thread_join(mgr->td, NULL);
+
+	fds_close(mgr);
+	osal_cond_destroy(mgr->cond);
+	osal_mutex_destroy(mgr->lock);
+
+	free(mgr->events);
+	free(mgr);
+}
+
+int il_net_mgr_heartbeat_set(il_net_mgr_t *mgr, int period)
+{
+	net_mgr_net_t *n;
+
+	if (period < 0) {
+		ilerr__set("Invalid heartbeat period");
+		return IL_EINVAL;
+	}
+
+	osal_mutex_lock(mgr->lock);
+
+	mgr->heartbeat = period;
+
+	for (n = mgr->nets; n; n = n->next) {
+		if (period > 0)
+			timer_arm(mgr, &n->heartbeat, period);
+		else
+			timer_cancel(mgr, &n->heartbeat);
+	}
+
+	loop_wake(mgr);
+
+	osal_mutex_unlock(mgr->lock);
+
+	return 0;
+}
+
+int il_net_mgr_net_add(il_net_mgr_t *mgr, il_net_t *net)
+{
+	net_mgr_net_t *n;
+	int r;
+
+	r = il_net__mgr_fd(net);
+	if (r < 0)
+		return r;
+
+	osal_mutex_lock(mgr->lock);
+	n = net_find(mgr, net);
+	osal_mutex_unlock(mgr->lock);
+
+	if (n) {
+		ilerr__set("Network already managed");
+		return IL_EALREADY;
+	}
+
+	n = calloc(1, sizeof(*n));
+	if (!n) {
+		ilerr__set("Managed network allocation failed");
+		return IL_ENOMEM;
+	}
+
+	n->net = net;
+	n->heartbeat.fire = heartbeat_expired;
+	n->timeout.fire = timeout_expired;
+	n->retry.fire = retry_expired;
+	n->reconnect.fire = reconnect_expired;
+
+	/* stop the network listener (may take a while) */
+	r = il_net__mgr_attach(net, 1);
+	if (r < 0)
+		goto cleanup_n;
+
+	il_net__retain(net);
+
+	osal_mutex_lock(mgr->lock);
+
+	n->fd = il_net__mgr_fd(net);
+	n->connected = il_net_state_get(net) == IL_NET_STATE_CONNECTED;
+	fd_add(mgr, n);
+
+	n->next = mgr->nets;
+	mgr->nets = n;
+
+	if (mgr->heartbeat > 0)
+		timer_arm(mgr, &n->heartbeat, mgr->heartbeat);
+
+	if (!n->connected)
+		timer_arm(mgr, &n->reconnect, 0);
+
+	loop_wake(mgr);
+
+	osal_mutex_unlock(mgr->lock);
+
+	return 0;
+
+cleanup_n:
+	free(n);
+
+	return r;
+}
+
+void il_net_mgr_net_remove(il_net_mgr_t *mgr, il_net_t *net)
+{
+	net_mgr_net_t *n;
+
+	osal_mutex_lock(mgr->lock);
+
+	n = net_find(mgr, net);
+	if (n) {
+		n->removing = 1;
+		loop_wake(mgr);
+
+		while (net_find(mgr, net))
+			(void)osal_cond_wait(mgr->cond, mgr->lock, 0);
+	}
+
+	osal_mutex_unlock(mgr->lock);
+}
+
+int il_net_mgr_servo_add(il_net_mgr_t *mgr, il_servo_t *servo)
+{
+	net_mgr_servo_t *s;
+	int r = 0;
+
+	osal_mutex_lock(mgr->lock);
+
+	if (!net_find(mgr, servo->net)) {
+		ilerr__set("Servo network is not managed");
+		r = IL_EINVAL;
+	} else if (servo_find(mgr, servo)) {
+		ilerr__set("Servo already managed");
+		r = IL_EALREADY;
+	}
+
+	osal_mutex_unlock(mgr->lock);
+
+	if (r < 0)
+		return r;
+
+	s = calloc(1, sizeof(*s));
+	if (!s) {
+		ilerr__set("Managed servo allocation failed");
+		return IL_ENOMEM;
+	}
+
+	s->servo = servo;
+	s->poll.fire = poll_expired;
+	s->emcy.fire = emcy_expired;
+
+	/* the manager takes over the servo monitors */
+	il_servo_base__monitors_stop(servo);
+	il_servo__retain(servo);
+
+	osal_mutex_lock(mgr->lock);
+
+	/* the network may have been removed, or the servo added, meanwhile */
+	s->owner = net_find(mgr, servo->net);
+	if (!s->owner || s->owner->removing)
+		r = IL_EINVAL;
+	else if (servo_find(mgr, servo))
+		r = IL_EALREADY;
+
+	if (r < 0) {
+		osal_mutex_unlock(mgr->lock);
+
+		/* the servo gets its own monitors back, unless added meanwhile */
+		if (r == IL_EINVAL &&
+		    il_servo_base__monitors_start(servo) < 0)
+			log_warn("Servo monitors could not be restarted: %s",
+				 ilerr_last());
+
+		il_servo__release(servo);
+		free(s);
+
+		if (r == IL_EINVAL)
+			ilerr__set("Servo network is not managed");
+		else
+			ilerr__set("Servo already managed");
+
+		return r;
+	}
+
+	s->next = mgr->servos;
+	mgr->servos = s;
+
+	timer_arm(mgr, &s->poll, IL_NET_MGR_STATE_PERIOD_DEF);
+	timer_arm(mgr, &s->emcy, EMCY_SUBS_TIMEOUT);
+
+	loop_wake(mgr);
+
+	osal_mutex_unlock(mgr->lock);
+
+	return 0;
+}
+
+void il_net_mgr_servo_remove(il_net_mgr_t *mgr, il_servo_t *servo)
+{
+	net_mgr_servo_t *s;
+
+	osal_mutex_lock(mgr->lock);
+
+	s = servo_find(mgr, servo);
+	if (s) {
+		s->removing = 1;
+		loop_wake(mgr);
+
+		while (servo_find(mgr, servo))
+			(void)osal_cond_wait(mgr->cond, mgr->lock, 0);
+	}
+
+	osal_mutex_unlock(mgr->lock);
+}
+
+void il_net_mgr_stats_get(il_net_mgr_t *mgr, il_net_mgr_stats_t *stats)
+{
+	net_mgr_servo_t *s;
+	net_mgr_net_t *n;
+
+	osal_mutex_lock(mgr->lock);
+
+	*stats = mgr->stats;
+
+	stats->nets = 0;
+	for (n = mgr->nets; n; n = n->next)
+		stats->nets++;
+
+	stats->servos = 0;
+	for (s = mgr->servos; s; s = s->next)
+		stats->servos++;
+
+	osal_mutex_unlock(mgr->lock);
+}
@@ -0,0 +1,154 @@
+#ifndef NET_MGR_H_
+#define NET_MGR_H_
+
+#include "public/ingenialink/net_mgr.h"
+
+#include "ingenialink/utils.h"
+
+#include "osal/osal.h"
+
+/** Timer wheel size (slots, power of 2). */
+#define NET_MGR_WHEEL_SZ	256
+
+/** Timer wheel resolution (ms). */
+#define NET_MGR_TICK_MS		5
+
+/** Statusword probe timeout (ms). */
+#define NET_MGR_PROBE_TIMEOUT	100
+
+/** Consecutive failed probes before a network is considered lost. */
+#define NET_MGR_ERRORS_MAX	3
+
+/** Maximum wait when the event loop can not be woken up (ms). */
+#define NET_MGR_POLL_MAX	50
+
+/** Maximum number of events served per wake-up. */
+#define NET_MGR_EVENTS_MAX	32
+
+typedef struct net_mgr_timer net_mgr_timer_t;
+
+/**
+ * Timer expiration callback.
+ *
+ * @param [in] mgr
+ *	Connection manager.
+ * @param [in] t
+ *	Expired timer (already disarmed, so it can be armed again).
+ */
+typedef void (*net_mgr_timer_cb_t)(il_net_mgr_t *mgr, net_mgr_timer_t *t);
+
+/** Timer wheel entry. */
+struct net_mgr_timer {
+	/** Next timer in the slot. */
+	net_mgr_timer_t *next;
+	/** Link to this timer (NULL if not armed). */
+	net_mgr_timer_t **pprev;
+	/** Expiration (ticks). */
+	uint64_t expires;
+	/** Expiration callback. */
+	net_mgr_timer_cb_t fire;
+};
+
+/** Managed network. */
+typedef struct net_mgr_net {
+	/** Next network. */
+	struct net_mgr_net *next;
+	/** Network. */
+	il_net_t *net;
+	/** Polled socket. */
+	int fd;
+	/** Subnodes waiting to be probed (bit n - 1 for subnode n). */
+	uint32_t pending;
+	/** Subnode being probed (0 if none, net.lock is held meanwhile). */
+	uint8_t probing;
+	/** Consecutive failed probes. */
+	int errors;
+	/** Connected flag. */
+	int connected;
+	/** Removal requested flag. */
+	int removing;
+	/** Heartbeat timer. */
+	net_mgr_timer_t heartbeat;
+	/** Probe timeout timer. */
+	net_mgr_timer_t timeout;
+	/** Probe retry timer (network busy). */
+	net_mgr_timer_t retry;
+	/** Reconnection timer. */
+	net_mgr_timer_t reconnect;
+} net_mgr_net_t;
+
+/** Managed servo. */
+typedef struct net_mgr_servo {
+	/** Next servo. */
+	struct net_mgr_servo *next;
+	/** Servo. */
+	il_servo_t *servo;
+	/** Network the servo belongs to. */
+	net_mgr_net_t *owner;
+	/** Removal requested flag. */
+	int removing;
+	/** State polling timer. */
+	net_mgr_timer_t poll;
+	/** Emergencies dispatch timer. */
+	net_mgr_timer_t emcy;
+} net_mgr_servo_t;
+
+/** Deferred notification types. */
+typedef enum {
+	/** Statusword (state subscribers). */
+	NET_MGR_EVENT_SW,
+	/** Emergencies (emergency subscribers). */
+	NET_MGR_EVENT_EMCY,
+} net_mgr_event_type_t;
+
+/** Deferred notification (subscribers are notified without the lock). */
+typedef struct {
+	/** Type. */
+	net_mgr_event_type_t type;
+	/** Servo (retained until notified). */
+	il_servo_t *servo;
+	/** Subnode (statusword). */
+	uint8_t subnode;
+	/** Statusword. */
+	uint16_t sw;
+} net_mgr_event_t;
+
+/** IngeniaLink connection manager. */
+struct il_net_mgr {
+	/** Timer wheel. */
+	net_mgr_timer_t *wheel[NET_MGR_WHEEL_SZ];
+	/** Current tick. */
+	uint64_t tick;
+	/** Number of armed timers. */
+	size_t armed;
+	/** Time reference. */
+	osal_timespec_t epoch;
+	/** Networks. */
+	net_mgr_net_t *nets;
+	/** Servos. */
+	net_mgr_servo_t *servos;
+	/** Heartbeat period (ms). */
+	int heartbeat;
+	/** Event poll descriptor (-1 if not available). */
+	int epfd;
+	/** Wake-up descriptor (-1 if not available). */
+	int evfd;
+	/** Statistics. */
+	il_net_mgr_stats_t stats;
+	/** Deferred notifications (event loop thread only). */
+	net_mgr_event_t *events;
+	/** Number of deferred notifications. */
+	size_t events_cnt;
+	/** Deferred notifications capacity. */
+	size_t events_cap;
+	/** Lock (everything above, except deferred notifications). */
+	osal_mutex_t *lock;
+	/** Condition (loop wake-up, detach completion). */
+	osal_cond_t *cond;
+	/** Event loop thread. */
+	osal_thread_t *td;
+	/** Stop flag. */
+	int stop;
+};
+
+#endif
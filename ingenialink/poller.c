@@ -1,5 +1,6 @@
 #include "poller.h"
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -10,57 +11,211 @@
  * Private
  ******************************************************************************/
 
+/**
+ * Advance a timespec.
+ *
+ * @param [in, out] ts
+ *	Timespec.
+ * @param [in] ns
+ *	Nanoseconds (may be negative).
+ */
+static void ts_add(osal_timespec_t *ts, long long ns)
+{
+	long long t;
+
+	t = (long long)ts->ns + ns % OSAL_CLOCK_NANOSPERSEC;
+	ts->s += (long)(ns / OSAL_CLOCK_NANOSPERSEC);
+
+	if (t >= OSAL_CLOCK_NANOSPERSEC) {
+		ts->s++;
+		t -= OSAL_CLOCK_NANOSPERSEC;
+	} else if (t < 0) {
+		ts->s--;
+		t += OSAL_CLOCK_NANOSPERSEC;
+	}
+
+	ts->ns = (long)t;
+}
+
+/**
+ * Wait until a sampling deadline (sleep, then spin for the last part if a
+ * spin window is set).
+ *
+ * @param [in] poller
+ *	Poller.
+ * @param [in] deadline
+ *	Deadline.
+ */
+static void deadline_wait(il_poller_t *poller, const osal_timespec_t *deadline)
+{
+	long long spin = (long long)poller->spin;
+
+	if (spin == 0) {
+		osal_clock_sleep_until(deadline);
+		return;
+	}
+
+	if (osal_clock_deadline_left(deadline) > spin) {
+		osal_timespec_t wake = *deadline;
+
+		ts_add(&wake, -spin);
+		osal_clock_sleep_until(&wake);
+	}
+
+	while (osal_clock_deadline_left(deadline) > 0)
+		;
+}
+
+/**
+ * Schedule the next sampling deadline, applying the overrun policy.
+ *
+ * @param [in] poller
+ *	Poller.
+ * @param [in, out] next
+ *	Next deadline (advanced by one period on entry).
+ *
+ * @return
+ *	Number of deadlines missed.
+ */
+static uint64_t deadline_next(il_poller_t *poller, osal_timespec_t *next)
+{
+	long long period = (long long)poller->period;
+	long long late;
+	uint64_t passed;
+
+	ts_add(next, period);
+
+	late = -osal_clock_deadline_left(next);
+	if (late < 0)
+		return 0;
+
+	/* deadlines already passed, including next */
+	passed = (uint64_t)(late / period) + 1;
+
+	switch (poller->overrun) {
+	case IL_POLLER_OVERRUN_CATCH_UP:
+		if (passed <= POLLER_CATCH_UP_MAX)
+			return 0;
+
+		ts_add(next, (long long)(passed - POLLER_CATCH_UP_MAX) * period);
+		return passed - POLLER_CATCH_UP_MAX;
+	case IL_POLLER_OVERRUN_STRETCH:
+		(void)osal_clock_gettime(next);
+		return passed - 1;
+	case IL_POLLER_OVERRUN_SKIP:
+	default:
+		ts_add(next, (long long)passed * period);
+		return passed;
+	}
+}
+
+/**
+ * Store a sample on the current acquisition (double buffering).
+ *
+ * @param [in] poller
+ *	Poller.
+ * @param [in] t
+ *	Sample time.
+ * @param [in] r
+ *	Acquisition result.
+ * @param [in] missed
+ *	Deadlines missed before the sample.
+ */
+static void sample_store(il_poller_t *poller, double t, int r, uint64_t missed)
+{
+	il_poller_acq_t *acq;
+	size_t i;
+
+	osal_mutex_lock(poller->lock);
+
+	acq = &poller->acq[poller->acq_curr];
+	acq->missed += missed;
+
+	if (acq->cnt >= poller->sz) {
+		acq->lost = 1;
+	} else if (r == 0) {
+		acq->t[acq->cnt] = t;
+
+		for (i = 0; i < poller->n_accs; i++)
+			acq->d[poller->accs_ch[i]][acq->cnt] =
+				poller->accs[i].val;
+
+		acq->cnt++;
+	}
+
+	osal_mutex_unlock(poller->lock);
+}
+
+/**
+ * Push a sample record to the ring.
+ *
+ * @note
+ *	The ring is lock-free, the lock only guards the statistics.
+ *
+ * @param [in] poller
+ *	Poller.
+ * @param [in] t
+ *	Sample time.
+ * @param [in] r
+ *	Acquisition result.
+ * @param [in] missed
+ *	Deadlines missed before the sample.
+ */
+static void sample_push(il_poller_t *poller, double t, int r, uint64_t missed)
+{
+	size_t i;
+
+	if (r == 0) {
+		poller->rec[0] = t;
+
+		for (i = 0; i < poller->n_accs; i++)
+			poller->rec[1 + poller->accs_ch[i]] =
+				poller->accs[i].val;
+
+		(void)il_utils__ring_push(poller->ring, poller->rec, 1);
+	}
+
+	osal_mutex_lock(poller->lock);
+
+	if (r == 0)
+		poller->stats.samples++;
+	else
+		poller->stats.errors++;
+
+	poller->stats.missed += missed;
+
+	osal_mutex_unlock(poller->lock);
+}
+
 int poller_td(void *args)
 {
 	il_poller_t *poller = args;
-	osal_timespec_t curr;
+	osal_timespec_t curr, next;
+	uint64_t missed = 0;
+
+	(void)osal_clock_gettime(&next);
 
 	while (!poller->stop) {
-		il_poller_acq_t *acq;
 		double t;
-		int r, acq_fail = 0;
-
+		int r;
 
-		/* wait until next period */
-		osal_timer_wait(poller->timer);
+		/* wait until next deadline */
+		deadline_wait(poller, &next);
 
 		/* obtain current time */
 		osal_clock_perf_get(poller->perf, &curr);
 		t = (double)curr.s + (double)curr.ns / 1000000000.;
 
-		/* acquire all configured channels */
-		osal_mutex_lock(poller->lock);
-
-		acq = &poller->acq[poller->acq_curr];
-
-		if (acq->cnt >= poller->sz) {
-			acq->lost = 1;
-		} else {
-			size_t ch;
+		/* acquire all configured channels in a single batch */
+		r = il_servo_read_many(poller->servo, poller->accs,
+				       poller->n_accs);
 
-			acq->t[acq->cnt] = t;
+		if (poller->ring)
+			sample_push(poller, t, r, missed);
+		else
+			sample_store(poller, t, r, missed);
 
-			for (ch = 0; ch < poller->n_ch; ch++) {
-				if (!poller->mappings_valid[ch])
-					continue;
-
-				r = il_servo_read(poller->servo,
-						    &poller->mappings[ch],
-						    NULL,
-						    &acq->d[ch][acq->cnt]);
-				if (r < 0)
-				{
-					acq_fail = 1;
-				}
-			}
-
-			if (acq_fail != 1)
-			{
-				acq->cnt++;
-			}
-		}
-
-		osal_mutex_unlock(poller->lock);
+		missed = deadline_next(poller, &next);
 	}
 
 	return 0;
@@ -84,16 +239,12 @@ il_poller_t *il_poller_create(il_servo_t *servo, size_t n_ch)
 	il_servo__retain(poller->servo);
 	poller->n_ch = n_ch;
 
-	poller->timer = osal_timer_create();
-	if (!poller->timer) {
-		ilerr__set("Poller timer allocation failed");
-		goto cleanup_poller;
-	}
+	poller->overrun = IL_POLLER_OVERRUN_SKIP;
 
 	poller->perf = osal_clock_perf_create();
 	if (!poller->perf) {
 		ilerr__set("Poller performance counter allocation failed");
-		goto cleanup_timer;
+		goto cleanup_poller;
 	}
 
 	poller->lock = osal_mutex_create();
@@ -114,10 +265,28 @@ il_poller_t *il_poller_create(il_servo_t *servo, size_t n_ch)
 		goto cleanup_mappings;
 	}
 
+	poller->accs = calloc(n_ch, sizeof(*poller->accs));
+	if (!poller->accs) {
+		ilerr__set("Poller accesses allocation failed");
+		goto cleanup_mappings_valid;
+	}
+
+	poller->accs_ch = calloc(n_ch, sizeof(*poller->accs_ch));
+	if (!poller->accs_ch) {
+		ilerr__set("Poller accesses allocation failed");
+		goto cleanup_accs;
+	}
+
+	poller->rec = calloc(n_ch + 1, sizeof(*poller->rec));
+	if (!poller->rec) {
+		ilerr__set("Poller record allocation failed");
+		goto cleanup_accs_ch;
+	}
+
 	poller->acq[0].d = calloc(n_ch, sizeof(*poller->acq[0].d));
 	if (!poller->acq[0].d) {
 		ilerr__set("Poller acquisition data allocation failed");
-		goto cleanup_mappings_valid;
+		goto cleanup_rec;
 	}
 
 	poller->acq[1].d = calloc(n_ch, sizeof(*poller->acq[1].d));
@@ -131,6 +300,15 @@ il_poller_t *il_poller_create(il_servo_t *servo, size_t n_ch)
 cleanup_acq_d_0:
 	free(poller->acq[0].d);
 
+cleanup_rec:
+	free(poller->rec);
+
+cleanup_accs_ch:
+	free(poller->accs_ch);
+
+cleanup_accs:
+	free(poller->accs);
+
 cleanup_mappings_valid:
 	free(poller->mappings_valid);
 
@@ -143,9 +321,6 @@ cleanup_lock:
 cleanup_perf:
 	osal_clock_perf_destroy(poller->perf);
 
-cleanup_timer:
-	osal_timer_destroy(poller->timer);
-
 cleanup_poller:
 	il_servo__release(poller->servo);
 	free(poller);
@@ -176,13 +351,19 @@ void il_poller_destroy(il_poller_t *poller)
 	free(poller->acq[1].d);
 	free(poller->acq[0].d);
 
+	if (poller->ring)
+		il_utils__ring_destroy(poller->ring);
+
+	free(poller->rec);
+	free(poller->accs_ch);
+	free(poller->accs);
+
 	free(poller->mappings);
 	free(poller->mappings_valid);
 
 	osal_mutex_destroy(poller->lock);
 
 	osal_clock_perf_destroy(poller->perf);
-	osal_timer_destroy(poller->timer);
 
 	il_servo__release(poller->servo);
 
@@ -191,26 +372,49 @@ void il_poller_destroy(il_poller_t *poller)
 
 int il_poller_start(il_poller_t *poller)
 {
+	size_t ch;
+
 	if (poller->running) {
 		ilerr__set("Poller already running");
 		return IL_EALREADY;
 	}
 
-	/* activate timer, reset performance counter */
-	if (osal_timer_set(poller->timer,
-			   poller->t_s * OSAL_TIMER_NANOSPERMSEC) < 0) {
-		ilerr__set("Timer activation failed");
-		return IL_EFAIL;
+	/* build the per-sample batch from the valid channels */
+	poller->n_accs = 0;
+	for (ch = 0; ch < poller->n_ch; ch++) {
+		il_servo_access_t *acc = &poller->accs[poller->n_accs];
+
+		if (!poller->mappings_valid[ch])
+			continue;
+
+		acc->reg = &poller->mappings[ch];
+		acc->id = NULL;
+		acc->subnode = poller->mappings[ch].subnode;
+
+		poller->accs_ch[poller->n_accs++] = ch;
 	}
 
+	if (poller->period == 0) {
+		ilerr__set("Poller not configured");
+		return IL_ESTATE;
+	}
+
+	/* reset performance counter */
 	if (osal_clock_perf_reset(poller->perf) < 0) {
 		ilerr__set("Performance counter reset failed");
 		return IL_EFAIL;
 	}
 
+	/* statistics start from zero (the ring is kept, so that consumers
+	 * never see it replaced) */
+	poller->dropped_base = poller->ring ?
+			       il_utils__ring_dropped(poller->ring) : 0;
+	memset(&poller->stats, 0, sizeof(poller->stats));
+
 	/* start polling thread */
 	poller->acq[poller->acq_curr].cnt = 0;
 	poller->acq[poller->acq_curr].lost = 0;
+	poller->acq[poller->acq_curr].missed = 0;
 
 	poller->stop = 0;
 
@@ -245,11 +449,19 @@ void il_poller_data_get(il_poller_t *poller, il_poller_acq_t **acq)
 	poller->acq_curr = poller->acq_curr ? 0 : 1;
 	poller->acq[poller->acq_curr].cnt = 0;
 	poller->acq[poller->acq_curr].lost = 0;
+	poller->acq[poller->acq_curr].missed = 0;
 
 	osal_mutex_unlock(poller->lock);
 }
 
 int il_poller_configure(il_poller_t *poller, unsigned int t_s, size_t sz)
+{
+	return il_poller_configure_ns(poller,
+				      (uint64_t)t_s * OSAL_CLOCK_NANOSPERMSEC,
+				      sz);
+}
+
+int il_poller_configure_ns(il_poller_t *poller, uint64_t period, size_t sz)
 {
 	int i;
 
@@ -258,6 +470,11 @@ int il_poller_configure(il_poller_t *poller, unsigned int t_s, size_t sz)
 		return IL_ESTATE;
 	}
 
+	if (period == 0 || period > (uint64_t)LLONG_MAX) {
+		ilerr__set("Invalid sampling period");
+		return IL_EINVAL;
+	}
+
 	for (i = 0; i < 2; i++) {
 		size_t ch;
 		il_poller_acq_t *acq = &poller->acq[i];
@@ -278,12 +495,51 @@ int il_poller_configure(il_poller_t *poller, unsigned int t_s, size_t sz)
 		}
 	}
 
-	poller->t_s = t_s;
+	poller->period = period;
 	poller->sz = sz;
 
 	return 0;
 }
 
+int il_poller_overrun_set(il_poller_t *poller, il_poller_overrun_t overrun)
+{
+	if (poller->running) {
+		ilerr__set("Poller is running");
+		return IL_ESTATE;
+	}
+
+	switch (overrun) {
+	case IL_POLLER_OVERRUN_SKIP:
+	case IL_POLLER_OVERRUN_CATCH_UP:
+	case IL_POLLER_OVERRUN_STRETCH:
+		break;
+	default:
+		ilerr__set("Invalid overrun policy");
+		return IL_EINVAL;
+	}
+
+	poller->overrun = overrun;
+
+	return 0;
+}
+
+int il_poller_spin_set(il_poller_t *poller, uint64_t spin)
+{
+	if (poller->running) {
+		ilerr__set("Poller is running");
+		return IL_ESTATE;
+	}
+
+	if (spin > (uint64_t)LLONG_MAX) {
+		ilerr__set("Invalid spin window");
+		return IL_EINVAL;
+	}
+
+	poller->spin = spin;
+
+	return 0;
+}
+
 int il_poller_ch_configure(il_poller_t *poller, unsigned int ch,
 			   const il_reg_t *reg, const char *id)
 {
@@ -356,3 +612,83 @@ int il_poller_ch_disable_all(il_poller_t *poller)
 	return 0;
 }
 
+
+int il_poller_ring_configure(il_poller_t *poller, size_t cap)
+{
+	il_utils_ring_t *ring = NULL;
+
+	if (poller->running) {
+		ilerr__set("Poller is running");
+		return IL_ESTATE;
+	}
+
+	if (cap > 0x80000000U) {
+		ilerr__set("Invalid ring capacity");
+		return IL_EINVAL;
+	}
+
+	if (cap > 0) {
+		ring = il_utils__ring_create(
+			(poller->n_ch + 1) * sizeof(*poller->rec), cap);
+		if (!ring)
+			return IL_ENOMEM;
+	}
+
+	osal_mutex_lock(poller->lock);
+
+	if (poller->ring)
+		il_utils__ring_destroy(poller->ring);
+
+	poller->ring = ring;
+	poller->dropped_base = 0;
+
+	osal_mutex_unlock(poller->lock);
+
+	return 0;
+}
+
+size_t il_poller_ring_peek(il_poller_t *poller, const double **samples)
+{
+	void *elems;
+	size_t cnt;
+
+	if (!poller->ring) {
+		*samples = NULL;
+		return 0;
+	}
+
+	cnt = il_utils__ring_peek(poller->ring, &elems);
+	*samples = elems;
+
+	return cnt;
+}
+
+void il_poller_ring_consume(il_poller_t *poller, size_t n)
+{
+	if (!poller->ring)
+		return;
+
+	/* never release records not yet produced */
+	n = MIN(n, il_utils__ring_cnt(poller->ring));
+
+	il_utils__ring_consume(poller->ring, n);
+}
+
+size_t il_poller_ring_available(il_poller_t *poller)
+{
+	if (!poller->ring)
+		return 0;
+
+	return il_utils__ring_cnt(poller->ring);
+}
+
+void il_poller_ring_stats_get(il_poller_t *poller,
+			      il_poller_ring_stats_t *stats)
+{
+	osal_mutex_lock(poller->lock);
+	*stats = poller->stats;
+	osal_mutex_unlock(poller->lock);
+
+	stats->dropped = poller->ring ? il_utils__ring_dropped(poller->ring) -
+					poller->dropped_base : 0;
+}
@@ -3,11 +3,16 @@
 
 #include "public/ingenialink/poller.h"
 
+#include "ingenialink/utils.h"
+
 #include "osal/osal.h"
 
 
 #define DEFAULT_SUBNODE_VALUE 0
 
+/** Maximum number of late samples taken back to back (catch up policy). */
+#define POLLER_CATCH_UP_MAX 16
+
 /** IngeniaLink register poller. */
 struct il_poller {
 	/** Associated servo. */
@@ -18,16 +23,32 @@ struct il_poller {
 	il_reg_t *mappings;
 	/** Mappings validity. */
 	int *mappings_valid;
+	/** Batched accesses (valid channels, built on start). */
+	il_servo_access_t *accs;
+	/** Channel of each batched access. */
+	size_t *accs_ch;
+	/** Number of batched accesses. */
+	size_t n_accs;
+	/** Sample record scratch (time, then channels). */
+	double *rec;
+	/** Ring of sample records (NULL to use double buffering). */
+	il_utils_ring_t *ring;
+	/** Ring statistics (except dropped, kept by the ring). */
+	il_poller_ring_stats_t stats;
+	/** Ring drops before the last start. */
+	uint64_t dropped_base;
 	/** Acquisition (uses double buffering mechanism). */
 	il_poller_acq_t acq[2];
 	/** Current acquisition. */
 	int acq_curr;
-	/** Sampling period (ms). */
-	int t_s;
+	/** Sampling period (ns). */
+	uint64_t period;
+	/** Spin window (ns). */
+	uint64_t spin;
+	/** Overrun policy. */
+	il_poller_overrun_t overrun;
 	/** Buffer size. */
 	size_t sz;
-	/** Timer. */
-	osal_timer_t *timer;
 	/** Performance counter. */
 	osal_clock_perf_t *perf;
 	/** Lock. */
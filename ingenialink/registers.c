@@ -0,0 +1,30 @@
+#include "ingenialink/registers.h"
+
+/*******************************************************************************
+ * Internal
+ ******************************************************************************/
+
+size_t il_reg__dtype_sz(il_reg_dtype_t dtype)
+{
+	switch (dtype) {
+	case IL_REG_DTYPE_U8:
+	case IL_REG_DTYPE_S8:
+		return sizeof(uint8_t);
+	case IL_REG_DTYPE_U16:
+	case IL_REG_DTYPE_S16:
+		return sizeof(uint16_t);
+	case IL_REG_DTYPE_U32:
+	case IL_REG_DTYPE_S32:
+	case IL_REG_DTYPE_STR:
+		return sizeof(uint32_t);
+	case IL_REG_DTYPE_FLOAT:
+		return sizeof(float);
+	case IL_REG_DTYPE_U64:
+	case IL_REG_DTYPE_S64:
+		return sizeof(uint64_t);
+	case IL_REG_DTYPE_FLOAT64:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
@@ -3,6 +3,7 @@
 #include "ingenialink/err.h"
 #include "external/log.c/src/log.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <signal.h>
@@ -73,6 +74,13 @@ void il_servo_state_unsubscribe(il_servo_t *servo, int slot)
 	servo->ops->state_unsubscribe(servo, slot);
 }
 
+void il_servo_sw_poll_set(il_servo_t *servo, int period)
+{
+	osal_mutex_lock(servo->sw.lock);
+	servo->sw.poll = period;
+	osal_mutex_unlock(servo->sw.lock);
+}
+
 int il_servo_emcy_subscribe(il_servo_t *servo, il_servo_emcy_subscriber_cb_t cb,
 			    void *ctx)
 {
@@ -105,182 +113,81 @@ int il_servo_dict_load(il_servo_t *servo, const char *dict)
 
 int il_servo_dict_storage_read(il_servo_t *servo)
 {
-	int r = 0;
-	const char **ids;
-
-	if (!servo->dict) {
-		ilerr__set("No dictionary loaded");
-		return IL_EFAIL;
-	}
-
-	// Subnodes = axis available at servo + 1 subnode of general parameters
-	int subnodes = servo->subnodes + 1;
-	for (int j = 0; j < subnodes; j++) {
-		ids = il_dict_reg_ids_get(servo->dict, j);
-		if (!ids)
-			return IL_EFAIL;
+	return il_servo_base__dict_storage_read(servo, NULL, NULL);
+}
 
-		for (size_t i = 0; ids[i]; i++) {
-			const il_reg_t *reg;
-			il_reg_value_t storage;
-			(void)il_dict_reg_get(servo->dict, ids[i], &reg, j);
-
-			if (reg->access != IL_REG_ACCESS_RW)
-				continue;
-
-			switch (reg->dtype) {
-			case IL_REG_DTYPE_U8:
-				r = il_servo_raw_read_u8(servo, reg, ids[i],
-							&storage.u8);
-				break;
-			case IL_REG_DTYPE_S8:
-				r = il_servo_raw_read_s8(servo, reg, ids[i],
-							&storage.s8);
-				break;
-			case IL_REG_DTYPE_U16:
-				r = il_servo_raw_read_u16(servo, reg, ids[i],
-							&storage.u16);
-				break;
-			case IL_REG_DTYPE_S16:
-				r = il_servo_raw_read_s16(servo, reg, ids[i],
-							&storage.s16);
-				break;
-			case IL_REG_DTYPE_U32:
-				r = il_servo_raw_read_u32(servo, reg, ids[i],
-							&storage.u32);
-				break;
-			case IL_REG_DTYPE_STR:
-				r = il_servo_raw_read_str(servo, reg, ids[i],
-							&storage.u32);
-				break;
-			case IL_REG_DTYPE_S32:
-				r = il_servo_raw_read_s32(servo, reg, ids[i],
-							&storage.s32);
-				break;
-			case IL_REG_DTYPE_U64:
-				r = il_servo_raw_read_u64(servo, reg, ids[i],
-							&storage.u64);
-				break;
-			case IL_REG_DTYPE_S64:
-				r = il_servo_raw_read_s64(servo, reg, ids[i],
-							&storage.s64);
-				break;
-			case IL_REG_DTYPE_FLOAT:
-				r = il_servo_raw_read_float(servo, reg, ids[i],
-								&storage.flt);
-				break;
-			default:
-				continue;
-			}
+int il_servo_dict_storage_read_progress(il_servo_t *servo,
+					il_servo_progress_cb_t cb, void *ctx)
+{
+	return il_servo_base__dict_storage_read(servo, cb, ctx);
+}
 
-			if (r < 0)
-				continue;
+int il_servo_dict_storage_write(il_servo_t *servo, const char *dict_path, int subnode)
+{
+	int r;
+	il_dict_t *dict;
 
-			(void)il_dict_reg_storage_update(servo->dict, ids[i], storage, j);
-		}
+	dict = il_dict_create(dict_path);
+	if (!dict) {
+		log_error("Could not load the configuration");
+		return IL_EFAIL;
 	}
 
-cleanup_ids:
-	il_dict_reg_ids_destroy(ids);
+	r = il_servo_base__dict_storage_restore(servo, dict, subnode, NULL);
 
+	il_dict_destroy(dict);
 
 	return r;
 }
 
-int il_servo_dict_storage_write(il_servo_t *servo, const char *dict_path, int subnode)
+int il_servo_dict_storage_restore(il_servo_t *servo, il_dict_t *cfg,
+				  int subnode,
+				  il_servo_restore_report_t **report)
 {
-	int r = -1;
-	int all_subnodes = -1;
-	const char **ids = NULL;
-	size_t i;
-	int src_subnode;
+	return il_servo_base__dict_storage_restore(servo, cfg, subnode, report);
+}
 
-	il_dict_t *dict = il_dict_create(dict_path);
-	if (!dict)
-		return IL_EFAIL;
-	// Subnodes = axis available at servo + 1 subnode of general parameters
-	int subnodes = servo->subnodes + 1;
-	if (subnode != all_subnodes){
-		src_subnode = il_servo_dict_get_subnode(servo, dict, subnode);
-	}
-	for (int j = 0; j < subnodes; j++) {
-		if (subnode == all_subnodes || j == subnode) {
-			if (subnode == all_subnodes){
-				src_subnode = j;
-			}
-			ids = il_dict_reg_ids_get(dict, src_subnode);
-			if (!ids)
-				return IL_EFAIL;
+void il_servo_restore_report_destroy(il_servo_restore_report_t *report)
+{
+	free(report->entries);
+	free(report);
+}
 
-			if (ids[0] != NULL) {
-				log_debug("Loading subnode %i...", j);
-			}
+il_reg_handle_t *il_reg_handle_create(il_servo_t *servo, const il_reg_t *reg,
+				      const char *id, uint8_t subnode)
+{
+	return il_servo_base__reg_handle_create(servo, reg, id, subnode);
+}
 
-			for (size_t i = 0; ids[i]; i++) {
-				il_reg_t *reg;
-				(void)il_dict_reg_get(dict, ids[i], &reg, src_subnode);
-				reg->subnode = j;
-				if (reg->access != IL_REG_ACCESS_RW)
-					continue;
-
-				switch (reg->dtype) {
-				case IL_REG_DTYPE_U8:
-					r = il_servo_raw_write_u8(servo, reg, ids[i],
-						reg->storage.u8, 1, 0);
-					break;
-				case IL_REG_DTYPE_S8:
-					r = il_servo_raw_write_s8(servo, reg, ids[i],
-						reg->storage.s8, 1, 0);
-					break;
-				case IL_REG_DTYPE_U16:
-					r = il_servo_raw_write_u16(servo, reg, ids[i],
-						reg->storage.u16, 1, 0);
-					break;
-				case IL_REG_DTYPE_S16:
-					r = il_servo_raw_write_s16(servo, reg, ids[i],
-						reg->storage.s16, 1, 0);
-					break;
-				case IL_REG_DTYPE_U32:
-					r = il_servo_raw_write_u32(servo, reg, ids[i],
-						reg->storage.u32, 1, 0);
-					break;
-				case IL_REG_DTYPE_S32:
-					r = il_servo_raw_write_s32(servo, reg, ids[i],
-						reg->storage.s32, 1, 0);
-					break;
-				case IL_REG_DTYPE_U64:
-					r = il_servo_raw_write_u64(servo, reg, ids[i],
-						reg->storage.u64, 1, 0);
-					break;
-				case IL_REG_DTYPE_S64:
-					r = il_servo_raw_write_s64(servo, reg, ids[i],
-						reg->storage.s64, 1, 0);
-					break;
-				case IL_REG_DTYPE_FLOAT:
-					r = il_servo_raw_write_float(servo, reg, ids[i],
-						reg->storage.flt, 1, 0);
-					break;
-				default:
-					continue;
-				}
-
-				if (r < 0)
-					continue;
-			}
-		}
-	}
+void il_reg_handle_destroy(il_reg_handle_t *handle)
+{
+	il_servo_base__reg_handle_destroy(handle);
+}
 
-cleanup_ids:
-	if (ids) {
-		il_dict_reg_ids_destroy(ids);
-	}
-	else {
-		log_error("Could not load the configuration");
-	}
+il_reg_dtype_t il_reg_handle_dtype_get(il_reg_handle_t *handle)
+{
+	return handle->reg.dtype;
+}
 
-	il_dict_destroy(dict);
+int il_reg_handle_read(il_reg_handle_t *handle, il_reg_value_t *val)
+{
+	return il_servo_base__reg_handle_read(handle, val);
+}
 
-	return r;
+int il_reg_handle_write(il_reg_handle_t *handle, il_reg_value_t val,
+			int confirm)
+{
+	return il_servo_base__reg_handle_write(handle, val, confirm);
+}
+
+int il_reg_handle_read_units(il_reg_handle_t *handle, double *val)
+{
+	return il_servo_base__reg_handle_read_units(handle, val);
+}
+
+int il_reg_handle_write_units(il_reg_handle_t *handle, double val, int confirm)
+{
+	return il_servo_base__reg_handle_write_units(handle, val, confirm);
 }
 
 int il_servo_name_get(il_servo_t *servo, char *name, size_t sz)
@@ -429,6 +336,11 @@ int il_servo_read(il_servo_t *servo, const il_reg_t *reg, const char *id,
 	return servo->ops->read(servo, reg, id, buf);
 }
 
+int il_servo_read_many(il_servo_t *servo, il_servo_access_t *accs, size_t n)
+{
+	return servo->ops->read_many(servo, accs, n);
+}
+
 int il_servo_raw_write_u8(il_servo_t *servo, const il_reg_t *reg,
 			  const char *id, uint8_t val, int confirm, uint16_t extended)
 {
@@ -495,6 +407,11 @@ int il_servo_write(il_servo_t *servo, const il_reg_t *reg, const char *id,
 	return servo->ops->write(servo, reg, id, val, confirm, extended);
 }
 
+int il_servo_write_many(il_servo_t *servo, il_servo_access_t *accs, size_t n)
+{
+	return servo->ops->write_many(servo, accs, n);
+}
+
 int il_servo_disable(il_servo_t *servo, uint8_t subnode, int timeout)
 {
 	return servo->ops->disable(servo, subnode, timeout);
@@ -515,6 +432,25 @@ int il_servo_fault_reset(il_servo_t *servo, uint8_t subnode, int timeout)
 	return servo->ops->fault_reset(servo, subnode, timeout);
 }
 
+int il_servo_group_disable(il_servo_axis_t *axes, size_t n, int timeout)
+{
+	return il_servo_base__group_transition(axes, n, SERVO_GROUP_DISABLE,
+					       timeout);
+}
+
+int il_servo_group_enable(il_servo_axis_t *axes, size_t n, int timeout)
+{
+	return il_servo_base__group_transition(axes, n, SERVO_GROUP_ENABLE,
+					       timeout);
+}
+
+int il_servo_group_fault_reset(il_servo_axis_t *axes, size_t n, int timeout)
+{
+	return il_servo_base__group_transition(axes, n,
+					       SERVO_GROUP_FAULT_RESET,
+					       timeout);
+}
+
 int il_servo_mode_get(il_servo_t *servo, il_servo_mode_t *mode)
 {
 	return servo->ops->mode_get(servo, mode);
@@ -784,7 +720,6 @@ int il_servo_dict_get_subnode(il_servo_t *servo, il_dict_t *dict, int subnode)
 				return j;
 		}	
 	}
-	else {
-		return subnode;
-	}
+
+	return subnode;
 }
@@ -6,15 +6,31 @@
 #include "public/ingenialink/dict.h"
 #include "ingenialink/net.h"
 #include "ingenialink/utils.h"
+#include "mirror.h"
 
 #include "osal/osal.h"
 
 /** State external subscribers default array size. */
 #define STATE_SUBS_SZ_DEF	10
 
+/** State external subscribers, maximum number of subnodes tracked. */
+#define STATE_SUBS_SUBNODES_MAX	5
+
 /** State external subscribers period timeout (ms). */
 #define STATE_SUBS_TIMEOUT	100
 
+/** State external subscribers polling period (ms). */
+#define STATE_SUBS_PERIOD	200
+
+/** Group state transitions, statusword polling period (ms). */
+#define GROUP_POLL		2
+
+/** Group state transitions, maximum fault reset attempts per axis. */
+#define GROUP_FAULT_RESET_RETRIES	20
+
+/** Dictionary storage, registers per network transfer. */
+#define STORAGE_CHUNK		64
+
 /** Emergencies queue size. */
 #define EMCY_QUEUE_SZ		4
 
@@ -113,12 +129,18 @@ typedef struct {
 	/** Monitor stop flag. */
 	int stop;
 	int kill;
+	/** Last state notified (per subnode). */
+	il_servo_state_t states[STATE_SUBS_SUBNODES_MAX];
 } il_servo_state_subscriber_lst_t;
 
 /** Statusword updates subcription. */
 typedef struct {
-	/** Value. */
+	/** Value (last seen on any subnode). */
 	uint16_t value;
+	/** Value per subnode (up to STATE_SUBS_SUBNODES_MAX). */
+	uint16_t values[STATE_SUBS_SUBNODES_MAX];
+	/** Polling period while waiting (ms, 0 to rely on pushed values). */
+	int poll;
 	/** Lock. */
 	osal_mutex_t *lock;
 	/** Changed condition. */
@@ -151,10 +173,64 @@ struct il_servo {
 	il_servo_emcy_t emcy;
 	/** External emergency subscriptors. */
 	il_servo_emcy_subscriber_lst_t emcy_subs;
+	/** Register mirror. */
+	il_servo_mirror_t mirror;
 	/** Operations. */
 	const il_servo_ops_t *ops;
 };
 
+/** Group state transition goals. */
+typedef enum {
+	/** Reach operation enabled. */
+	SERVO_GROUP_ENABLE,
+	/** Reach switch on disabled. */
+	SERVO_GROUP_DISABLE,
+	/** Leave fault state. */
+	SERVO_GROUP_FAULT_RESET,
+} il_servo_group_goal_t;
+
+int il_servo_base__group_transition(il_servo_axis_t *axes, size_t n,
+				    il_servo_group_goal_t goal, int timeout);
+
+int il_servo_base__dict_storage_read(il_servo_t *servo,
+				     il_servo_progress_cb_t cb, void *ctx);
+
+int il_servo_base__dict_storage_restore(il_servo_t *servo, il_dict_t *cfg,
+					int subnode,
+					il_servo_restore_report_t **report);
+
+int il_servo_dict_get_subnode(il_servo_t *servo, il_dict_t *dict, int subnode);
+
+/** Pre-resolved register handle. */
+struct il_reg_handle {
+	/** Servo. */
+	il_servo_t *servo;
+	/** Register (copy). */
+	il_reg_t reg;
+	/** Transfer size. */
+	size_t sz;
+	/** Units factor. */
+	double factor;
+};
+
+il_reg_handle_t *il_servo_base__reg_handle_create(il_servo_t *servo,
+						  const il_reg_t *reg,
+						  const char *id,
+						  uint8_t subnode);
+
+void il_servo_base__reg_handle_destroy(il_reg_handle_t *handle);
+
+int il_servo_base__reg_handle_read(il_reg_handle_t *handle,
+				   il_reg_value_t *val);
+
+int il_servo_base__reg_handle_write(il_reg_handle_t *handle,
+				    il_reg_value_t val, int confirm);
+
+int il_servo_base__reg_handle_read_units(il_reg_handle_t *handle, double *val);
+
+int il_servo_base__reg_handle_write_units(il_reg_handle_t *handle, double val,
+					  int confirm);
+
 /** Servo implementations. */
 #ifdef IL_HAS_PROT_ETH
 extern const il_servo_ops_t il_eth_servo_ops;
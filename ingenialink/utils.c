@@ -1,9 +1,89 @@
 #include "utils.h"
 
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
 #include "ingenialink/err.h"
 
+/*******************************************************************************
+ * Private
+ ******************************************************************************/
+
+/*
+ * Ring indexes are published with release semantics and observed with acquire
+ * semantics, so that element copies are visible before the index moves.
+ */
+#ifdef _WIN32
+#define ring_load(p) \
+	((uint32_t)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define ring_store(p, v) \
+	((void)InterlockedExchange((volatile LONG *)(p), (LONG)(v)))
+#define ring_load64(p) \
+	((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(p), 0, 0))
+#define ring_add64(p, v) \
+	((void)InterlockedExchangeAdd64((volatile LONG64 *)(p), (LONG64)(v)))
+#else
+#define ring_load(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ring_store(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ring_load64(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ring_add64(p, v) \
+	((void)__atomic_fetch_add((p), (v), __ATOMIC_RELAXED))
+#endif
+
+/**
+ * Copy elements into the ring storage, wrapping if necessary.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [in] idx
+ *	Start index (free running).
+ * @param [in] elems
+ *	Elements.
+ * @param [in] n
+ *	Number of elements.
+ */
+static void ring_copy_in(il_utils_ring_t *ring, uint32_t idx, const void *elems,
+			 size_t n)
+{
+	size_t off, first;
+
+	off = idx & (ring->cap - 1);
+	first = MIN(n, ring->cap - off);
+
+	memcpy(&ring->buf[off * ring->elem_sz], elems, first * ring->elem_sz);
+	memcpy(ring->buf, (const uint8_t *)elems + first * ring->elem_sz,
+	       (n - first) * ring->elem_sz);
+}
+
+/**
+ * Copy elements out of the ring storage, wrapping if necessary.
+ *
+ * @param [in] ring
+ *	Ring instance.
+ * @param [in] idx
+ *	Start index (free running).
+ * @param [out] elems
+ *	Buffer.
+ * @param [in] n
+ *	Number of elements.
+ */
+static void ring_copy_out(il_utils_ring_t *ring, uint32_t idx, void *elems,
+			  size_t n)
+{
+	size_t off, first;
+
+	off = idx & (ring->cap - 1);
+	first = MIN(n, ring->cap - off);
+
+	memcpy(elems, &ring->buf[off * ring->elem_sz], first * ring->elem_sz);
+	memcpy((uint8_t *)elems + first * ring->elem_sz, ring->buf,
+	       (n - first) * ring->elem_sz);
+}
+
 /*******************************************************************************
  * Internal
  ******************************************************************************/
@@ -65,3 +145,115 @@ void il_utils__refcnt_release(il_utils_refcnt_t *refcnt)
 		il_utils__refcnt_destroy(refcnt);
 	}
 }
+
+il_utils_ring_t *il_utils__ring_create(size_t elem_sz, size_t cap)
+{
+	il_utils_ring_t *ring;
+	uint32_t cap_p2;
+
+	if (elem_sz == 0 || cap == 0 || cap > 0x80000000U) {
+		ilerr__set("Invalid ring dimensions");
+		return NULL;
+	}
+
+	for (cap_p2 = 1; cap_p2 < cap; cap_p2 <<= 1)
+		;
+
+	ring = calloc(1, sizeof(*ring));
+	if (!ring) {
+		ilerr__set("Ring allocation failed");
+		return NULL;
+	}
+
+	ring->buf = malloc(elem_sz * cap_p2);
+	if (!ring->buf) {
+		ilerr__set("Ring buffer allocation failed");
+		goto cleanup_ring;
+	}
+
+	ring->elem_sz = elem_sz;
+	ring->cap = cap_p2;
+
+	return ring;
+
+cleanup_ring:
+	free(ring);
+
+	return NULL;
+}
+
+void il_utils__ring_destroy(il_utils_ring_t *ring)
+{
+	free(ring->buf);
+	free(ring);
+}
+
+size_t il_utils__ring_push(il_utils_ring_t *ring, const void *elems, size_t n)
+{
+	uint32_t head, tail;
+	size_t space, cnt;
+
+	head = ring->head;
+	tail = ring_load(&ring->tail);
+
+	space = ring->cap - (uint32_t)(head - tail);
+	cnt = MIN(n, space);
+
+	if (cnt > 0) {
+		ring_copy_in(ring, head, elems, cnt);
+		ring_store(&ring->head, head + (uint32_t)cnt);
+	}
+
+	if (cnt < n)
+		ring_add64(&ring->dropped, (uint64_t)(n - cnt));
+
+	return cnt;
+}
+
+size_t il_utils__ring_pop(il_utils_ring_t *ring, void *elems, size_t n)
+{
+	uint32_t head, tail;
+	size_t cnt;
+
+	tail = ring->tail;
+	head = ring_load(&ring->head);
+
+	cnt = MIN(n, (size_t)(uint32_t)(head - tail));
+	if (cnt > 0) {
+		ring_copy_out(ring, tail, elems, cnt);
+		ring_store(&ring->tail, tail + (uint32_t)cnt);
+	}
+
+	return cnt;
+}
+
+size_t il_utils__ring_peek(il_utils_ring_t *ring, void **elems)
+{
+	uint32_t head, tail;
+	size_t off, cnt;
+
+	tail = ring->tail;
+	head = ring_load(&ring->head);
+
+	off = tail & (ring->cap - 1);
+	cnt = MIN((size_t)(uint32_t)(head - tail), ring->cap - off);
+
+	*elems = &ring->buf[off * ring->elem_sz];
+
+	return cnt;
+}
+
+void il_utils__ring_consume(il_utils_ring_t *ring, size_t n)
+{
+	ring_store(&ring->tail, ring->tail + (uint32_t)n);
+}
+
+size_t il_utils__ring_cnt(il_utils_ring_t *ring)
+{
+	return (uint32_t)(ring_load(&ring->head) - ring_load(&ring->tail));
+}
+
+uint64_t il_utils__ring_dropped(il_utils_ring_t *ring)
+{
+	return ring_load64(&ring->dropped);
+}
@@ -17,4 +17,20 @@ struct il_utils_refcnt {
 	int cnt;
 };
 
+/** Ring. */
+struct il_utils_ring {
+	/** Buffer. */
+	uint8_t *buf;
+	/** Element size. */
+	size_t elem_sz;
+	/** Capacity (power of two). */
+	uint32_t cap;
+	/** Write index (free running, producer owned). */
+	volatile uint32_t head;
+	/** Read index (free running, consumer owned). */
+	volatile uint32_t tail;
+	/** Dropped elements (producer owned). */
+	volatile uint64_t dropped;
+};
+
 #endif
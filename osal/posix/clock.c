@@ -1,6 +1,8 @@
 #include "clock.h"
 
+#include <errno.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "osal/err.h"
@@ -99,6 +101,54 @@ int osal_clock_gettime(osal_timespec_t *ts)
 	return 0;
 }
 
+void osal_clock_deadline_set(osal_timespec_t *deadline, long long ns)
+{
+	(void)osal_clock_gettime(deadline);
+
+	deadline->s += (long)(ns / OSAL_CLOCK_NANOSPERSEC);
+	deadline->ns += (long)(ns % OSAL_CLOCK_NANOSPERSEC);
+	if (deadline->ns >= OSAL_CLOCK_NANOSPERSEC) {
+		deadline->s++;
+		deadline->ns -= OSAL_CLOCK_NANOSPERSEC;
+	}
+}
+
+long long osal_clock_deadline_left(const osal_timespec_t *deadline)
+{
+	osal_timespec_t now;
+
+	(void)osal_clock_gettime(&now);
+
+	return (long long)(deadline->s - now.s) * OSAL_CLOCK_NANOSPERSEC +
+	       (deadline->ns - now.ns);
+}
+
+void osal_clock_sleep_until(const osal_timespec_t *deadline)
+{
+#if defined(__linux__)
+	struct timespec ts;
+
+	ts.tv_sec = deadline->s;
+	ts.tv_nsec = deadline->ns;
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) ==
+	       EINTR)
+		;
+#else
+	struct timespec ts;
+	long long left;
+
+	left = osal_clock_deadline_left(deadline);
+	if (left <= 0)
+		return;
+
+	ts.tv_sec = (time_t)(left / OSAL_CLOCK_NANOSPERSEC);
+	ts.tv_nsec = (long)(left % OSAL_CLOCK_NANOSPERSEC);
+
+	(void)nanosleep(&ts, NULL);
+#endif
+}
+
 void osal_clock_sleep_ms(int ms)
 {
 	usleep(ms * 1000);
@@ -2,6 +2,8 @@
 
 #include <stdlib.h>
 
+#include "osal/err.h"
+
 /*******************************************************************************
  * Public
  ******************************************************************************/
@@ -37,6 +39,11 @@ void osal_mutex_lock(osal_mutex_t *mutex)
 	(void)pthread_mutex_lock(&mutex->m);
 }
 
+int osal_mutex_trylock(osal_mutex_t *mutex)
+{
+	return pthread_mutex_trylock(&mutex->m) == 0 ? 0 : OSAL_EFAIL;
+}
+
 void osal_mutex_unlock(osal_mutex_t *mutex)
 {
 	(void)pthread_mutex_unlock(&mutex->m);
@@ -70,6 +70,43 @@ int osal_clock_gettime(osal_timespec_t *ts)
 	return 0;
 }
 
+void osal_clock_deadline_set(osal_timespec_t *deadline, long long ns)
+{
+	(void)osal_clock_gettime(deadline);
+
+	deadline->s += (long)(ns / OSAL_CLOCK_NANOSPERSEC);
+	deadline->ns += (long)(ns % OSAL_CLOCK_NANOSPERSEC);
+	if (deadline->ns >= OSAL_CLOCK_NANOSPERSEC) {
+		deadline->s++;
+		deadline->ns -= OSAL_CLOCK_NANOSPERSEC;
+	}
+}
+
+long long osal_clock_deadline_left(const osal_timespec_t *deadline)
+{
+	osal_timespec_t now;
+
+	(void)osal_clock_gettime(&now);
+
+	return (long long)(deadline->s - now.s) * OSAL_CLOCK_NANOSPERSEC +
+	       (deadline->ns - now.ns);
+}
+
+void osal_clock_sleep_until(const osal_timespec_t *deadline)
+{
+	long long left;
+
+	left = osal_clock_deadline_left(deadline);
+	if (left <= 0)
+		return;
+
+	/* Sleep() takes whole milliseconds: round up so that we never wake up
+	 * before the deadline (the scheduler tick may still delay the wake-up)
+	 */
+	Sleep((DWORD)((left + OSAL_CLOCK_NANOSPERMSEC - 1) /
+		      OSAL_CLOCK_NANOSPERMSEC));
+}
+
 void osal_clock_sleep_ms(int ms)
 {
 	Sleep(ms);
@@ -2,6 +2,8 @@
 
 #include <stdlib.h>
 
+#include "osal/err.h"
+
 /*******************************************************************************
  * Public
  ******************************************************************************/
@@ -30,6 +32,11 @@ void osal_mutex_lock(osal_mutex_t *mutex)
 	EnterCriticalSection(&mutex->m);
 }
 
+int osal_mutex_trylock(osal_mutex_t *mutex)
+{
+	return TryEnterCriticalSection(&mutex->m) ? 0 : OSAL_EFAIL;
+}
+
 void osal_mutex_unlock(osal_mutex_t *mutex)
 {
 	LeaveCriticalSection(&mutex->m);
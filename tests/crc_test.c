@@ -0,0 +1,64 @@
+/*
+ * CRC-CCITT: the table-driven implementation (byte-wise tail and
+ * slicing-by-8 body) against a bit-wise reference.
+ */
+
+#include <stdint.h>
+
+#include "ingenialink/crc.h"
+
+#include "test.h"
+
+/** Test buffer size (bytes). */
+#define BUF_SZ		300
+
+static uint16_t crc_ref(uint16_t crc, const uint8_t *p, size_t sz)
+{
+	size_t i;
+	int j;
+
+	for (i = 0; i < sz; i++) {
+		crc ^= (uint16_t)(p[i] << 8);
+		for (j = 0; j < 8; j++) {
+			if (crc & 0x8000)
+				crc = (uint16_t)((crc << 1) ^ IL_CRC_CCITT_POLY);
+			else
+				crc = (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+int main(void)
+{
+	uint8_t buf[BUF_SZ];
+	size_t sz, split, off;
+
+	srand(1);
+	for (sz = 0; sz < sizeof(buf); sz++)
+		buf[sz] = (uint8_t)rand();
+
+	/* XMODEM check value */
+	TEST_CHECK(il_crc__ccitt("123456789", 9) == 0x31C3);
+
+	/* every size, both below and above the slicing threshold */
+	for (sz = 0; sz <= sizeof(buf); sz++)
+		TEST_CHECK(il_crc__ccitt(buf, sz) == crc_ref(0, buf, sz));
+
+	/* unaligned buffers */
+	for (off = 1; off < 8; off++)
+		TEST_CHECK(il_crc__ccitt(&buf[off], 12) ==
+			   crc_ref(0, &buf[off], 12));
+
+	/* incremental updates match a single pass */
+	for (split = 0; split <= 64; split++) {
+		uint16_t crc;
+
+		crc = il_crc__ccitt_update(0, buf, split);
+		crc = il_crc__ccitt_update(crc, &buf[split], 64 - split);
+		TEST_CHECK(crc == crc_ref(0, buf, 64));
+	}
+
+	return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * Register mirror: open addressing table growth and removal, generation
+ * checks on fills racing with writes, TTL expiry and the live refresher.
+ * Register reads are served from a fake wire.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ingenialink/err.h"
+#include "ingenialink/net.h"
+#include "../ingenialink/servo.h"
+
+#include "test.h"
+
+/** Registers mirrored. */
+#define REGS_CNT	1000
+
+/** Subnode used by all registers. */
+#define SUBNODE		1
+
+/** Fake wire (register values indexed by address). */
+static uint32_t wire[REGS_CNT];
+
+/** Number of network transfers. */
+static int xfers;
+
+/*
+ * Stubs.
+ */
+
+int il_dict_reg_get(il_dict_t *dict, const char *id, const il_reg_t **reg,
+		    uint8_t subnode)
+{
+	(void)dict;
+	(void)id;
+	(void)reg;
+	(void)subnode;
+
+	return IL_EFAIL;
+}
+
+int il_net__transfer(il_net_t *net, il_net_req_t *reqs, size_t n)
+{
+	size_t i;
+
+	(void)net;
+
+	xfers++;
+
+	for (i = 0; i < n; i++) {
+		memcpy(reqs[i].buf, &wire[reqs[i].address], reqs[i].sz);
+		reqs[i].r = 0;
+	}
+
+	return 0;
+}
+
+/*
+ * Helpers.
+ */
+
+static int policy_set(il_servo_t *servo, uint16_t address,
+		      il_servo_mirror_policy_t policy, int ttl)
+{
+	il_reg_t reg;
+
+	memset(&reg, 0, sizeof(reg));
+	reg.subnode = SUBNODE;
+	reg.address = address;
+	reg.dtype = IL_REG_DTYPE_U32;
+
+	return il_servo_mirror_policy_set(servo, &reg, NULL, SUBNODE, policy,
+					  ttl);
+}
+
+static int lookup(il_servo_t *servo, uint16_t address, uint32_t *v,
+		  uint64_t *gen)
+{
+	return il_servo_mirror__lookup(&servo->mirror, SUBNODE, address, v,
+				       sizeof(*v), gen);
+}
+
+/*
+ * Tests.
+ */
+
+static void test_table(il_servo_t *servo)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	il_servo_mirror_stats_t stats;
+	uint64_t gen;
+	uint32_t v;
+	uint16_t i;
+
+	/* nothing is mirrored while disabled */
+	TEST_CHECK(lookup(servo, 5, &v, &gen) == 0);
+	TEST_CHECK(gen == 0);
+	TEST_CHECK(policy_set(servo, 5, IL_SERVO_MIRROR_STATIC, 0) ==
+		   IL_ESTATE);
+
+	TEST_CHECK(il_servo_mirror_enable(servo, 0) == 0);
+	TEST_CHECK(il_servo_mirror_enable(servo, 0) == IL_EALREADY);
+
+	/* table grows well beyond its initial size */
+	for (i = 0; i < REGS_CNT; i++)
+		TEST_CHECK(policy_set(servo, i, IL_SERVO_MIRROR_STATIC, 0) ==
+			   0);
+
+	TEST_CHECK(mirror->cnt == REGS_CNT);
+	TEST_CHECK(mirror->sz >= 2 * REGS_CNT);
+
+	/* first read misses and fills, second one hits */
+	for (i = 0; i < REGS_CNT; i++) {
+		wire[i] = i * 7U;
+		TEST_CHECK(lookup(servo, i, &v, &gen) == 0);
+		TEST_CHECK(gen != 0);
+		il_servo_mirror__fill(mirror, SUBNODE, i, &wire[i],
+				      sizeof(wire[i]), gen);
+	}
+
+	for (i = 0; i < REGS_CNT; i++) {
+		TEST_CHECK(lookup(servo, i, &v, &gen) == 1);
+		TEST_CHECK(v == i * 7U);
+	}
+
+	/* size mismatches are never served */
+	TEST_CHECK(il_servo_mirror__lookup(mirror, SUBNODE, 3, &v, 2, &gen) ==
+		   0);
+
+	/* removal keeps the remaining probe sequences intact */
+	for (i = 0; i < REGS_CNT; i += 2)
+		TEST_CHECK(policy_set(servo, i, IL_SERVO_MIRROR_NONE, 0) == 0);
+
+	TEST_CHECK(mirror->cnt == REGS_CNT / 2);
+
+	for (i = 0; i < REGS_CNT; i++) {
+		if (i % 2) {
+			TEST_CHECK(lookup(servo, i, &v, &gen) == 1);
+			TEST_CHECK(v == i * 7U);
+		} else {
+			TEST_CHECK(lookup(servo, i, &v, &gen) == 0);
+			TEST_CHECK(gen == 0);
+		}
+	}
+
+	il_servo_mirror_stats_get(servo, &stats);
+	TEST_CHECK(stats.entries == REGS_CNT / 2);
+	TEST_CHECK(stats.hits == REGS_CNT + REGS_CNT / 2);
+	TEST_CHECK(stats.misses == REGS_CNT + 1);
+
+	il_servo_mirror_disable(servo);
+}
+
+static void test_gen(il_servo_t *servo)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	uint64_t gen, stale;
+	uint32_t v;
+
+	TEST_CHECK(il_servo_mirror_enable(servo, 0) == 0);
+	TEST_CHECK(policy_set(servo, 1, IL_SERVO_MIRROR_STATIC, 0) == 0);
+
+	/* a read started before a write can not override it */
+	TEST_CHECK(lookup(servo, 1, &v, &stale) == 0);
+	v = 99;
+	il_servo_mirror__written(mirror, SUBNODE, 1, &v, sizeof(v), 0);
+	wire[1] = 1;
+	il_servo_mirror__fill(mirror, SUBNODE, 1, &wire[1], sizeof(wire[1]),
+			      stale);
+
+	TEST_CHECK(lookup(servo, 1, &v, &gen) == 1);
+	TEST_CHECK(v == 99);
+
+	/* nor after invalidation */
+	il_servo_mirror_invalidate(servo);
+	TEST_CHECK(lookup(servo, 1, &v, &gen) == 0);
+	il_servo_mirror__fill(mirror, SUBNODE, 1, &wire[1], sizeof(wire[1]),
+			      stale);
+	TEST_CHECK(lookup(servo, 1, &v, &gen) == 0);
+
+	/* failed writes drop the value */
+	il_servo_mirror__fill(mirror, SUBNODE, 1, &wire[1], sizeof(wire[1]),
+			      gen);
+	TEST_CHECK(lookup(servo, 1, &v, &gen) == 1);
+	il_servo_mirror__written(mirror, SUBNODE, 1, &v, sizeof(v), IL_EIO);
+	TEST_CHECK(lookup(servo, 1, &v, &gen) == 0);
+
+	il_servo_mirror_disable(servo);
+}
+
+static void test_ttl(il_servo_t *servo)
+{
+	il_servo_mirror_t *mirror = &servo->mirror;
+	uint64_t gen;
+	uint32_t v;
+
+	TEST_CHECK(il_servo_mirror_enable(servo, 0) == 0);
+	TEST_CHECK(policy_set(servo, 2, IL_SERVO_MIRROR_TTL, 0) == IL_EINVAL);
+	TEST_CHECK(policy_set(servo, 2, IL_SERVO_MIRROR_TTL, 20) == 0);
+
+	wire[2] = 42;
+	TEST_CHECK(lookup(servo, 2, &v, &gen) == 0);
+	il_servo_mirror__fill(mirror, SUBNODE, 2, &wire[2], sizeof(wire[2]),
+			      gen);
+	TEST_CHECK(lookup(servo, 2, &v, &gen) == 1);
+	TEST_CHECK(v == 42);
+
+	osal_clock_sleep_ms(40);
+	TEST_CHECK(lookup(servo, 2, &v, &gen) == 0);
+
+	/* live values are never served without a refresher */
+	TEST_CHECK(policy_set(servo, 3, IL_SERVO_MIRROR_LIVE, 0) == 0);
+	TEST_CHECK(lookup(servo, 3, &v, &gen) == 0);
+	il_servo_mirror__fill(mirror, SUBNODE, 3, &wire[3], sizeof(wire[3]),
+			      gen);
+	TEST_CHECK(lookup(servo, 3, &v, &gen) == 0);
+
+	il_servo_mirror_disable(servo);
+}
+
+static void test_live(il_servo_t *servo)
+{
+	uint64_t gen;
+	uint32_t v = 0;
+	int i;
+
+	TEST_CHECK(il_servo_mirror_enable(servo, 5) == 0);
+	TEST_CHECK(policy_set(servo, 3, IL_SERVO_MIRROR_LIVE, 0) == 0);
+
+	/* the refresher picks up wire changes within a few periods */
+	wire[3] = 12345;
+	for (i = 0; i < 200; i++) {
+		if (lookup(servo, 3, &v, &gen) == 1 && v == 12345)
+			break;
+		osal_clock_sleep_ms(5);
+	}
+
+	TEST_CHECK(v == 12345);
+	TEST_CHECK(xfers > 0);
+
+	il_servo_mirror_disable(servo);
+}
+
+int main(void)
+{
+	static il_servo_t servo;
+
+	TEST_CHECK(il_servo_mirror__init(&servo.mirror) == 0);
+
+	test_table(&servo);
+	test_gen(&servo);
+	test_ttl(&servo);
+	test_live(&servo);
+
+	il_servo_mirror__deinit(&servo.mirror);
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Monitoring layout decoding: every instruction set against a reference
+ * strided copy, for uniform, mixed and padded layouts and block counts that
+ * exercise the vector kernel tails.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ingenialink/err.h"
+#include "ingenialink/mon_decode.h"
+
+#include "test.h"
+
+/** Maximum number of channels tested. */
+#define CH_MAX		5
+
+/** Maximum number of blocks tested. */
+#define BLOCKS_MAX	150
+
+/** Maximum block size (bytes). */
+#define BLOCK_SZ_MAX	(CH_MAX * 8 + 8)
+
+/** Source blocks. */
+static uint8_t src[BLOCKS_MAX * BLOCK_SZ_MAX];
+
+/** Decoded channels. */
+static uint8_t out[CH_MAX][BLOCKS_MAX * 8];
+
+static void check(const il_reg_dtype_t *types, size_t n_ch, size_t block_sz,
+		  il_mon_decode_isa_t isa)
+{
+	il_mon_layout_t layout;
+	void *dst[CH_MAX];
+	size_t ch, i, n;
+
+	TEST_CHECK(il_mon_decode__compile(&layout, types, n_ch, block_sz,
+					  isa) == 0);
+	TEST_CHECK(layout.n_ch == n_ch);
+
+	for (ch = 0; ch < n_ch; ch++)
+		dst[ch] = out[ch];
+
+	for (n = 0; n < BLOCKS_MAX; n += 7) {
+		memset(out, 0xa5, sizeof(out));
+
+		il_mon_decode__run(&layout, src, n, dst);
+
+		for (ch = 0; ch < n_ch; ch++) {
+			size_t sz = layout.ch[ch].sz;
+
+			for (i = 0; i < n; i++)
+				TEST_CHECK(memcmp(&out[ch][i * sz],
+						  &src[i * layout.block_sz +
+						       layout.ch[ch].off],
+						  sz) == 0);
+		}
+	}
+
+	il_mon_decode__release(&layout);
+	TEST_CHECK(layout.ch == NULL);
+}
+
+static void test_uniform(void)
+{
+	static const il_reg_dtype_t dtypes[] = {
+		IL_REG_DTYPE_U8, IL_REG_DTYPE_S16, IL_REG_DTYPE_FLOAT,
+		IL_REG_DTYPE_U64
+	};
+	static const il_mon_decode_isa_t isas[] = {
+		IL_MON_DECODE_ISA_SCALAR, IL_MON_DECODE_ISA_SSE2,
+		IL_MON_DECODE_ISA_AVX2, IL_MON_DECODE_ISA_NEON,
+		IL_MON_DECODE_ISA_AUTO
+	};
+	il_reg_dtype_t types[CH_MAX];
+	size_t t, i, n_ch, ch;
+
+	for (t = 0; t < sizeof(dtypes) / sizeof(dtypes[0]); t++) {
+		for (ch = 0; ch < CH_MAX; ch++)
+			types[ch] = dtypes[t];
+
+		for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++)
+			for (n_ch = 1; n_ch <= CH_MAX; n_ch++)
+				check(types, n_ch, 0, isas[i]);
+	}
+}
+
+static void test_mixed(void)
+{
+	static const il_reg_dtype_t types[] = {
+		IL_REG_DTYPE_U16, IL_REG_DTYPE_FLOAT, IL_REG_DTYPE_S8,
+		IL_REG_DTYPE_S64, IL_REG_DTYPE_U32
+	};
+	il_mon_layout_t layout;
+
+	TEST_CHECK(il_mon_decode__compile(&layout, types, CH_MAX, 0,
+					  IL_MON_DECODE_ISA_AUTO) == 0);
+	TEST_CHECK(layout.block_sz == 2 + 4 + 1 + 8 + 4);
+	TEST_CHECK(layout.ch[3].off == 7);
+	TEST_CHECK(layout.kernel == NULL);
+	il_mon_decode__release(&layout);
+
+	check(types, CH_MAX, 0, IL_MON_DECODE_ISA_AUTO);
+}
+
+static void test_padded(void)
+{
+	static const il_reg_dtype_t types[] = {
+		IL_REG_DTYPE_FLOAT, IL_REG_DTYPE_FLOAT
+	};
+	il_mon_layout_t layout;
+
+	/* drive blocks larger than the mapping never take a vector kernel */
+	TEST_CHECK(il_mon_decode__compile(&layout, types, 2, 12,
+					  IL_MON_DECODE_ISA_AUTO) == 0);
+	TEST_CHECK(layout.block_sz == 12);
+	TEST_CHECK(layout.kernel == NULL);
+	il_mon_decode__release(&layout);
+
+	check(types, 2, 12, IL_MON_DECODE_ISA_AUTO);
+	check(types, 1, 5, IL_MON_DECODE_ISA_AUTO);
+}
+
+static void test_invalid(void)
+{
+	static const il_reg_dtype_t str[] = {
+		IL_REG_DTYPE_U32, IL_REG_DTYPE_STR
+	};
+	static const il_reg_dtype_t u32[] = {
+		IL_REG_DTYPE_U32, IL_REG_DTYPE_U32
+	};
+	il_mon_layout_t layout;
+
+	TEST_CHECK(il_mon_decode__compile(&layout, str, 2, 0,
+					  IL_MON_DECODE_ISA_AUTO) == IL_EINVAL);
+	TEST_CHECK(layout.ch == NULL);
+
+	TEST_CHECK(il_mon_decode__compile(&layout, u32, 2, 7,
+					  IL_MON_DECODE_ISA_AUTO) == IL_EINVAL);
+	TEST_CHECK(layout.ch == NULL);
+
+	/* an empty layout decodes nothing */
+	TEST_CHECK(il_mon_decode__compile(&layout, u32, 0, 0,
+					  IL_MON_DECODE_ISA_AUTO) == 0);
+	il_mon_decode__run(&layout, src, 10, NULL);
+	il_mon_decode__release(&layout);
+}
+
+int main(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(src); i++)
+		src[i] = (uint8_t)(i * 131 + 7);
+
+	test_uniform();
+	test_mixed();
+	test_padded();
+	test_invalid();
+
+	return 0;
+}
@@ -0,0 +1,264 @@
+/*
+ * Poller deadline math: timespec arithmetic, deadline scheduling under each
+ * overrun policy and the sleep/spin split. The poller runs on a fake clock,
+ * so results do not depend on scheduling.
+ */
+
+#include "../ingenialink/poller.c"
+
+#include "test.h"
+
+/** Sampling period used by the tests (ns). */
+#define PERIOD		1000000LL
+
+/** Fake clock (ns). */
+static long long clock_ns;
+
+/** Fake clock advance per deadline check (ns, lets spin loops end). */
+static long long clock_step;
+
+/** Last deadline slept until (ns). */
+static long long slept_until;
+
+/*
+ * Stubs.
+ */
+
+int osal_clock_gettime(osal_timespec_t *ts)
+{
+	ts->s = (long)(clock_ns / OSAL_CLOCK_NANOSPERSEC);
+	ts->ns = (long)(clock_ns % OSAL_CLOCK_NANOSPERSEC);
+
+	return 0;
+}
+
+long long osal_clock_deadline_left(const osal_timespec_t *deadline)
+{
+	long long left;
+
+	left = (long long)deadline->s * OSAL_CLOCK_NANOSPERSEC + deadline->ns -
+	       clock_ns;
+	clock_ns += clock_step;
+
+	return left;
+}
+
+void osal_clock_sleep_until(const osal_timespec_t *deadline)
+{
+	slept_until = (long long)deadline->s * OSAL_CLOCK_NANOSPERSEC +
+		      deadline->ns;
+	if (slept_until > clock_ns)
+		clock_ns = slept_until;
+}
+
+osal_clock_perf_t *osal_clock_perf_create(void)
+{
+	return NULL;
+}
+
+void osal_clock_perf_destroy(osal_clock_perf_t *perf)
+{
+	(void)perf;
+}
+
+int osal_clock_perf_reset(osal_clock_perf_t *perf)
+{
+	(void)perf;
+
+	return 0;
+}
+
+int osal_clock_perf_get(osal_clock_perf_t *perf, osal_timespec_t *ts)
+{
+	(void)perf;
+
+	return osal_clock_gettime(ts);
+}
+
+int il_dict_reg_get(il_dict_t *dict, const char *id, const il_reg_t **reg,
+		    uint8_t subnode)
+{
+	(void)dict;
+	(void)id;
+	(void)reg;
+	(void)subnode;
+
+	return IL_EFAIL;
+}
+
+void il_servo__release(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+void il_servo__retain(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+il_dict_t *il_servo_dict_get(il_servo_t *servo)
+{
+	(void)servo;
+
+	return NULL;
+}
+
+int il_servo_read_many(il_servo_t *servo, il_servo_access_t *accs, size_t n)
+{
+	(void)servo;
+	(void)accs;
+	(void)n;
+
+	return IL_EFAIL;
+}
+
+/*
+ * Helpers.
+ */
+
+static osal_timespec_t ts_from_ns(long long ns)
+{
+	osal_timespec_t ts;
+
+	ts.s = (long)(ns / OSAL_CLOCK_NANOSPERSEC);
+	ts.ns = (long)(ns % OSAL_CLOCK_NANOSPERSEC);
+
+	return ts;
+}
+
+static long long ts_to_ns(const osal_timespec_t *ts)
+{
+	return (long long)ts->s * OSAL_CLOCK_NANOSPERSEC + ts->ns;
+}
+
+/*
+ * Schedule the deadline that follows one due late, so that m + 1 deadlines
+ * (including the scheduled one) have already passed.
+ */
+static uint64_t late_next(il_poller_t *poller, uint64_t m, long long *next)
+{
+	osal_timespec_t ts;
+	uint64_t missed;
+
+	ts = ts_from_ns(clock_ns - (long long)m * PERIOD - PERIOD / 2 -
+			PERIOD);
+	missed = deadline_next(poller, &ts);
+	*next = ts_to_ns(&ts);
+
+	return missed;
+}
+
+/*
+ * Tests.
+ */
+
+static void test_ts_add(void)
+{
+	osal_timespec_t ts;
+
+	ts.s = 1;
+	ts.ns = OSAL_CLOCK_NANOSPERSEC - 1;
+	ts_add(&ts, 1);
+	TEST_CHECK(ts.s == 2 && ts.ns == 0);
+
+	ts_add(&ts, -1);
+	TEST_CHECK(ts.s == 1 && ts.ns == OSAL_CLOCK_NANOSPERSEC - 1);
+
+	ts.s = 3;
+	ts.ns = 100;
+	ts_add(&ts, -2500000000LL);
+	TEST_CHECK(ts.s == 0 && ts.ns == 500000100);
+
+	ts_add(&ts, 2500000000LL);
+	TEST_CHECK(ts.s == 3 && ts.ns == 100);
+
+	ts.s = 0;
+	ts.ns = 999999999;
+	ts_add(&ts, 1999999999LL);
+	TEST_CHECK(ts.s == 2 && ts.ns == 999999998);
+}
+
+static void test_deadline_next(void)
+{
+	il_poller_t poller;
+	osal_timespec_t ts;
+	long long next;
+
+	memset(&poller, 0, sizeof(poller));
+	poller.period = PERIOD;
+	clock_ns = 10 * OSAL_CLOCK_NANOSPERSEC;
+
+	/* on time: just one period ahead */
+	ts = ts_from_ns(clock_ns - PERIOD / 2);
+	TEST_CHECK(deadline_next(&poller, &ts) == 0);
+	TEST_CHECK(ts_to_ns(&ts) == clock_ns + PERIOD / 2);
+
+	/* skip: resume at the first future deadline, keeping the phase */
+	poller.overrun = IL_POLLER_OVERRUN_SKIP;
+	TEST_CHECK(late_next(&poller, 0, &next) == 1);
+	TEST_CHECK(next == clock_ns + PERIOD / 2);
+	TEST_CHECK(late_next(&poller, 100, &next) == 101);
+	TEST_CHECK(next == clock_ns + PERIOD / 2);
+
+	/* catch up: late deadlines are kept, up to a limit */
+	poller.overrun = IL_POLLER_OVERRUN_CATCH_UP;
+	TEST_CHECK(late_next(&poller, POLLER_CATCH_UP_MAX - 1, &next) == 0);
+	TEST_CHECK(next == clock_ns - (POLLER_CATCH_UP_MAX - 1) * PERIOD -
+			   PERIOD / 2);
+	TEST_CHECK(late_next(&poller, 100, &next) ==
+		   101 - POLLER_CATCH_UP_MAX);
+	TEST_CHECK(next == clock_ns - (POLLER_CATCH_UP_MAX - 1) * PERIOD -
+			   PERIOD / 2);
+
+	/* stretch: restart the schedule from now */
+	poller.overrun = IL_POLLER_OVERRUN_STRETCH;
+	TEST_CHECK(late_next(&poller, 0, &next) == 0);
+	TEST_CHECK(next == clock_ns);
+	TEST_CHECK(late_next(&poller, 100, &next) == 100);
+	TEST_CHECK(next == clock_ns);
+}
+
+static void test_deadline_wait(void)
+{
+	il_poller_t poller;
+	osal_timespec_t deadline;
+	long long t0;
+
+	memset(&poller, 0, sizeof(poller));
+	clock_ns = 10 * OSAL_CLOCK_NANOSPERSEC;
+	t0 = clock_ns;
+
+	/* no spin window: sleep straight to the deadline */
+	deadline = ts_from_ns(t0 + PERIOD);
+	deadline_wait(&poller, &deadline);
+	TEST_CHECK(slept_until == t0 + PERIOD);
+	TEST_CHECK(clock_ns == t0 + PERIOD);
+
+	/* spin window: sleep until the window opens, then spin */
+	poller.spin = PERIOD / 10;
+	clock_step = 1000;
+	t0 = clock_ns;
+	deadline = ts_from_ns(t0 + PERIOD);
+	deadline_wait(&poller, &deadline);
+	TEST_CHECK(slept_until == t0 + PERIOD - PERIOD / 10);
+	TEST_CHECK(clock_ns >= t0 + PERIOD);
+
+	/* within the window: do not sleep at all */
+	slept_until = 0;
+	t0 = clock_ns;
+	deadline = ts_from_ns(t0 + PERIOD / 20);
+	deadline_wait(&poller, &deadline);
+	TEST_CHECK(slept_until == 0);
+	TEST_CHECK(clock_ns >= t0 + PERIOD / 20);
+
+	clock_step = 0;
+}
+
+int main(void)
+{
+	test_ts_add();
+	test_deadline_next();
+	test_deadline_wait();
+
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Single-producer/single-consumer ring: capacity rounding, drop accounting,
+ * wrap-around, peek/consume, and a producer/consumer pair running
+ * concurrently.
+ */
+
+#include <stdint.h>
+
+#include "ingenialink/utils.h"
+#include "osal/osal.h"
+
+#include "test.h"
+
+/** Elements exchanged by the concurrent test. */
+#define XCHG_CNT	100000U
+
+/** Concurrent test ring capacity (elements). */
+#define XCHG_CAP	256
+
+static int producer_td(void *args)
+{
+	il_utils_ring_t *ring = args;
+	uint32_t next = 0, burst[7];
+	size_t i, n;
+
+	while (next < XCHG_CNT) {
+		n = 0;
+		for (i = 0; i < 7 && next + i < XCHG_CNT; i++)
+			burst[n++] = next + (uint32_t)i;
+
+		/* retry whatever did not fit, so that nothing is lost */
+		i = 0;
+		while (i < n) {
+			if (il_utils__ring_push(ring, &burst[i], 1) == 1)
+				i++;
+			else
+				osal_clock_sleep_ms(1);
+		}
+
+		next += (uint32_t)n;
+	}
+
+	return 0;
+}
+
+static void test_basic(void)
+{
+	il_utils_ring_t *ring;
+	uint32_t in[16], out[16];
+	void *view;
+	size_t i, n;
+
+	TEST_CHECK(il_utils__ring_create(0, 8) == NULL);
+	TEST_CHECK(il_utils__ring_create(sizeof(uint32_t), 0) == NULL);
+
+	/* capacity is rounded up to 8 */
+	ring = il_utils__ring_create(sizeof(uint32_t), 5);
+	TEST_CHECK(ring);
+
+	for (i = 0; i < 16; i++)
+		in[i] = (uint32_t)i;
+
+	TEST_CHECK(il_utils__ring_push(ring, in, 10) == 8);
+	TEST_CHECK(il_utils__ring_dropped(ring) == 2);
+	TEST_CHECK(il_utils__ring_cnt(ring) == 8);
+
+	TEST_CHECK(il_utils__ring_pop(ring, out, 5) == 5);
+	for (i = 0; i < 5; i++)
+		TEST_CHECK(out[i] == i);
+
+	/* wrap around: 3 left + 5 new */
+	TEST_CHECK(il_utils__ring_push(ring, &in[8], 5) == 5);
+	TEST_CHECK(il_utils__ring_cnt(ring) == 8);
+
+	/* the contiguous view stops at the end of the buffer */
+	n = il_utils__ring_peek(ring, &view);
+	TEST_CHECK(n == 3);
+	TEST_CHECK(((uint32_t *)view)[0] == 5);
+	il_utils__ring_consume(ring, n);
+
+	n = il_utils__ring_peek(ring, &view);
+	TEST_CHECK(n == 5);
+	for (i = 0; i < n; i++)
+		TEST_CHECK(((uint32_t *)view)[i] == 8 + i);
+	il_utils__ring_consume(ring, n);
+
+	TEST_CHECK(il_utils__ring_cnt(ring) == 0);
+	TEST_CHECK(il_utils__ring_pop(ring, out, 16) == 0);
+	TEST_CHECK(il_utils__ring_dropped(ring) == 2);
+
+	il_utils__ring_destroy(ring);
+}
+
+static void test_concurrent(void)
+{
+	il_utils_ring_t *ring;
+	osal_thread_t *td;
+	uint32_t expected = 0, out[XCHG_CAP];
+	size_t i, n;
+
+	ring = il_utils__ring_create(sizeof(uint32_t), XCHG_CAP);
+	TEST_CHECK(ring);
+
+	td = osal_thread_create_(producer_td, ring);
+	TEST_CHECK(td);
+
+	/* elements arrive complete and in order */
+	while (expected < XCHG_CNT) {
+		n = il_utils__ring_pop(ring, out, (expected & 1) ? 3 : XCHG_CAP);
+		if (n == 0) {
+			osal_clock_sleep_ms(1);
+			continue;
+		}
+
+		for (i = 0; i < n; i++)
+			TEST_CHECK(out[i] == expected++);
+	}
+
+	osal_thread_join(td, NULL);
+
+	TEST_CHECK(il_utils__ring_cnt(ring) == 0);
+
+	il_utils__ring_destroy(ring);
+}
+
+int main(void)
+{
+	test_basic();
+	test_concurrent();
+
+	return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * Connection manager timer wheel: tick rounding, expiration, cancellation,
+ * re-arming from callbacks and long sleeps that wrap the wheel. The wheel is
+ * driven by a fake clock, so results do not depend on scheduling.
+ */
+
+#include "../ingenialink/net_mgr.c"
+
+#include "test.h"
+
+/** Test timer. */
+typedef struct {
+	/** Timer. */
+	net_mgr_timer_t t;
+	/** Number of expirations. */
+	int fired;
+	/** Re-arm period (ms, 0 for one-shot). */
+	int period;
+	/** Timer to be cancelled on expiration (optional). */
+	net_mgr_timer_t *victim;
+} test_timer_t;
+
+/** Fake clock (ms). */
+static long long clock_ms;
+
+/*
+ * Stubs.
+ */
+
+int osal_clock_gettime(osal_timespec_t *ts)
+{
+	ts->s = (long)(clock_ms / 1000);
+	ts->ns = (long)(clock_ms % 1000) * OSAL_CLOCK_NANOSPERMSEC;
+
+	return 0;
+}
+
+int il_net__heartbeat_due(il_net_t *net)
+{
+	(void)net;
+
+	return 0;
+}
+
+int il_net__mgr_attach(il_net_t *net, int attach)
+{
+	(void)net;
+	(void)attach;
+
+	return 0;
+}
+
+int il_net__mgr_fd(il_net_t *net)
+{
+	(void)net;
+
+	return -1;
+}
+
+int il_net__probe_recv(il_net_t *net, uint8_t subnode, uint16_t *sw)
+{
+	(void)net;
+	(void)subnode;
+	(void)sw;
+
+	return IL_EFAIL;
+}
+
+int il_net__probe_send(il_net_t *net, uint8_t subnode)
+{
+	(void)net;
+	(void)subnode;
+
+	return IL_EFAIL;
+}
+
+void il_net__release(il_net_t *net)
+{
+	(void)net;
+}
+
+int il_net__reopen(il_net_t *net)
+{
+	(void)net;
+
+	return IL_EFAIL;
+}
+
+void il_net__retain(il_net_t *net)
+{
+	(void)net;
+}
+
+void il_net__state_set(il_net_t *net, il_net_state_t state)
+{
+	(void)net;
+	(void)state;
+}
+
+int il_net__sw_fresh(il_net_t *net, int age, uint16_t *sw)
+{
+	(void)net;
+	(void)age;
+	(void)sw;
+
+	return 0;
+}
+
+void il_net__sw_seen(il_net_t *net, uint8_t subnode, uint16_t sw)
+{
+	(void)net;
+	(void)subnode;
+	(void)sw;
+}
+
+il_net_state_t il_net_state_get(il_net_t *net)
+{
+	(void)net;
+
+	return IL_NET_STATE_DISCONNECTED;
+}
+
+void il_servo__release(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+void il_servo__retain(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+void il_servo_base__emcy_dispatch(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+int il_servo_base__monitors_start(il_servo_t *servo)
+{
+	(void)servo;
+
+	return 0;
+}
+
+void il_servo_base__monitors_stop(il_servo_t *servo)
+{
+	(void)servo;
+}
+
+void il_servo_base__sw_process(il_servo_t *servo, uint8_t subnode,
+			       uint16_t sw)
+{
+	(void)servo;
+	(void)subnode;
+	(void)sw;
+}
+
+/*
+ * Helpers.
+ */
+
+static void timer_expired(il_net_mgr_t *mgr, net_mgr_timer_t *t)
+{
+	test_timer_t *tt = container_of(t, test_timer_t, t);
+
+	tt->fired++;
+
+	if (tt->victim)
+		timer_cancel(mgr, tt->victim);
+
+	if (tt->period)
+		timer_arm(mgr, t, tt->period);
+}
+
+static void timer_init(test_timer_t *tt, int period)
+{
+	memset(tt, 0, sizeof(*tt));
+	tt->t.fire = timer_expired;
+	tt->period = period;
+}
+
+static void clock_advance(il_net_mgr_t *mgr, int ms)
+{
+	clock_ms += ms;
+	wheel_advance(mgr);
+}
+
+/*
+ * Tests.
+ */
+
+static void test_expire(il_net_mgr_t *mgr)
+{
+	test_timer_t a, b, c;
+
+	TEST_CHECK(wheel_timeout(mgr) == -1);
+
+	timer_init(&a, 0);
+	timer_init(&b, 0);
+	timer_init(&c, 0);
+
+	/* expirations round up to whole ticks, never below one tick */
+	timer_arm(mgr, &a.t, 12);
+	timer_arm(mgr, &b.t, 3);
+	timer_arm(mgr, &c.t, 0);
+	TEST_CHECK(mgr->armed == 3);
+	TEST_CHECK(wheel_timeout(mgr) == NET_MGR_TICK_MS);
+
+	clock_advance(mgr, NET_MGR_TICK_MS - 1);
+	TEST_CHECK(b.fired == 0 && c.fired == 0);
+	TEST_CHECK(wheel_timeout(mgr) == 1);
+
+	clock_advance(mgr, 1);
+	TEST_CHECK(a.fired == 0 && b.fired == 1 && c.fired == 1);
+	TEST_CHECK(mgr->armed == 1);
+	TEST_CHECK(wheel_timeout(mgr) == 2 * NET_MGR_TICK_MS);
+
+	clock_advance(mgr, 2 * NET_MGR_TICK_MS);
+	TEST_CHECK(a.fired == 1);
+	TEST_CHECK(mgr->armed == 0);
+	TEST_CHECK(wheel_timeout(mgr) == -1);
+}
+
+static void test_cancel(il_net_mgr_t *mgr)
+{
+	test_timer_t a, b;
+
+	timer_init(&a, 0);
+	timer_init(&b, 0);
+
+	timer_arm(mgr, &a.t, 20);
+	timer_arm(mgr, &b.t, 20);
+	timer_cancel(mgr, &a.t);
+	timer_cancel(mgr, &a.t);
+	TEST_CHECK(mgr->armed == 1);
+
+	/* re-arming moves the timer */
+	timer_arm(mgr, &b.t, 40);
+	TEST_CHECK(mgr->armed == 1);
+
+	clock_advance(mgr, 20);
+	TEST_CHECK(a.fired == 0 && b.fired == 0);
+
+	clock_advance(mgr, 20);
+	TEST_CHECK(a.fired == 0 && b.fired == 1);
+
+	/* callbacks may cancel timers that expired with them */
+	timer_init(&a, 0);
+	timer_init(&b, 0);
+	a.victim = &b.t;
+	b.victim = &a.t;
+
+	timer_arm(mgr, &a.t, 10);
+	timer_arm(mgr, &b.t, 10);
+	clock_advance(mgr, 10);
+	TEST_CHECK(a.fired + b.fired == 1);
+	TEST_CHECK(mgr->armed == 0);
+}
+
+static void test_periodic(il_net_mgr_t *mgr)
+{
+	test_timer_t p;
+	int i;
+
+	timer_init(&p, 10);
+	timer_arm(mgr, &p.t, p.period);
+
+	for (i = 0; i < 20; i++)
+		clock_advance(mgr, 5);
+
+	TEST_CHECK(p.fired == 10);
+
+	/* missed periods are coalesced */
+	clock_advance(mgr, 100);
+	TEST_CHECK(p.fired == 11);
+	TEST_CHECK(mgr->armed == 1);
+
+	timer_cancel(mgr, &p.t);
+}
+
+static void test_wrap(il_net_mgr_t *mgr)
+{
+	int turn = NET_MGR_WHEEL_SZ * NET_MGR_TICK_MS;
+	test_timer_t far, near;
+
+	timer_init(&far, 0);
+	timer_init(&near, 0);
+
+	/* beyond one turn: the slot is visited early, but must not fire */
+	timer_arm(mgr, &far.t, turn + turn / 2);
+	TEST_CHECK(wheel_timeout(mgr) > 0);
+
+	clock_advance(mgr, turn);
+	TEST_CHECK(far.fired == 0);
+
+	clock_advance(mgr, turn / 2 - NET_MGR_TICK_MS);
+	TEST_CHECK(far.fired == 0);
+
+	clock_advance(mgr, NET_MGR_TICK_MS);
+	TEST_CHECK(far.fired == 1);
+
+	/* a long sleep fires everything that expired meanwhile, once */
+	timer_arm(mgr, &near.t, 30);
+	timer_arm(mgr, &far.t, 3 * turn);
+	clock_advance(mgr, 10 * turn);
+	TEST_CHECK(near.fired == 1);
+	TEST_CHECK(far.fired == 2);
+	TEST_CHECK(mgr->armed == 0);
+}
+
+int main(void)
+{
+	static il_net_mgr_t mgr;
+
+	test_expire(&mgr);
+	test_cancel(&mgr);
+	test_periodic(&mgr);
+	test_wrap(&mgr);
+
+	return 0;
+}